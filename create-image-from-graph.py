@@ -12,6 +12,54 @@ import sys
 import timers
 
 MAX_SIZE_EXPLICIT = 15000
+CSR_GRAPH_MAGIC = b'SYMGRAPH'
+CSR_GRAPH_HEADER_SIZE = 32
+
+
+class CSRGraph(object):
+    """Memory-mapped view of a graph written by the planner with
+    dump_symmetry_graph=true and symmetry_graph_format=csr. Like a list of
+    successor lists, it supports len() and iterating over the successors
+    of all vertices."""
+    def __init__(self, input_file):
+        header = np.memmap(input_file, dtype=np.uint64, mode='r', shape=(4,))
+        num_vertices = int(header[2])
+        num_edges = int(header[3])
+        offset = CSR_GRAPH_HEADER_SIZE
+        self.offsets = np.memmap(input_file, dtype=np.uint64, mode='r', offset=offset, shape=(num_vertices + 1,))
+        offset += self.offsets.nbytes
+        self.colors = np.memmap(input_file, dtype=np.uint32, mode='r', offset=offset, shape=(num_vertices,))
+        offset += self.colors.nbytes
+        if num_edges:
+            self.targets = np.memmap(input_file, dtype=np.uint32, mode='r', offset=offset, shape=(num_edges,))
+        else:
+            self.targets = np.zeros(0, dtype=np.uint32)
+
+    def __len__(self):
+        return len(self.colors)
+
+    def __iter__(self):
+        for vertex in range(len(self)):
+            yield self.targets[self.offsets[vertex]:self.offsets[vertex + 1]].tolist()
+
+
+def is_csr_graph_file(input_file):
+    with open(input_file, 'rb') as f:
+        return f.read(len(CSR_GRAPH_MAGIC)) == CSR_GRAPH_MAGIC
+
+
+def read_text_graph(input_file):
+    adjacency_graph = []
+    with open(input_file) as f:
+        for line in f:
+            line = line.rstrip('\n')
+            line = line.rstrip(',')
+            if line == '':
+                successors = []
+            else:
+                successors = [int(succ) for succ in line.split(',')]
+            adjacency_graph.append(successors)
+    return adjacency_graph
 
 def create_raw_matrix_for_image(graph, bolded=False, shrink_ratio=6):
     """Create raw 0/1 matrix, bolding by adding 1s around existing ones """
@@ -177,7 +225,8 @@ if __name__ == "__main__":
     parser = argparse.ArgumentParser()
     parser.add_argument(
         "input_file", help="Absolute path to a file containing one line of "
-        "integers denoting successors as in an adjacency graph.")
+        "integers denoting successors as in an adjacency graph, or to a "
+        "binary CSR graph file (symmetry-graph.bin).")
     parser.add_argument(
         "image_output_directory", help="Absolute path where the image of the abstract "
         "structure graph should be stored.")
@@ -228,17 +277,10 @@ if __name__ == "__main__":
     else:
         print("Using image output directory {}".format(image_output_directory))
 
-    adjacency_graph = []
-    with open(input_file) as f:
-        for line in f:
-            line = line.rstrip('\n')
-            line = line.rstrip(',')
-            if line == '':
-                successors = []
-            else:
-                successors = [int(succ) for succ in line.split(',')]
-            adjacency_graph.append(successors)
-        # print adjacency_graph
+    if is_csr_graph_file(input_file):
+        adjacency_graph = CSRGraph(input_file)
+    else:
+        adjacency_graph = read_text_graph(input_file)
 
     if args.write_abstract_structure_image_raw:
         with timers.timing("Writing abstract structure graph raw image..", True):
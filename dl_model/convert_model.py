@@ -0,0 +1,173 @@
+#! /usr/bin/env python
+# -*- coding: utf-8 -*-
+
+"""Convert a Keras model (model.json and model.h5) into the flat binary
+format read by the native inference engine in src/cnn-selector.
+
+All values are little-endian. The file starts with the magic string
+"CNNMODEL", the format version, the input shape (height, width, channels)
+and the number of layers (all uint32). Each layer starts with its type
+(uint32) followed by its parameters (uint32) and weights (float32):
+
+  Conv2D:       filters, kernel height, kernel width, stride height,
+                stride width, input channels, activation,
+                kernel[kernel height][kernel width][input channels][filters],
+                bias[filters]
+  MaxPooling2D: pool height, pool width, stride height, stride width
+  Flatten:      -
+  Dense:        units, input size, activation,
+                kernel[units][input size], bias[units]
+
+Only "valid" padding and "channels_last" data format are supported.
+Dropout layers do nothing at inference time and are left out.
+"""
+
+import argparse
+import json
+import os
+import struct
+
+import h5py
+import numpy as np
+
+MAGIC = b"CNNMODEL"
+VERSION = 1
+NATIVE_MODEL_FILE_NAME = "model.bin"
+
+CONV2D = 1
+MAX_POOLING2D = 2
+FLATTEN = 3
+DENSE = 4
+
+ACTIVATIONS = {"linear": 0, "relu": 1, "sigmoid": 2, "softmax": 3}
+
+
+class ConversionError(Exception):
+    pass
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument(
+        "model_dir",
+        help="directory containing model.json and model.h5")
+    parser.add_argument(
+        "--output",
+        help="converted model file (default: MODEL_DIR/{})".format(
+            NATIVE_MODEL_FILE_NAME))
+    return parser.parse_args()
+
+
+def get_layer_configs(model_json):
+    config = model_json["config"]
+    # Keras < 2.2 stores the layers of a Sequential model directly.
+    if isinstance(config, dict):
+        config = config["layers"]
+    return config
+
+
+def get_weights(weights_group, layer_name):
+    """Return the weights of the layer in the order in which Keras
+    stores them (kernel, bias)."""
+    layer_group = weights_group[layer_name]
+    weight_names = layer_group.attrs["weight_names"]
+    return [np.array(layer_group[name], dtype="<f4") for name in weight_names]
+
+
+def pack_ints(*values):
+    return struct.pack("<{}I".format(len(values)), *values)
+
+
+def get_activation(config):
+    activation = config.get("activation", "linear")
+    if activation not in ACTIVATIONS:
+        raise ConversionError("unsupported activation: {}".format(activation))
+    return ACTIVATIONS[activation]
+
+
+def check_config(config):
+    if config.get("padding", "valid") != "valid":
+        raise ConversionError("only 'valid' padding is supported")
+    if config.get("data_format", "channels_last") != "channels_last":
+        raise ConversionError("only 'channels_last' data format is supported")
+    if tuple(config.get("dilation_rate", (1, 1))) != (1, 1):
+        raise ConversionError("dilated convolutions are not supported")
+
+
+def convert_layer(layer, weights_group):
+    class_name = layer["class_name"]
+    config = layer["config"]
+    check_config(config)
+    if class_name == "Conv2D":
+        weights = get_weights(weights_group, config["name"])
+        kernel = weights[0]
+        kernel_height, kernel_width, input_channels, filters = kernel.shape
+        if config["use_bias"]:
+            bias = weights[1]
+        else:
+            bias = np.zeros(filters, dtype="<f4")
+        stride_height, stride_width = config["strides"]
+        return [pack_ints(
+            CONV2D, filters, kernel_height, kernel_width, stride_height,
+            stride_width, input_channels, get_activation(config)),
+            kernel.tobytes(), bias.tobytes()]
+    elif class_name == "MaxPooling2D":
+        pool_height, pool_width = config["pool_size"]
+        stride_height, stride_width = config["strides"] or config["pool_size"]
+        return [pack_ints(
+            MAX_POOLING2D, pool_height, pool_width, stride_height, stride_width)]
+    elif class_name == "Flatten":
+        return [pack_ints(FLATTEN)]
+    elif class_name == "Dropout":
+        return []
+    elif class_name == "Dense":
+        weights = get_weights(weights_group, config["name"])
+        # Transpose the kernel, so that the weights of each unit are contiguous.
+        kernel = np.ascontiguousarray(weights[0].T)
+        units, input_size = kernel.shape
+        if config["use_bias"]:
+            bias = weights[1]
+        else:
+            bias = np.zeros(units, dtype="<f4")
+        return [pack_ints(DENSE, units, input_size, get_activation(config)),
+                kernel.tobytes(), bias.tobytes()]
+    else:
+        raise ConversionError("unsupported layer: {}".format(class_name))
+
+
+def convert_model(json_model, h5_model, output):
+    with open(json_model) as json_file:
+        model_json = json.load(json_file)
+    if model_json["class_name"] != "Sequential":
+        raise ConversionError("only Sequential models are supported")
+    layers = get_layer_configs(model_json)
+    _, height, width, channels = layers[0]["config"]["batch_input_shape"]
+
+    with h5py.File(h5_model, "r") as h5_file:
+        # Files written by model.save() store the weights in a subgroup.
+        weights_group = h5_file.get("model_weights", h5_file)
+        converted_layers = [
+            convert_layer(layer, weights_group) for layer in layers]
+    converted_layers = [layer for layer in converted_layers if layer]
+
+    with open(output, "wb") as output_file:
+        output_file.write(MAGIC)
+        output_file.write(pack_ints(
+            VERSION, height, width, channels, len(converted_layers)))
+        for layer in converted_layers:
+            for chunk in layer:
+                output_file.write(chunk)
+
+
+def main():
+    args = parse_args()
+    output = args.output or os.path.join(args.model_dir, NATIVE_MODEL_FILE_NAME)
+    convert_model(os.path.join(args.model_dir, "model.json"),
+                  os.path.join(args.model_dir, "model.h5"),
+                  output)
+    print("Wrote {}".format(output))
+
+
+if __name__ == "__main__":
+    main()
@@ -1,11 +1,9 @@
 #! /usr/bin/env python
 # -*- coding: utf-8 -*-
 
-from keras.models import model_from_json
-
-import numpy as np
 from PIL import Image
 import os
+import subprocess
 
 TRAINING_REVISION_V1 = '31d1eefdbeca'
 TRAINING_REVISION_V2 = '5652d59dafed'
@@ -36,13 +34,27 @@ ALGORITHMS_WITHOUT_H2_PREPROCESSOR = [
     '{}-simpless-oss-masb50kmiasmdfp'.format(TRAINING_REVISION_V1),
 ]
 
-def select_algorithm_from_model(json_model, h5_model, image):
+# Order of the outputs of the learned models.
+SOLVER_NAMES = ['{}-h2-simpless-dks-celmcut'.format(TRAINING_REVISION_V2), '{}-h2-simpless-dks-cpdbshc900'.format(TRAINING_REVISION_V2), '{}-h2-simpless-dks-900masb50ksccdfp'.format(TRAINING_REVISION_V2), '{}-h2-simpless-oss-900masb50ksbmiasm'.format(TRAINING_REVISION_V2), '{}-h2-simpless-dks-blind'.format(TRAINING_REVISION_V2), '{}-h2-simpless-oss-zopdbsgenetic'.format(TRAINING_REVISION_V2), '{}-h2-simpless-oss-blind'.format(TRAINING_REVISION_V2), '{}-h2-simpless-dks-900masb50ksbmiasm'.format(TRAINING_REVISION_V2), 'seq-opt-symba-1', '{}-h2-simpless-oss-masginfsccdfp'.format(TRAINING_REVISION_V2), '{}-h2-simpless-dks-900masginfsccdfp'.format(TRAINING_REVISION_V2), '{}-h2-simpless-oss-cpdbshc900'.format(TRAINING_REVISION_V2), '{}-h2-simpless-dks-zopdbsgenetic'.format(TRAINING_REVISION_V2), '{}-simpless-oss-masb50kmiasmdfp'.format(TRAINING_REVISION_V1), '{}-h2-simpless-oss-900masb50ksccdfp'.format(TRAINING_REVISION_V2), '{}-simpless-dks-masb50kmiasmdfp'.format(TRAINING_REVISION_V1), '{}-h2-simpless-oss-celmcut'.format(TRAINING_REVISION_V2)]
+
+
+def load_image_pixels(image):
+    img = Image.open(image)
+    assert img.mode == 'L', 'expected a grayscale image'
+    return img.tobytes()
+
+
+def predict_with_keras(json_model, h5_model, image):
     print("Using json model file {}".format(json_model))
     print("Using h5 model file {}".format(h5_model))
 
     # suppress unwanted output
     os.environ['TF_CPP_MIN_LOG_LEVEL'] = '3'
 
+    # Importing Keras takes several seconds, so we only do it when needed.
+    from keras.models import model_from_json
+    import numpy as np
+
     # load json and create model
     json_file = open(json_model, 'r')
     loaded_model_json = json_file.read()
@@ -52,26 +64,56 @@ def select_algorithm_from_model(json_model, h5_model, image):
     model.load_weights(h5_model)
     print("Loaded model from disk")
 
-    list_solver_names = ['{}-h2-simpless-dks-celmcut'.format(TRAINING_REVISION_V2), '{}-h2-simpless-dks-cpdbshc900'.format(TRAINING_REVISION_V2), '{}-h2-simpless-dks-900masb50ksccdfp'.format(TRAINING_REVISION_V2), '{}-h2-simpless-oss-900masb50ksbmiasm'.format(TRAINING_REVISION_V2), '{}-h2-simpless-dks-blind'.format(TRAINING_REVISION_V2), '{}-h2-simpless-oss-zopdbsgenetic'.format(TRAINING_REVISION_V2), '{}-h2-simpless-oss-blind'.format(TRAINING_REVISION_V2), '{}-h2-simpless-dks-900masb50ksbmiasm'.format(TRAINING_REVISION_V2), 'seq-opt-symba-1', '{}-h2-simpless-oss-masginfsccdfp'.format(TRAINING_REVISION_V2), '{}-h2-simpless-dks-900masginfsccdfp'.format(TRAINING_REVISION_V2), '{}-h2-simpless-oss-cpdbshc900'.format(TRAINING_REVISION_V2), '{}-h2-simpless-dks-zopdbsgenetic'.format(TRAINING_REVISION_V2), '{}-simpless-oss-masb50kmiasmdfp'.format(TRAINING_REVISION_V1), '{}-h2-simpless-oss-900masb50ksccdfp'.format(TRAINING_REVISION_V2), '{}-simpless-dks-masb50kmiasmdfp'.format(TRAINING_REVISION_V1), '{}-h2-simpless-oss-celmcut'.format(TRAINING_REVISION_V2)]
-
-    #print(str(len(list_solver_names)) + " Solvers: ")
-    #print(list_solver_names)
-
     list_x = []
 
     img = Image.open(image)
     list_x.append(np.array(img))
 
-    #print("\nNumber of total data points: " + str(len(list_x)))
     # Normalize feature image values to 0..1 range (assumes gray scale)
     data = np.array(list_x, dtype="float") / 255.0
     data  = data.reshape( data.shape[0], 128, 128, 1 )
 
     # For each test data point compute predictions for each of the solvers
     preds = model.predict(data)
-    #print(preds)
-    selected_algorithm = list_solver_names[np.argmax(preds[0])]
-    print("Chose %s" % selected_algorithm)
+    return list(preds[0])
+
+
+def predict_with_native_model(executable, native_model, image):
+    """Run the network with src/cnn-selector on a model converted by
+    dl_model/convert_model.py."""
+    print("Using native model file {}".format(native_model))
+    process = subprocess.Popen(
+        [executable, native_model], stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+    output, _ = process.communicate(load_image_pixels(image))
+    if process.returncode != 0:
+        raise RuntimeError("{} failed with exit code {}".format(
+            executable, process.returncode))
+    return [float(score) for score in output.split()]
+
 
-    assert selected_algorithm in ALGORITHM_TO_COMMAND_LINE_STRING
+def rank_algorithms_from_model(json_model, h5_model, image,
+                               native_executable=None, native_model=None):
+    """Return all algorithms, ordered from the best to the worst predicted
+    score. Use the native inference engine if it and the converted model
+    are available and fall back to Keras otherwise."""
+    if (native_executable and os.path.exists(native_executable) and
+            native_model and os.path.exists(native_model)):
+        preds = predict_with_native_model(native_executable, native_model, image)
+    else:
+        preds = predict_with_keras(json_model, h5_model, image)
+    assert len(preds) == len(SOLVER_NAMES)
+
+    # Sorting is stable, so ties are broken like with np.argmax.
+    ranking = sorted(range(len(preds)), key=lambda index: -preds[index])
+    ranked_algorithms = [SOLVER_NAMES[index] for index in ranking]
+    assert all(algorithm in ALGORITHM_TO_COMMAND_LINE_STRING
+               for algorithm in ranked_algorithms)
+    return ranked_algorithms
+
+
+def select_algorithm_from_model(json_model, h5_model, image,
+                                native_executable=None, native_model=None):
+    selected_algorithm = rank_algorithms_from_model(
+        json_model, h5_model, image, native_executable, native_model)[0]
+    print("Chose %s" % selected_algorithm)
     return selected_algorithm
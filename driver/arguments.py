@@ -313,6 +313,16 @@ def parse_args():
     driver_other.add_argument(
         "--transform-task",
         help='path to or name of external program that transforms output.sas (e.g. h2-mutexes)')
+    driver_other.add_argument(
+        "--task-cache", metavar="DIR",
+        help="reuse translated and transformed tasks stored in DIR, keyed by "
+            "a hash of the translator inputs and options, and store new ones there")
+    driver_other.add_argument(
+        "--segment-backing-store", metavar="DIR",
+        help="let the search allocate its state data from a memory-mapped "
+            "file in DIR, which does not count towards the search memory "
+            "limit, so that the operating system can page out rarely used "
+            "states instead of the search running out of memory")
     driver_other.add_argument(
         "--validate", action="store_true",
         help='validate plans (implied by --debug); needs "validate" (VAL) on PATH')
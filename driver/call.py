@@ -6,25 +6,61 @@ from __future__ import print_function
 
 from . import limits
 
+import os
+import signal
 import subprocess
 import sys
 
 
-def check_call(cmd, stdin=None, time_limit=None, memory_limit=None):
-    def set_limits():
+def _get_limit_kwargs(time_limit, memory_limit, new_process_group=False,
+                      allow_raising_memory_limit=False):
+    def prepare_child():
+        if new_process_group:
+            os.setsid()
         limits.set_time_limit(time_limit)
-        limits.set_memory_limit(memory_limit)
+        limits.set_memory_limit(memory_limit, allow_raising_memory_limit)
 
     kwargs = {}
-    if time_limit is not None or memory_limit is not None:
-        if limits.can_set_limits():
-            kwargs["preexec_fn"] = set_limits
-        else:
-            sys.exit(limits.RESOURCE_MODULE_MISSING_MSG)
+    has_limits = time_limit is not None or memory_limit is not None
+    if has_limits and not limits.can_set_limits():
+        sys.exit(limits.RESOURCE_MODULE_MISSING_MSG)
+    if has_limits or new_process_group:
+        kwargs["preexec_fn"] = prepare_child
+    return kwargs
 
+
+def check_call(cmd, stdin=None, time_limit=None, memory_limit=None,
+               allow_raising_memory_limit=False):
+    kwargs = _get_limit_kwargs(
+        time_limit, memory_limit,
+        allow_raising_memory_limit=allow_raising_memory_limit)
     sys.stdout.flush()
     if stdin:
         with open(stdin) as stdin_file:
             return subprocess.check_call(cmd, stdin=stdin_file, **kwargs)
     else:
         return subprocess.check_call(cmd, **kwargs)
+
+
+def start(cmd, cwd=None, stdout=None, time_limit=None, memory_limit=None,
+          allow_raising_memory_limit=False):
+    """Start *cmd* in a new process group and return without waiting
+    for it. The limits apply to each process of the group separately.
+    Use kill_process_group() to stop the command together with all
+    processes that it started."""
+    kwargs = _get_limit_kwargs(
+        time_limit, memory_limit, new_process_group=True,
+        allow_raising_memory_limit=allow_raising_memory_limit)
+    sys.stdout.flush()
+    return subprocess.Popen(
+        cmd, cwd=cwd, stdout=stdout, stderr=subprocess.STDOUT, **kwargs)
+
+
+def kill_process_group(process):
+    """Kill the process group of a process started with start()."""
+    try:
+        os.killpg(process.pid, signal.SIGKILL)
+    except OSError:
+        # The process group has already terminated.
+        pass
+    process.wait()
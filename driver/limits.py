@@ -62,12 +62,22 @@ def set_time_limit(time_limit):
     _set_limit(resource.RLIMIT_CPU, soft_limit, hard_limit)
 
 
-def set_memory_limit(memory):
-    """*memory* must be given in bytes or None."""
+def set_memory_limit(memory, allow_raising=False):
+    """*memory* must be given in bytes or None.
+
+    If *allow_raising* is true, only the soft limit is set and the hard
+    limit is left unchanged, so that the process can raise the limit
+    itself (the search does this for its segment backing store)."""
     if memory is None:
         return
     assert can_set_limits()
-    _set_limit(resource.RLIMIT_AS, memory)
+    if allow_raising:
+        _, hard_limit = resource.getrlimit(resource.RLIMIT_AS)
+        if hard_limit != resource.RLIM_INFINITY:
+            memory = min(memory, hard_limit)
+        _set_limit(resource.RLIMIT_AS, memory, hard_limit)
+    else:
+        _set_limit(resource.RLIMIT_AS, memory)
 
 
 def convert_to_mb(num_bytes):
@@ -152,6 +162,16 @@ def get_memory_limit(component_limit, overall_limit):
     limits = [limit for limit in limits if limit is not None]
     return min(limits) if limits else None
 
+def split_memory_limit(memory, num_processes):
+    """
+    Return the memory limit in bytes for each of *num_processes*
+    processes that run at the same time and share a budget of *memory*
+    bytes. The external limits apply to each process separately, so we
+    also respect them.
+    """
+    assert num_processes >= 1
+    return get_memory_limit(memory // num_processes, None)
+
 def get_time_limit(component_limit, overall_limit):
     """
     Return the minimum time limit imposed by any internal and external limit.
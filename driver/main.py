@@ -33,9 +33,7 @@ def main():
     for component in args.components:
         try:
             if component == "translate":
-                run_components.run_translate(args)
-                if args.transform_task:
-                    run_components.transform_task(args)
+                run_components.run_translate_and_transform(args)
             elif component == "search":
                 exitcode = run_components.run_search(args)
             elif component == "validate":
@@ -6,6 +6,7 @@ import itertools
 import os
 import os.path
 import re
+import shutil
 
 
 _PLAN_INFO_REGEX = re.compile(r"; cost = (\d+) \((unit cost|general cost)\)\n")
@@ -32,6 +33,13 @@ def _parse_plan(plan_filename):
         return None, None
 
 
+def is_complete_plan(plan_filename):
+    """Return True iff the plan file exists and ends with the cost line
+    that Fast Downward writes after the last action."""
+    return (os.path.exists(plan_filename) and
+            _parse_plan(plan_filename)[0] is not None)
+
+
 class PlanManager(object):
     def __init__(self, plan_prefix):
         self._plan_prefix = plan_prefix
@@ -103,6 +111,15 @@ class PlanManager(object):
             else:
                 break
 
+    def claim_plan(self, plan_filename):
+        """Make a plan found by one of several planners running in
+        parallel the plan of this manager. Only the first claimed plan is
+        kept. Return True iff *plan_filename* became the plan."""
+        if os.path.exists(self._plan_prefix):
+            return False
+        shutil.move(plan_filename, self._plan_prefix)
+        return True
+
     def delete_existing_plans(self):
         """Delete all plans that match the given plan prefix."""
         for plan in self.get_existing_plans():
@@ -68,15 +68,19 @@ def adapt_args(args, search_cost_type, heuristic_cost_type, plan_manager):
             break
 
 
-def run_search(executable, args, sas_file, plan_manager, time, memory):
+def run_search(executable, args, sas_file, plan_manager, time, memory,
+               segment_backing_store):
     complete_args = [executable] + args + [
         "--internal-plan-file", plan_manager.get_plan_prefix()]
+    if segment_backing_store:
+        complete_args.extend(["--segment-backing-store", segment_backing_store])
     print("args: %s" % complete_args)
 
     try:
         exitcode = call.check_call(
             complete_args, stdin=sas_file,
-            time_limit=time, memory_limit=memory)
+            time_limit=time, memory_limit=memory,
+            allow_raising_memory_limit=bool(segment_backing_store))
     except subprocess.CalledProcessError as err:
         exitcode = err.returncode
     print("exitcode: %d" % exitcode)
@@ -97,7 +101,8 @@ def compute_run_time(timeout, configs, pos):
 
 
 def run_sat_config(configs, pos, search_cost_type, heuristic_cost_type,
-                   executable, sas_file, plan_manager, timeout, memory):
+                   executable, sas_file, plan_manager, timeout, memory,
+                   segment_backing_store):
     run_time = compute_run_time(timeout, configs, pos)
     if run_time <= 0:
         return None
@@ -106,13 +111,14 @@ def run_sat_config(configs, pos, search_cost_type, heuristic_cost_type,
     adapt_args(args, search_cost_type, heuristic_cost_type, plan_manager)
     args.extend([
         "--internal-previous-portfolio-plans", str(plan_manager.get_plan_counter())])
-    result = run_search(executable, args, sas_file, plan_manager, run_time, memory)
+    result = run_search(executable, args, sas_file, plan_manager, run_time,
+                        memory, segment_backing_store)
     plan_manager.process_new_plans()
     return result
 
 
 def run_sat(configs, executable, sas_file, plan_manager, final_config,
-            final_config_builder, timeout, memory):
+            final_config_builder, timeout, memory, segment_backing_store):
     # If the configuration contains S_COST_TYPE or H_COST_TRANSFORM and the task
     # has non-unit costs, we start by treating all costs as one. When we find
     # a solution, we rerun the successful config with real costs.
@@ -124,7 +130,8 @@ def run_sat(configs, executable, sas_file, plan_manager, final_config,
         for pos, (relative_time, args) in enumerate(configs):
             exitcode = run_sat_config(
                 configs, pos, search_cost_type, heuristic_cost_type,
-                executable, sas_file, plan_manager, timeout, memory)
+                executable, sas_file, plan_manager, timeout, memory,
+                segment_backing_store)
             if exitcode is None:
                 return
 
@@ -142,7 +149,8 @@ def run_sat(configs, executable, sas_file, plan_manager, final_config,
                     heuristic_cost_type = "plusone"
                     exitcode = run_sat_config(
                         configs, pos, search_cost_type, heuristic_cost_type,
-                        executable, sas_file, plan_manager, timeout, memory)
+                        executable, sas_file, plan_manager, timeout, memory,
+                        segment_backing_store)
                     if exitcode is None:
                         return
 
@@ -165,16 +173,17 @@ def run_sat(configs, executable, sas_file, plan_manager, final_config,
         exitcode = run_sat_config(
             [(1, final_config)], 0, search_cost_type,
             heuristic_cost_type, executable, sas_file, plan_manager,
-            timeout, memory)
+            timeout, memory, segment_backing_store)
         if exitcode is not None:
             yield exitcode
 
 
-def run_opt(configs, executable, sas_file, plan_manager, timeout, memory):
+def run_opt(configs, executable, sas_file, plan_manager, timeout, memory,
+            segment_backing_store):
     for pos, (relative_time, args) in enumerate(configs):
         run_time = compute_run_time(timeout, configs, pos)
         exitcode = run_search(executable, args, sas_file, plan_manager,
-                              run_time, memory)
+                              run_time, memory, segment_backing_store)
         yield exitcode
 
         if exitcode in [returncodes.EXIT_PLAN_FOUND, returncodes.EXIT_UNSOLVABLE]:
@@ -204,12 +213,14 @@ def get_portfolio_attributes(portfolio):
     return attributes
 
 
-def run(portfolio, executable, sas_file, plan_manager, time, memory):
+def run(portfolio, executable, sas_file, plan_manager, time, memory,
+        segment_backing_store=None):
     """
     Run the configs in the given portfolio file.
 
     The portfolio is allowed to run for at most *time* seconds and may
-    use a maximum of *memory* bytes.
+    use a maximum of *memory* bytes. If *segment_backing_store* is given,
+    it is passed on to each search (see --segment-backing-store).
     """
     attributes = get_portfolio_attributes(portfolio)
     configs = attributes["CONFIGS"]
@@ -233,11 +244,12 @@ def run(portfolio, executable, sas_file, plan_manager, time, memory):
 
     if optimal:
         exitcodes = run_opt(
-            configs, executable, sas_file, plan_manager, timeout, memory)
+            configs, executable, sas_file, plan_manager, timeout, memory,
+            segment_backing_store)
     else:
         exitcodes = run_sat(
             configs, executable, sas_file, plan_manager, final_config,
-            final_config_builder, timeout, memory)
+            final_config_builder, timeout, memory, segment_backing_store)
     exitcode = returncodes.generate_portfolio_exitcode(exitcodes)
     if exitcode != 0:
         raise subprocess.CalledProcessError(exitcode, ["run-portfolio", portfolio])
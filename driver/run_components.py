@@ -10,6 +10,7 @@ from . import call
 from . import limits
 from . import portfolio_runner
 from . import returncodes
+from . import task_cache
 from . import util
 from .plan_manager import PlanManager
 
@@ -70,7 +71,8 @@ def print_callstring(executable, options, stdin):
 
 
 def call_component(executable, options, stdin=None,
-                   time_limit=None, memory_limit=None):
+                   time_limit=None, memory_limit=None,
+                   allow_raising_memory_limit=False):
     if executable.endswith(".py"):
         options.insert(0, executable)
         executable = sys.executable
@@ -78,7 +80,8 @@ def call_component(executable, options, stdin=None,
     print_callstring(executable, options, stdin)
     call.check_call(
         [executable] + options,
-        stdin=stdin, time_limit=time_limit, memory_limit=memory_limit)
+        stdin=stdin, time_limit=time_limit, memory_limit=memory_limit,
+        allow_raising_memory_limit=allow_raising_memory_limit)
 
 
 def run_translate(args):
@@ -109,6 +112,26 @@ def transform_task(args):
                 args.transform_task))
 
 
+def run_translate_and_transform(args):
+    """Run the translator and the task transformation (if any), reusing
+    their results from the task cache if one is given."""
+    cache = None
+    if args.task_cache:
+        cache = task_cache.TaskCache(
+            args.task_cache, get_executable(args.build, REL_TRANSLATE_PATH),
+            args.translate_inputs, args.translate_options)
+        if cache.restore(args.transform_task):
+            return
+    if cache is None or not cache.restore():
+        run_translate(args)
+        if cache is not None:
+            cache.store()
+    if args.transform_task:
+        transform_task(args)
+        if cache is not None:
+            cache.store(args.transform_task)
+
+
 def run_search(args):
     logging.info("Running search (%s)." % args.build)
     time_limit = limits.get_time_limit(
@@ -130,18 +153,22 @@ def run_search(args):
         logging.info("search portfolio: %s" % args.portfolio)
         portfolio_runner.run(
             args.portfolio, search, args.search_input, plan_manager,
-            time_limit, memory_limit)
+            time_limit, memory_limit, args.segment_backing_store)
     else:
         if not args.search_options:
             raise ValueError(
                 "search needs --alias, --portfolio, or search options")
         if "--help" not in args.search_options:
             args.search_options.extend(["--internal-plan-file", args.plan_file])
+            if args.segment_backing_store:
+                args.search_options.extend(
+                    ["--segment-backing-store", args.segment_backing_store])
         try:
             call_component(
                 search, args.search_options,
                 stdin=args.search_input,
-                time_limit=time_limit, memory_limit=memory_limit)
+                time_limit=time_limit, memory_limit=memory_limit,
+                allow_raising_memory_limit=bool(args.segment_backing_store))
         except subprocess.CalledProcessError as err:
             if err.returncode in returncodes.EXPECTED_EXITCODES:
                 return err.returncode
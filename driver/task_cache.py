@@ -0,0 +1,95 @@
+# -*- coding: utf-8 -*-
+
+"""Content-addressed cache for translated (and transformed) tasks.
+
+Each task is stored in a subdirectory of the cache directory named after
+a hash of the translator sources, inputs and options. It holds the
+translator output and, for every task transformation that has been run
+on it, the transformed task.
+"""
+
+import hashlib
+import logging
+import os
+import shutil
+import tempfile
+
+TASK_FILE = "output.sas"
+
+
+def _hash_file(hasher, filename):
+    with open(filename, "rb") as input_file:
+        for chunk in iter(lambda: input_file.read(1 << 20), b""):
+            hasher.update(chunk)
+    # Separate the files so that moving text between them changes the key.
+    hasher.update(b"\0")
+
+
+def _get_translator_sources(translator):
+    """Return the Python files of the translator in a fixed order."""
+    translator_dir = os.path.dirname(os.path.abspath(translator))
+    sources = []
+    for dirpath, dirnames, filenames in os.walk(translator_dir):
+        dirnames.sort()
+        for filename in sorted(filenames):
+            if filename.endswith(".py"):
+                sources.append(os.path.join(dirpath, filename))
+    return sources
+
+
+def compute_key(translator, translate_inputs, translate_options):
+    hasher = hashlib.sha1()
+    # Include the translator itself, so that changing it invalidates the
+    # cached tasks.
+    for filename in _get_translator_sources(translator):
+        hasher.update(os.path.relpath(
+            filename, os.path.dirname(translator)).encode("utf-8"))
+        _hash_file(hasher, filename)
+    for filename in translate_inputs:
+        _hash_file(hasher, filename)
+    hasher.update(" ".join(translate_options).encode("utf-8"))
+    return hasher.hexdigest()
+
+
+class TaskCache(object):
+    def __init__(self, cache_dir, translator, translate_inputs,
+                 translate_options):
+        self.directory = os.path.join(
+            cache_dir,
+            compute_key(translator, translate_inputs, translate_options))
+
+    def get_path(self, transform=None):
+        if transform is None:
+            return os.path.join(self.directory, TASK_FILE)
+        return os.path.join(
+            self.directory, "{}.{}".format(os.path.basename(transform), TASK_FILE))
+
+    def restore(self, transform=None):
+        """Copy the cached task to the working directory. Return False
+        if the task is not cached."""
+        path = self.get_path(transform)
+        if not os.path.exists(path):
+            return False
+        logging.info("Using cached task {}".format(path))
+        # We copy instead of linking because transformations overwrite
+        # output.sas in place.
+        shutil.copyfile(path, TASK_FILE)
+        return True
+
+    def store(self, transform=None):
+        """Add output.sas from the working directory to the cache."""
+        if not os.path.isdir(self.directory):
+            try:
+                os.makedirs(self.directory)
+            except OSError:
+                # Another planner process may have created it concurrently.
+                if not os.path.isdir(self.directory):
+                    raise
+        path = self.get_path(transform)
+        # Write to a temporary file first, so that concurrent readers never
+        # see a partially written task.
+        fd, tmp_path = tempfile.mkstemp(dir=self.directory)
+        os.close(fd)
+        shutil.copyfile(TASK_FILE, tmp_path)
+        os.rename(tmp_path, path)
+        logging.info("Stored task in cache {}".format(path))
@@ -0,0 +1,71 @@
+#! /usr/bin/env python
+# -*- coding: utf-8 -*-
+
+import os
+
+from lab.environments import LocalEnvironment, BaselSlurmEnvironment
+
+import common_setup
+from common_setup import IssueConfig, IssueExperiment
+from relativescatter import RelativeScatterPlotReport
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+BENCHMARKS_DIR = os.environ["DOWNWARD_BENCHMARKS"]
+# astar() uses bucket open lists for heuristics on tasks with small action
+# costs in v1 and tie-breaking open lists in base.
+REVISIONS = ["bucket-open-list-base", "bucket-open-list-v1"]
+BUILD_OPTIONS = ["release64"]
+DRIVER_OPTIONS = ["--build", "release64", "--search-time-limit", "5m"]
+ASTAR_HEURISTICS = [
+    ("blind", "blind()"),
+    ("pdb", "pdb()"),
+    ("lmcut", "lmcut()"),
+]
+CONFIGS = [
+    IssueConfig(
+        "astar-{}".format(nick),
+        ["--search", "astar({})".format(heuristic)],
+        build_options=BUILD_OPTIONS,
+        driver_options=DRIVER_OPTIONS)
+    for nick, heuristic in ASTAR_HEURISTICS
+]
+SUITE = common_setup.DEFAULT_OPTIMAL_SUITE
+ENVIRONMENT = BaselSlurmEnvironment(
+    export=["PATH", "DOWNWARD_BENCHMARKS"])
+
+if common_setup.is_test_run():
+    SUITE = IssueExperiment.DEFAULT_TEST_SUITE
+    ENVIRONMENT = LocalEnvironment(processes=1)
+
+
+def add_expansion_rate(run):
+    expansions = run.get("expansions")
+    search_time = run.get("search_time")
+    if expansions is not None and search_time:
+        run["expansions_per_second"] = expansions / search_time
+    return run
+
+
+exp = IssueExperiment(
+    revisions=REVISIONS,
+    configs=CONFIGS,
+    environment=ENVIRONMENT,
+)
+exp.add_suite(BENCHMARKS_DIR, SUITE)
+
+attributes = IssueExperiment.DEFAULT_TABLE_ATTRIBUTES + ["expansions_per_second"]
+exp.add_absolute_report_step(attributes=attributes, filter=add_expansion_rate)
+exp.add_comparison_table_step(attributes=attributes, filter=add_expansion_rate)
+
+for attribute in ["search_time", "memory"]:
+    for config in CONFIGS:
+        exp.add_report(
+            RelativeScatterPlotReport(
+                attributes=[attribute],
+                filter_algorithm=["{}-{}".format(rev, config.nick) for rev in REVISIONS],
+                get_category=lambda run1, run2: run1.get("domain"),
+            ),
+            outfile="{}-{}-{}-{}-{}.png".format(exp.name, attribute, config.nick, *REVISIONS)
+        )
+
+exp.run_steps()
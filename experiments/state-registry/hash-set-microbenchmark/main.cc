@@ -0,0 +1,212 @@
+/*
+  Compare the hash sets that StateRegistry can use to detect duplicate
+  states: std::unordered_set (the old implementation) and IntHashSet.
+
+  We mimic StateRegistry::insert_id_or_pop_state: each generated state is
+  appended to a SegmentedArrayVector and its index is inserted into the
+  set. If the state is a duplicate, it is popped again. States are drawn
+  pseudo-randomly from a fixed number of distinct states, so that about
+  half of the insertions are duplicates, as in a typical search.
+
+  Each variant runs in its own child process, so that we can measure its
+  peak memory usage. Time and bytes per state are measured relative to a
+  run that only fills the state data pool, so they only cover the set.
+
+  Usage: ./benchmark [NUM_DISTINCT_STATES [BINS_PER_STATE]]
+*/
+
+#include "algorithms/int_hash_set.h"
+#include "algorithms/segmented_vector.h"
+#include "utils/hash.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+using PackedStateBin = unsigned int;
+using StatePool = segmented_vector::SegmentedArrayVector<PackedStateBin>;
+
+struct SemanticHash {
+    const StatePool &pool;
+    int bins_per_state;
+
+    SemanticHash(const StatePool &pool, int bins_per_state)
+        : pool(pool), bins_per_state(bins_per_state) {
+    }
+
+    size_t operator()(int id) const {
+        const PackedStateBin *data = pool[id];
+        utils::HashState hash_state;
+        for (int i = 0; i < bins_per_state; ++i) {
+            hash_state.feed(data[i]);
+        }
+        return hash_state.get_hash64();
+    }
+};
+
+struct SemanticEqual {
+    const StatePool &pool;
+    int bins_per_state;
+
+    SemanticEqual(const StatePool &pool, int bins_per_state)
+        : pool(pool), bins_per_state(bins_per_state) {
+    }
+
+    bool operator()(int lhs, int rhs) const {
+        const PackedStateBin *lhs_data = pool[lhs];
+        const PackedStateBin *rhs_data = pool[rhs];
+        return equal(lhs_data, lhs_data + bins_per_state, rhs_data);
+    }
+};
+
+using UnorderedSet = unordered_set<int, SemanticHash, SemanticEqual>;
+using FlatSet = int_hash_set::IntHashSet<SemanticHash, SemanticEqual>;
+
+// Insert the last state of the pool or pop it if it is a duplicate.
+static void insert_or_pop(UnorderedSet &set, StatePool &pool) {
+    if (!set.insert(pool.size() - 1).second)
+        pool.pop_back();
+}
+
+static void insert_or_pop(FlatSet &set, StatePool &pool) {
+    if (!set.insert(pool.size() - 1).second)
+        pool.pop_back();
+}
+
+static long get_peak_memory_in_kb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/*
+  Generate 2 * num_distinct_states states, drawn from num_distinct_states
+  distinct ones, and call register_state after adding each to the pool.
+*/
+static void generate_states(
+    StatePool &pool, int bins_per_state, int num_distinct_states,
+    const function<void()> &register_state) {
+    PackedStateBin *buffer = new PackedStateBin[bins_per_state];
+    uint64_t rng_state = 2018;
+    for (int64_t i = 0; i < 2 * static_cast<int64_t>(num_distinct_states); ++i) {
+        // xorshift64* to pick one of the distinct states.
+        rng_state ^= rng_state >> 12;
+        rng_state ^= rng_state << 25;
+        rng_state ^= rng_state >> 27;
+        uint64_t state_index =
+            (rng_state * 2685821657736338717ULL) % num_distinct_states;
+        for (int bin = 0; bin < bins_per_state; ++bin) {
+            // Most bins are equal in all states, like in real tasks.
+            buffer[bin] = (bin == 0) ? state_index : 42;
+        }
+        pool.push_back(buffer);
+        register_state();
+    }
+    delete[] buffer;
+}
+
+struct Result {
+    double seconds;
+    long peak_memory_in_kb;
+    size_t num_states;
+};
+
+static Result run_variant(const string &variant, int num_distinct_states,
+                          int bins_per_state) {
+    long memory_before = get_peak_memory_in_kb();
+    StatePool pool(bins_per_state);
+    SemanticHash hasher(pool, bins_per_state);
+    SemanticEqual equal(pool, bins_per_state);
+    UnorderedSet unordered_set(0, hasher, equal);
+    FlatSet flat_set(hasher, equal);
+    vector<bool> seen;
+    if (variant == "pool only")
+        seen.resize(num_distinct_states, false);
+
+    function<void()> register_state;
+    if (variant == "unordered_set") {
+        register_state = [&]() {insert_or_pop(unordered_set, pool); };
+    } else if (variant == "IntHashSet") {
+        register_state = [&]() {insert_or_pop(flat_set, pool); };
+    } else {
+        // Only keep distinct states, using the knowledge how they are generated.
+        register_state = [&]() {
+            PackedStateBin state_index = pool[pool.size() - 1][0];
+            if (seen[state_index])
+                pool.pop_back();
+            seen[state_index] = true;
+        };
+    }
+
+    clock_t start = clock();
+    generate_states(pool, bins_per_state, num_distinct_states, register_state);
+    Result result;
+    result.seconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+    result.peak_memory_in_kb = get_peak_memory_in_kb() - memory_before;
+    result.num_states = pool.size();
+    return result;
+}
+
+// Run the variant in a child process to measure its peak memory in isolation.
+static Result run_variant_in_child(const string &variant, int num_distinct_states,
+                                   int bins_per_state) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("pipe");
+        exit(1);
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        Result result = run_variant(variant, num_distinct_states, bins_per_state);
+        if (write(fds[1], &result, sizeof(result)) != sizeof(result))
+            _exit(1);
+        _exit(0);
+    }
+    close(fds[1]);
+    Result result;
+    if (read(fds[0], &result, sizeof(result)) != sizeof(result)) {
+        cerr << "benchmark " << variant << " failed" << endl;
+        exit(1);
+    }
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return result;
+}
+
+int main(int argc, char **argv) {
+    int num_distinct_states = (argc > 1) ? atoi(argv[1]) : 10000000;
+    int bins_per_state = (argc > 2) ? atoi(argv[2]) : 4;
+    int64_t num_insertions = 2 * static_cast<int64_t>(num_distinct_states);
+    cout << "Inserting " << num_insertions << " states with "
+         << bins_per_state << " bins, " << num_distinct_states
+         << " of them distinct" << endl;
+
+    Result pool_only = run_variant_in_child(
+        "pool only", num_distinct_states, bins_per_state);
+    for (const string variant : {"unordered_set", "IntHashSet"}) {
+        Result result = run_variant_in_child(
+            variant, num_distinct_states, bins_per_state);
+        long set_memory_in_kb = result.peak_memory_in_kb - pool_only.peak_memory_in_kb;
+        cout << variant << ": "
+             << result.seconds - pool_only.seconds << " seconds, "
+             << static_cast<int64_t>(
+                    num_insertions / (result.seconds - pool_only.seconds))
+             << " states/second, "
+             << 1024.0 * set_memory_in_kb / result.num_states << " bytes/state, "
+             << result.num_states << " distinct states" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+#! /usr/bin/env python
+
+from __future__ import print_function
+
+import os
+import re
+import subprocess
+import sys
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO_BASE = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO_BASE, "misc", "tests", "benchmarks")
+DRIVER = os.path.join(REPO_BASE, "fast-downward.py")
+
+TASKS = [
+    "gripper/prob01.pddl",
+    "miconic/s1-0.pddl",
+]
+
+# Each external configuration has to find a plan with the same cost as
+# the in-memory A* configuration with the same heuristic.
+CONFIGS = [
+    ("astar(blind())", [
+        "external_astar(blind())",
+        # Few states per buffer force many sorted runs per bucket.
+        "external_astar(blind(), buffer_size=10)",
+        "external_astar(blind(), locality=infinity)",
+        "external_astar(blind(), symmetries=structural_symmetries("
+            "search_symmetries=oss))",
+        "external_astar(blind(), symmetries=structural_symmetries("
+            "search_symmetries=dks))",
+    ]),
+    ("astar(lmcut())", [
+        "external_astar(lmcut())",
+        "external_astar(lmcut(), buffer_size=10)",
+    ]),
+]
+
+PLAN_COST_REGEX = re.compile(r"^Plan cost: (\d+)$", re.M)
+
+
+def get_plan_cost(relpath, search):
+    problem = os.path.join(BENCHMARKS_DIR, relpath)
+    print("\nRun %(search)s on %(relpath)s:" % locals())
+    sys.stdout.flush()
+    try:
+        output = subprocess.check_output(
+            [sys.executable, DRIVER, problem, "--search", search],
+            universal_newlines=True)
+    except subprocess.CalledProcessError as err:
+        print(err.output)
+        return None
+    match = PLAN_COST_REGEX.search(output)
+    if not match:
+        return None
+    cost = int(match.group(1))
+    print("Plan cost: %d" % cost)
+    return cost
+
+
+def cleanup():
+    subprocess.check_call([sys.executable, DRIVER, "--cleanup"])
+
+
+def main():
+    # On Windows, ./build.py has to be called from the correct environment.
+    # Since we want this script to work even when we are in a regular
+    # shell, we do not build on Windows. If the planner is not yet built,
+    # the driver script will complain about this.
+    if os.name == "posix":
+        subprocess.check_call(["./build.py"], cwd=REPO_BASE)
+    failures = []
+    for relpath in TASKS:
+        for reference, searches in CONFIGS:
+            expected = get_plan_cost(relpath, reference)
+            cleanup()
+            if expected is None:
+                failures.append((relpath, reference, None, None))
+                continue
+            for search in searches:
+                cost = get_plan_cost(relpath, search)
+                if cost != expected:
+                    failures.append((relpath, search, expected, cost))
+                cleanup()
+
+    if failures:
+        print("\nFailures:")
+        for relpath, search, expected, cost in failures:
+            print("%(search)s on %(relpath)s: expected plan cost "
+                  "%(expected)s, got %(cost)s" % locals())
+        sys.exit(1)
+    else:
+        print("\nNo errors detected.")
+
+
+main()
@@ -4,6 +4,7 @@
 import argparse
 import os
 import sys
+import time
 
 if (sys.version_info > (3, 0)):
     import subprocess
@@ -11,10 +12,24 @@ else:
     import subprocess32 as subprocess
 
 from dl_model import selector
+from driver import call
+from driver import limits
+from driver import plan_manager
 
 FALLBACK_COMMAND_LINE_OPTIONS = ['--symmetries', 'sym=structural_symmetries(search_symmetries=dks)', '--search', 'astar(celmcut,symmetries=sym,pruning=stubborn_sets_simple(minimum_pruning_ratio=0.01),num_por_probes=1000)']
 GRAPH_CREATION_TIME_LIMIT = 60 # seconds
 IMAGE_CREATION_TIME_LIMIT = 180 # seconds
+IMAGE_FILE_NAME = 'graph-gs-L-bolded-cs.png'
+# Bliss runs in the graph phase to save the generators for the selected
+# planners. Its time bound leaves time for creating the graph.
+GENERATORS_FILE_NAME = 'symmetry-generators.bin'
+GENERATORS_TIME_LIMIT = 30 # seconds
+# Translated and h2-preprocessed tasks are shared between all planner calls.
+TASK_CACHE_DIR_NAME = 'task-cache'
+# Memory limit of the selected planner. Planners running in parallel share it.
+DEFAULT_MEMORY_LIMIT = '7600M'
+# Seconds between checks whether one of the parallel planners finished.
+PARALLEL_POLL_INTERVAL = 0.1
 
 def get_script():
     """Get file name of main script."""
@@ -31,6 +46,12 @@ def get_base_dir():
     """Assume that this script always lives in the base dir of the infrastructure."""
     return os.path.abspath(get_script_dir())
 
+def get_task_cache_dir():
+    return os.path.join(os.getcwd(), TASK_CACHE_DIR_NAME)
+
+def get_generators_file():
+    return os.path.join(os.getcwd(), GENERATORS_FILE_NAME)
+
 def print_highlighted_line(string, block=True):
     if block:
         print
@@ -39,13 +60,20 @@ def print_highlighted_line(string, block=True):
         print
 
 
-def compute_graph_for_task(base_dir, pwd, domain, problem, image_from_lifted_task):
+def compute_graph_for_task(base_dir, pwd, domain, problem, image_from_lifted_task, graph_from_preprocessed_task):
     if image_from_lifted_task:
         command = [sys.executable, os.path.join(base_dir, 'src/translate/abstract_structure_module.py'), '--only-functions-from-initial-state', domain, problem]
         graph_file = os.path.join(pwd, 'abstract-structure-graph.txt')
     else:
-        command = [sys.executable, os.path.join(base_dir, 'fast-downward.py'), '--build', 'release64', domain, problem, '--symmetries','sym=structural_symmetries(time_bound=0,search_symmetries=oss,dump_symmetry_graph=true,stop_after_symmetry_graph_creation=true)', '--search', 'astar(blind(),symmetries=sym)']
-        graph_file = os.path.join(pwd, 'symmetry-graph.txt')
+        # The planner directly writes the image of the symmetry graph.
+        command = [sys.executable, os.path.join(base_dir, 'fast-downward.py'), '--task-cache', get_task_cache_dir()]
+        if graph_from_preprocessed_task:
+            command.extend(['--transform-task', 'preprocess'])
+        # Planners searching a different task than the graph was computed
+        # from (e.g., with or without the h2 preprocessor) ignore the
+        # saved generators and compute their own.
+        command.extend(['--build', 'release64', domain, problem, '--symmetries','sym=structural_symmetries(time_bound={},search_symmetries=oss,write_symmetry_graph_image=true,stop_after_symmetry_graph_creation=true,save_generators={})'.format(GENERATORS_TIME_LIMIT, get_generators_file()), '--search', 'astar(blind(),symmetries=sym)'])
+        graph_file = os.path.join(pwd, IMAGE_FILE_NAME)
     try:
         subprocess.check_call(command, timeout=GRAPH_CREATION_TIME_LIMIT)
     except subprocess.TimeoutExpired:
@@ -65,28 +93,34 @@ def compute_graph_for_task(base_dir, pwd, domain, problem, image_from_lifted_tas
     return graph_file
 
 
-def select_planner_from_model(base_dir, pwd, graph_file, image_from_lifted_task):
+def create_image_from_graph(base_dir, pwd, graph_file):
     try:
         # Create an image from the abstract structure for the given domain and problem.
         subprocess.check_call([sys.executable, os.path.join(base_dir, 'create-image-from-graph.py'), '--write-abstract-structure-image-reg', '--bolding-abstract-structure-image', '--abstract-structure-image-target-size', '128', graph_file, pwd], timeout=IMAGE_CREATION_TIME_LIMIT)
     except subprocess.TimeoutExpired:
         sys.stdout.flush()
         print("Image computation reached the time limit!")
-        return None
+        return False
     except subprocess.CalledProcessError as err:
         sys.stdout.flush()
         print("Image computation returned nonzero exitcode {}".format(err.returncode))
-        return None
+        return False
     except:
         # We catch all exceptions (this unfortunately includes signals) to make
         # sure that if we cannot automatically select a planner, we still run
         # our fallback planner.
-        return None
+        return False
         #raise
+    return True
+
+
+def select_planners_from_model(base_dir, pwd, graph_file, image_from_lifted_task, num_planners):
+    """Return the *num_planners* planners with the best predicted scores."""
+    # For the grounded task, the planner already wrote the image.
+    if image_from_lifted_task and not create_image_from_graph(base_dir, pwd, graph_file):
+        return None
 
-    # TODO: we should be able to not hard-code the file name
-    image_file_name = 'graph-gs-L-bolded-cs.png'
-    image_path = os.path.join(pwd, image_file_name)
+    image_path = os.path.join(pwd, IMAGE_FILE_NAME)
     assert os.path.exists(image_path)
     # Use the learned model to select the appropriate planner (its command line options)
     if image_from_lifted_task:
@@ -95,40 +129,120 @@ def select_planner_from_model(base_dir, pwd, graph_file, image_from_lifted_task)
         model_subfolder = 'grounded'
     json_model = os.path.join(base_dir, 'dl_model', 'models', model_subfolder, 'model.json')
     h5_model = os.path.join(base_dir, 'dl_model', 'models', model_subfolder, 'model.h5')
-    selected_algorithm = selector.select_algorithm_from_model(json_model, h5_model, image_path)
-    return selected_algorithm
+    native_model = os.path.join(base_dir, 'dl_model', 'models', model_subfolder, 'model.bin')
+    native_executable = os.path.join(base_dir, 'builds', 'release64', 'bin', 'cnn-selector')
+    ranked_algorithms = selector.rank_algorithms_from_model(
+        json_model, h5_model, image_path, native_executable, native_model)
+    selected_algorithms = ranked_algorithms[:num_planners]
+    print("Chose {}".format(", ".join(selected_algorithms)))
+    return selected_algorithms
 
 
-def build_planner_from_command_line_options(base_dir, command_line_options, use_h2_preprocessor):
-    planner = [sys.executable, os.path.join(base_dir, 'fast-downward.py')]
+def uses_segment_backing_store(selected_planner):
+    return segment_backing_store is not None and selected_planner != 'seq-opt-symba-1'
+
+
+def build_planner_from_command_line_options(base_dir, command_line_options, use_h2_preprocessor, plan_file, memory_limit):
+    planner = [sys.executable, os.path.join(base_dir, 'fast-downward.py'), '--task-cache', get_task_cache_dir()]
     if use_h2_preprocessor:
         planner.extend(['--transform-task', 'preprocess'])
-    planner.extend(['--build', 'release64', '--search-memory-limit', '7600M', '--plan-file', plan, domain, problem])
+    if segment_backing_store is not None:
+        planner.extend(['--segment-backing-store', segment_backing_store])
+    planner.extend(['--build', 'release64', '--search-memory-limit', memory_limit, '--plan-file', plan_file, domain, problem])
+    generators_file = get_generators_file()
+    if os.path.exists(generators_file):
+        # Reuse the generators that Bliss found in the graph phase.
+        command_line_options = [
+            option.replace('structural_symmetries(', 'structural_symmetries(load_generators={},'.format(generators_file))
+            for option in command_line_options]
     planner.extend(command_line_options)
     return planner
 
 
-def run_planner(base_dir, selected_planner):
+def build_planner(base_dir, selected_planner, plan_file, memory_limit=DEFAULT_MEMORY_LIMIT):
     if selected_planner == 'seq-opt-symba-1':
-        planner = [sys.executable, os.path.join(base_dir, 'symba.py'), selected_planner, domain, problem, plan]
+        return [sys.executable, os.path.join(base_dir, 'symba.py'), selected_planner, domain, problem, plan_file]
     elif selected_planner == 'fallback':
-        planner = build_planner_from_command_line_options(base_dir, FALLBACK_COMMAND_LINE_OPTIONS, use_h2_preprocessor=True)
+        return build_planner_from_command_line_options(base_dir, FALLBACK_COMMAND_LINE_OPTIONS, True, plan_file, memory_limit)
     else:
         command_line_options = selector.ALGORITHM_TO_COMMAND_LINE_STRING[selected_planner]
         use_h2_preprocessor = selected_planner not in selector.ALGORITHMS_WITHOUT_H2_PREPROCESSOR
-        planner = build_planner_from_command_line_options(base_dir, command_line_options, use_h2_preprocessor)
+        return build_planner_from_command_line_options(base_dir, command_line_options, use_h2_preprocessor, plan_file, memory_limit)
+
+
+def run_planner(base_dir, selected_planner):
+    planner = build_planner(base_dir, selected_planner, plan)
     print("Running planner, call string: {}".format(planner))
     sys.stdout.flush()
     subprocess.call(planner)
 
 
-def determine_and_run_planner(domain, problem, plan, image_from_lifted_task):
+def has_found_plan(selected_planner, plan_file, exitcode):
+    if exitcode != 0:
+        return False
+    if selected_planner == 'seq-opt-symba-1':
+        # Symba does not write the cost line, but only writes its plan
+        # after the search has finished.
+        return os.path.exists(plan_file)
+    return plan_manager.is_complete_plan(plan_file)
+
+
+def run_planners_in_parallel(base_dir, pwd, selected_planners, plan, memory_limit):
+    """Run all planners at the same time, each with an equal share of the
+    memory limit, until one of them finds a plan. All selected planners
+    are optimal, so we kill the others as soon as a plan is found.
+    Return true iff one of the planners wrote its plan to the given file.
+
+    Each planner runs in its own directory, because Fast Downward and
+    Symba write intermediate files to the working directory."""
+    memory_per_planner = limits.split_memory_limit(memory_limit, len(selected_planners))
+    print("Memory limit per planner: {} MB".format(limits.convert_to_mb(memory_per_planner)))
+    manager = plan_manager.PlanManager(plan)
+    running = {}
+    for rank, selected_planner in enumerate(selected_planners, start=1):
+        planner_dir = os.path.join(pwd, 'planner-{}'.format(rank))
+        if not os.path.isdir(planner_dir):
+            os.makedirs(planner_dir)
+        plan_file = os.path.join(planner_dir, 'sas_plan')
+        # The search gets the planner's share as its own limit, because
+        # it may raise the limit of the process group for its segment
+        # backing store.
+        planner = build_planner(
+            base_dir, selected_planner, plan_file,
+            '{}K'.format(memory_per_planner // 1024))
+        print("Running planner {}, call string: {}".format(rank, planner))
+        with open(os.path.join(planner_dir, 'run.log'), 'w') as log:
+            process = call.start(
+                planner, cwd=planner_dir, stdout=log, memory_limit=memory_per_planner,
+                allow_raising_memory_limit=uses_segment_backing_store(selected_planner))
+        running[process] = (selected_planner, plan_file)
+
+    try:
+        while running:
+            for process in list(running):
+                exitcode = process.poll()
+                if exitcode is None:
+                    continue
+                selected_planner, plan_file = running.pop(process)
+                print("Planner {} finished with exitcode {}".format(selected_planner, exitcode))
+                if (has_found_plan(selected_planner, plan_file, exitcode) and
+                        manager.claim_plan(plan_file)):
+                    print("Using the plan of {}".format(selected_planner))
+                    return True
+            time.sleep(PARALLEL_POLL_INTERVAL)
+    finally:
+        for process in running:
+            call.kill_process_group(process)
+    return False
+
+
+def determine_and_run_planner(domain, problem, plan, image_from_lifted_task, graph_from_preprocessed_task, num_parallel_planners, memory_limit):
     """Return true iff the determined planner succesfully solved the task."""
     base_dir = get_base_dir()
     pwd = os.getcwd()
 
     print_highlighted_line("Computing an abstract structure graph from the " + ("lifted" if image_from_lifted_task else "grounded") + " task description...")
-    graph_file = compute_graph_for_task(base_dir, pwd, domain, problem, image_from_lifted_task)
+    graph_file = compute_graph_for_task(base_dir, pwd, domain, problem, image_from_lifted_task, graph_from_preprocessed_task)
     if graph_file is None:
         print_highlighted_line("Computing abstract structure graph failed, using fallback planner!")
         return False
@@ -136,14 +250,21 @@ def determine_and_run_planner(domain, problem, plan, image_from_lifted_task):
         print_highlighted_line("Done computing an abstract structure graph.")
 
     print_highlighted_line("Selecting planner from learned model...")
-    selected_planner = select_planner_from_model(base_dir, pwd, graph_file, image_from_lifted_task)
-    if selected_planner is None:
+    selected_planners = select_planners_from_model(base_dir, pwd, graph_file, image_from_lifted_task, num_parallel_planners)
+    if selected_planners is None:
         print_highlighted_line("Image creation or selection from model failed, using fallback planner!")
         return False
     else:
         print_highlighted_line("Done selecting planner from learned model.")
 
+    if num_parallel_planners > 1:
+        print_highlighted_line("Running the selected planners in parallel...")
+        found_plan = run_planners_in_parallel(base_dir, pwd, selected_planners, plan, memory_limit)
+        print_highlighted_line("Done running the selected planners.")
+        return found_plan
+
     print_highlighted_line("Running the selected planner...")
+    selected_planner = selected_planners[0]
     # Uncomment the following line for testing running symba.
     # selected_planner = 'seq-opt-symba-1'
     run_planner(base_dir, selected_planner)
@@ -165,17 +286,44 @@ if __name__ == "__main__":
         "--image-from-grounded-task", action="store_true",
         help="If true, create the PDG-style graph based on the grounded SAS "
         "task and then create an image from it.")
+    parser.add_argument(
+        "--graph-from-preprocessed-task", action="store_true",
+        help="If true, compute the graph of the grounded task after the h2 "
+        "preprocessor has run on it. Otherwise, the graph is computed from "
+        "the translator output (as used for training the model).")
+    parser.add_argument(
+        "--parallel-top-k", type=int, default=1, metavar="K",
+        help="Run the K planners with the best predicted scores in parallel "
+        "and stop all of them as soon as one finds a plan (default: %(default)s).")
+    parser.add_argument(
+        "--segment-backing-store", metavar="DIR",
+        help="Let the searches allocate their state data from memory-mapped "
+        "files in DIR, which do not count towards the memory limit, so that "
+        "the operating system pages out rarely used states instead of the "
+        "search running out of memory. Symba does not support this.")
+    parser.add_argument(
+        "--overall-memory-limit", default=DEFAULT_MEMORY_LIMIT,
+        help="Memory budget shared by the planners that run in parallel "
+        "(default: %(default)s). The suffixes K, M and G are supported.")
 
     args = parser.parse_args()
-    domain = args.domain_file
-    problem = args.problem_file
-    plan = args.plan_file
+    if args.parallel_top_k < 1:
+        parser.error("--parallel-top-k must be positive")
+    limits.set_memory_limit_in_bytes(parser, args, "overall")
+    # The planners that run in parallel use their own working directories.
+    domain = os.path.abspath(args.domain_file)
+    problem = os.path.abspath(args.problem_file)
+    plan = os.path.abspath(args.plan_file)
+    segment_backing_store = None
+    if args.segment_backing_store is not None:
+        segment_backing_store = os.path.abspath(args.segment_backing_store)
     image_from_lifted_task = args.image_from_lifted_task
     image_from_grounded_task = args.image_from_grounded_task
+    graph_from_preprocessed_task = args.graph_from_preprocessed_task
     if (image_from_lifted_task and image_from_grounded_task) or (not image_from_lifted_task and not image_from_grounded_task):
         sys.exit("Please use exactly one of --image-from-lifted-task and --image-from-grounded-task")
 
-    success = determine_and_run_planner(domain, problem, plan, image_from_lifted_task)
+    success = determine_and_run_planner(domain, problem, plan, image_from_lifted_task, graph_from_preprocessed_task, args.parallel_top_k, args.overall_memory_limit)
     if not success:
         print_highlighted_line("Running fallback planner...")
         base_dir = get_base_dir()
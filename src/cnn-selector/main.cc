@@ -0,0 +1,48 @@
+/*
+  Run the planner selection network on one image.
+
+  Usage: cnn-selector MODEL_FILE < PIXELS
+
+  MODEL_FILE is a model converted with dl_model/convert_model.py. PIXELS
+  are the raw 8-bit grayscale pixels of the image, row by row. We print
+  the predicted score of each planner, one per line, in the order of the
+  network outputs.
+*/
+
+#include "model.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, const char **argv) {
+    if (argc != 2) {
+        cerr << "usage: " << argv[0] << " MODEL_FILE < PIXELS" << endl;
+        return 2;
+    }
+    try {
+        Model model(argv[1]);
+
+        int input_size = model.get_input_shape().size();
+        vector<uint8_t> pixels(input_size);
+        if (fread(pixels.data(), 1, input_size, stdin) !=
+            static_cast<size_t>(input_size) || fgetc(stdin) != EOF) {
+            cerr << "expected " << input_size << " pixels on stdin" << endl;
+            return 2;
+        }
+        // Normalize to [0, 1] like dl_model/selector.py does for Keras.
+        vector<float> input(input_size);
+        for (int i = 0; i < input_size; ++i)
+            input[i] = pixels[i] / 255.0f;
+
+        for (float score : model.predict(input))
+            printf("%.9g\n", score);
+    } catch (const ModelError &error) {
+        cerr << "error: " << error.what() << endl;
+        return 1;
+    }
+    return 0;
+}
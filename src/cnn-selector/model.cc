@@ -0,0 +1,360 @@
+#include "model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+static const char MAGIC[8] = {'C', 'N', 'N', 'M', 'O', 'D', 'E', 'L'};
+static const uint32_t VERSION = 1;
+
+enum class LayerType {
+    CONV2D = 1,
+    MAX_POOLING2D = 2,
+    FLATTEN = 3,
+    DENSE = 4
+};
+
+class Reader {
+    ifstream file;
+    string filename;
+public:
+    explicit Reader(const string &filename)
+        : file(filename, ios::binary),
+          filename(filename) {
+        if (!file) {
+            throw ModelError("could not open " + filename);
+        }
+    }
+
+    void read_bytes(void *data, size_t num_bytes) {
+        file.read(static_cast<char *>(data), num_bytes);
+        if (!file) {
+            throw ModelError("unexpected end of " + filename);
+        }
+    }
+
+    int read_int() {
+        uint32_t value;
+        read_bytes(&value, sizeof(value));
+        if (value > (1u << 30)) {
+            throw ModelError("corrupt model file " + filename);
+        }
+        return value;
+    }
+
+    vector<float> read_floats(size_t num_values) {
+        vector<float> values(num_values);
+        read_bytes(values.data(), num_values * sizeof(float));
+        return values;
+    }
+
+    bool at_end() {
+        return file.peek() == char_traits<char>::eof();
+    }
+};
+
+static Activation read_activation(Reader &reader) {
+    int activation = reader.read_int();
+    if (activation > static_cast<int>(Activation::SOFTMAX)) {
+        throw ModelError("unknown activation " + to_string(activation));
+    }
+    return static_cast<Activation>(activation);
+}
+
+static void apply_activation(Activation activation, float *values, int size) {
+    switch (activation) {
+    case Activation::LINEAR:
+        break;
+    case Activation::RELU:
+        for (int i = 0; i < size; ++i)
+            values[i] = max(values[i], 0.0f);
+        break;
+    case Activation::SIGMOID:
+        for (int i = 0; i < size; ++i)
+            values[i] = 1.0f / (1.0f + exp(-values[i]));
+        break;
+    case Activation::SOFTMAX: {
+        float max_value = *max_element(values, values + size);
+        float sum = 0;
+        for (int i = 0; i < size; ++i) {
+            values[i] = exp(values[i] - max_value);
+            sum += values[i];
+        }
+        for (int i = 0; i < size; ++i)
+            values[i] /= sum;
+        break;
+    }
+    }
+}
+
+/*
+  Number of positions of a window of the given size that fit into the
+  input ("valid" padding).
+*/
+static int get_num_windows(int input_size, int window_size, int stride) {
+    if (input_size < window_size)
+        return 0;
+    return (input_size - window_size) / stride + 1;
+}
+
+class Conv2D : public Layer {
+    int filters;
+    int kernel_height;
+    int kernel_width;
+    int stride_height;
+    int stride_width;
+    int input_channels;
+    Activation activation;
+    // Kernel in Keras order [kernel_height][kernel_width][input_channels][filters].
+    vector<float> kernel;
+    vector<float> bias;
+public:
+    explicit Conv2D(Reader &reader) {
+        filters = reader.read_int();
+        kernel_height = reader.read_int();
+        kernel_width = reader.read_int();
+        stride_height = reader.read_int();
+        stride_width = reader.read_int();
+        input_channels = reader.read_int();
+        activation = read_activation(reader);
+        if (!filters || !kernel_height || !kernel_width ||
+            !stride_height || !stride_width || !input_channels) {
+            throw ModelError("invalid Conv2D layer");
+        }
+        kernel = reader.read_floats(
+            kernel_height * kernel_width * input_channels * filters);
+        bias = reader.read_floats(filters);
+    }
+
+    virtual Shape get_output_shape(const Shape &input_shape) const override {
+        if (input_shape.channels != input_channels) {
+            throw ModelError("Conv2D layer expects " +
+                             to_string(input_channels) + " input channels");
+        }
+        return Shape {
+                   get_num_windows(input_shape.height, kernel_height, stride_height),
+                   get_num_windows(input_shape.width, kernel_width, stride_width),
+                   filters
+        };
+    }
+
+    virtual void apply(const Shape &input_shape,
+                       const vector<float> &input,
+                       vector<float> &output) const override {
+        Shape output_shape = get_output_shape(input_shape);
+        output.resize(output_shape.size());
+        const int input_row_size = input_shape.width * input_channels;
+        for (int y = 0; y < output_shape.height; ++y) {
+            for (int x = 0; x < output_shape.width; ++x) {
+                float *out = &output[(y * output_shape.width + x) * filters];
+                copy(bias.begin(), bias.end(), out);
+                const float *in_window =
+                    &input[y * stride_height * input_row_size +
+                           x * stride_width * input_channels];
+                const float *weights = kernel.data();
+                for (int dy = 0; dy < kernel_height; ++dy) {
+                    const float *in = in_window + dy * input_row_size;
+                    for (int i = 0; i < kernel_width * input_channels; ++i) {
+                        // This loop runs over contiguous memory and vectorizes.
+                        const float value = in[i];
+                        for (int f = 0; f < filters; ++f)
+                            out[f] += value * weights[f];
+                        weights += filters;
+                    }
+                }
+                apply_activation(activation, out, filters);
+            }
+        }
+    }
+};
+
+class MaxPooling2D : public Layer {
+    int pool_height;
+    int pool_width;
+    int stride_height;
+    int stride_width;
+public:
+    explicit MaxPooling2D(Reader &reader) {
+        pool_height = reader.read_int();
+        pool_width = reader.read_int();
+        stride_height = reader.read_int();
+        stride_width = reader.read_int();
+        if (!pool_height || !pool_width || !stride_height || !stride_width) {
+            throw ModelError("invalid MaxPooling2D layer");
+        }
+    }
+
+    virtual Shape get_output_shape(const Shape &input_shape) const override {
+        return Shape {
+                   get_num_windows(input_shape.height, pool_height, stride_height),
+                   get_num_windows(input_shape.width, pool_width, stride_width),
+                   input_shape.channels
+        };
+    }
+
+    virtual void apply(const Shape &input_shape,
+                       const vector<float> &input,
+                       vector<float> &output) const override {
+        Shape output_shape = get_output_shape(input_shape);
+        output.resize(output_shape.size());
+        const int channels = input_shape.channels;
+        for (int y = 0; y < output_shape.height; ++y) {
+            for (int x = 0; x < output_shape.width; ++x) {
+                float *out = &output[(y * output_shape.width + x) * channels];
+                for (int dy = 0; dy < pool_height; ++dy) {
+                    for (int dx = 0; dx < pool_width; ++dx) {
+                        const float *in = &input[
+                            ((y * stride_height + dy) * input_shape.width +
+                             x * stride_width + dx) * channels];
+                        if (dy == 0 && dx == 0) {
+                            copy(in, in + channels, out);
+                        } else {
+                            for (int c = 0; c < channels; ++c)
+                                out[c] = max(out[c], in[c]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+class Flatten : public Layer {
+public:
+    virtual Shape get_output_shape(const Shape &input_shape) const override {
+        return Shape {1, 1, input_shape.size()};
+    }
+
+    virtual void apply(const Shape &,
+                       const vector<float> &input,
+                       vector<float> &output) const override {
+        // Tensors are stored in the order in which Keras flattens them.
+        output = input;
+    }
+};
+
+class Dense : public Layer {
+    int units;
+    int input_size;
+    Activation activation;
+    // Transposed Keras kernel: weights[unit * input_size + i].
+    vector<float> weights;
+    vector<float> bias;
+
+    /*
+      We sum with several independent accumulators so that the compiler can
+      vectorize the loop without reassociating floating-point additions.
+    */
+    static float dot_product(const float *lhs, const float *rhs, int size) {
+        const int NUM_ACCUMULATORS = 8;
+        float sums[NUM_ACCUMULATORS] = {0};
+        int i = 0;
+        for (; i + NUM_ACCUMULATORS <= size; i += NUM_ACCUMULATORS) {
+            for (int j = 0; j < NUM_ACCUMULATORS; ++j)
+                sums[j] += lhs[i + j] * rhs[i + j];
+        }
+        for (; i < size; ++i)
+            sums[0] += lhs[i] * rhs[i];
+        float sum = 0;
+        for (int j = 0; j < NUM_ACCUMULATORS; ++j)
+            sum += sums[j];
+        return sum;
+    }
+public:
+    explicit Dense(Reader &reader) {
+        units = reader.read_int();
+        input_size = reader.read_int();
+        activation = read_activation(reader);
+        if (!units || !input_size) {
+            throw ModelError("invalid Dense layer");
+        }
+        weights = reader.read_floats(static_cast<size_t>(units) * input_size);
+        bias = reader.read_floats(units);
+    }
+
+    virtual Shape get_output_shape(const Shape &input_shape) const override {
+        if (input_shape.height != 1 || input_shape.width != 1 ||
+            input_shape.channels != input_size) {
+            throw ModelError("Dense layer expects a flat input of size " +
+                             to_string(input_size));
+        }
+        return Shape {1, 1, units};
+    }
+
+    virtual void apply(const Shape &,
+                       const vector<float> &input,
+                       vector<float> &output) const override {
+        output.resize(units);
+        for (int unit = 0; unit < units; ++unit) {
+            output[unit] = bias[unit] + dot_product(
+                &weights[static_cast<size_t>(unit) * input_size],
+                input.data(), input_size);
+        }
+        apply_activation(activation, output.data(), units);
+    }
+};
+
+static unique_ptr<Layer> read_layer(Reader &reader) {
+    int type = reader.read_int();
+    switch (static_cast<LayerType>(type)) {
+    case LayerType::CONV2D:
+        return unique_ptr<Layer>(new Conv2D(reader));
+    case LayerType::MAX_POOLING2D:
+        return unique_ptr<Layer>(new MaxPooling2D(reader));
+    case LayerType::FLATTEN:
+        return unique_ptr<Layer>(new Flatten());
+    case LayerType::DENSE:
+        return unique_ptr<Layer>(new Dense(reader));
+    }
+    throw ModelError("unknown layer type " + to_string(type));
+}
+
+Model::Model(const string &filename) {
+    Reader reader(filename);
+    char magic[sizeof(MAGIC)];
+    reader.read_bytes(magic, sizeof(magic));
+    if (memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw ModelError(filename + " is not a converted model file");
+    }
+    uint32_t version;
+    reader.read_bytes(&version, sizeof(version));
+    if (version != VERSION) {
+        throw ModelError("unsupported model file version " + to_string(version));
+    }
+    input_shape.height = reader.read_int();
+    input_shape.width = reader.read_int();
+    input_shape.channels = reader.read_int();
+    int num_layers = reader.read_int();
+
+    // Check the layer dimensions once, so that predict() cannot fail.
+    Shape shape = input_shape;
+    for (int i = 0; i < num_layers; ++i) {
+        layers.push_back(read_layer(reader));
+        shape = layers.back()->get_output_shape(shape);
+        if (shape.size() == 0) {
+            throw ModelError("layer " + to_string(i) + " has an empty output");
+        }
+    }
+    if (!reader.at_end()) {
+        throw ModelError("trailing data in " + filename);
+    }
+}
+
+vector<float> Model::predict(const vector<float> &input) const {
+    if (static_cast<int>(input.size()) != input_shape.size()) {
+        throw ModelError("input has wrong size");
+    }
+    vector<float> current = input;
+    vector<float> next;
+    Shape shape = input_shape;
+    for (const unique_ptr<Layer> &layer : layers) {
+        layer->apply(shape, current, next);
+        shape = layer->get_output_shape(shape);
+        current.swap(next);
+    }
+    return current;
+}
@@ -0,0 +1,68 @@
+#ifndef MODEL_H
+#define MODEL_H
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+  Inference for the sequential Keras models used to select a planner
+  (dl_model/models/{grounded,lifted}/model.json). The weights are read from
+  the flat binary file written by dl_model/convert_model.py, which documents
+  the format.
+
+  Tensors are stored in row-major "channels last" order (height, width,
+  channels), like in Keras, so that flattening is a no-op and the
+  innermost loops of all layers run over contiguous memory.
+*/
+
+class ModelError : public std::runtime_error {
+public:
+    explicit ModelError(const std::string &msg)
+        : std::runtime_error(msg) {
+    }
+};
+
+enum class Activation {
+    LINEAR = 0,
+    RELU = 1,
+    SIGMOID = 2,
+    SOFTMAX = 3
+};
+
+struct Shape {
+    int height;
+    int width;
+    int channels;
+
+    int size() const {
+        return height * width * channels;
+    }
+};
+
+class Layer {
+public:
+    virtual ~Layer() = default;
+    virtual Shape get_output_shape(const Shape &input_shape) const = 0;
+    virtual void apply(const Shape &input_shape,
+                       const std::vector<float> &input,
+                       std::vector<float> &output) const = 0;
+};
+
+class Model {
+    Shape input_shape;
+    std::vector<std::unique_ptr<Layer>> layers;
+public:
+    explicit Model(const std::string &filename);
+    ~Model() = default;
+
+    const Shape &get_input_shape() const {
+        return input_shape;
+    }
+
+    // Compute the network output for an input of shape get_input_shape().
+    std::vector<float> predict(const std::vector<float> &input) const;
+};
+
+#endif
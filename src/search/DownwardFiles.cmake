@@ -76,7 +76,7 @@ fast_downward_plugin(
         state_registry
         task_proxy
 
-    DEPENDS CAUSAL_GRAPH INT_PACKER ORDERED_SET SEGMENTED_VECTOR SUCCESSOR_GENERATOR TASK_PROPERTIES
+    DEPENDS CAUSAL_GRAPH INT_PACKER ORDERED_SET PRECOMPUTATION_CACHE SEGMENTED_VECTOR SUCCESSOR_GENERATOR TASK_PROPERTIES
     CORE_PLUGIN
 )
 
@@ -113,6 +113,7 @@ fast_downward_plugin(
         utils/markup
         utils/math
         utils/memory
+        utils/parallel
         utils/rng
         utils/rng_options
         utils/system
@@ -129,6 +130,13 @@ fast_downward_plugin(
         open_lists/alternation_open_list
 )
 
+fast_downward_plugin(
+    NAME BUCKET_OPEN_LIST
+    HELP "Bucket-based open list for two non-negative evaluators"
+    SOURCES
+        open_lists/bucket_open_list
+)
+
 fast_downward_plugin(
     NAME EPSILON_GREEDY_OPEN_LIST
     HELP "Open list that chooses an entry randomly with probability epsilon"
@@ -164,6 +172,14 @@ fast_downward_plugin(
         open_lists/type_based_open_list
 )
 
+fast_downward_plugin(
+    NAME COMPRESSED_LISTS
+    HELP "Fixed collection of integer lists stored in flat arrays"
+    SOURCES
+        algorithms/compressed_lists
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME DYNAMIC_BITSET
     HELP "Poor man's version of boost::dynamic_bitset"
@@ -216,6 +232,7 @@ fast_downward_plugin(
     NAME SEGMENTED_VECTOR
     HELP "Memory-friendly and vector-like data structure"
     SOURCES
+        algorithms/segment_allocator
         algorithms/segmented_vector
     DEPENDENCY_ONLY
 )
@@ -309,7 +326,15 @@ fast_downward_plugin(
     HELP "Basic classes used for all search engines"
     SOURCES
         search_engines/search_common
-    DEPENDS ALTERNATION_OPEN_LIST G_EVALUATOR STANDARD_SCALAR_OPEN_LIST SUM_EVALUATOR TIEBREAKING_OPEN_LIST WEIGHTED_EVALUATOR
+    DEPENDS ALTERNATION_OPEN_LIST BUCKET_OPEN_LIST G_EVALUATOR STANDARD_SCALAR_OPEN_LIST SUM_EVALUATOR TASK_PROPERTIES TIEBREAKING_OPEN_LIST WEIGHTED_EVALUATOR
+    DEPENDENCY_ONLY
+)
+
+fast_downward_plugin(
+    NAME SEARCH_CHECKPOINT
+    HELP "Files for checkpoints and cached precomputations"
+    SOURCES
+        search_engines/search_checkpoint
     DEPENDENCY_ONLY
 )
 
@@ -318,7 +343,7 @@ fast_downward_plugin(
     HELP "Eager search algorithm"
     SOURCES
         search_engines/eager_search
-    DEPENDS NULL_PRUNING_METHOD ORDERED_SET SUCCESSOR_GENERATOR
+    DEPENDS NULL_PRUNING_METHOD ORDERED_SET SEARCH_CHECKPOINT SUCCESSOR_GENERATOR
     DEPENDENCY_ONLY
 )
 
@@ -378,6 +403,22 @@ fast_downward_plugin(
     DEPENDS G_EVALUATOR ORDERED_SET PREF_EVALUATOR SEARCH_COMMON SUCCESSOR_GENERATOR
 )
 
+fast_downward_plugin(
+    NAME HDA_SEARCH
+    HELP "Hash-distributed parallel A* search"
+    SOURCES
+        search_engines/hda_search
+    DEPENDS NULL_PRUNING_METHOD SEARCH_COMMON SUCCESSOR_GENERATOR
+)
+
+fast_downward_plugin(
+    NAME EXTERNAL_SEARCH
+    HELP "External-memory A* search"
+    SOURCES
+        search_engines/external_search
+    DEPENDS SUCCESSOR_GENERATOR
+)
+
 fast_downward_plugin(
     NAME ITERATED_SEARCH
     HELP "Iterated search algorithm"
@@ -480,7 +521,7 @@ fast_downward_plugin(
     SOURCES
         heuristics/lm_cut_heuristic
         heuristics/lm_cut_landmarks
-    DEPENDS PRIORITY_QUEUES TASK_PROPERTIES
+    DEPENDS COMPRESSED_LISTS PRIORITY_QUEUES TASK_PROPERTIES
 )
 
 fast_downward_plugin(
@@ -489,7 +530,7 @@ fast_downward_plugin(
     SOURCES
         heuristics/ce_lm_cut_heuristic
         heuristics/ce_lm_cut_landmarks
-    DEPENDS PRIORITY_QUEUES TASK_PROPERTIES
+    DEPENDS COMPRESSED_LISTS PRIORITY_QUEUES TASK_PROPERTIES
 )
 
 fast_downward_plugin(
@@ -559,6 +600,15 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME PRECOMPUTATION_CACHE
+    HELP "Cache for precomputed heuristic data"
+    SOURCES
+        task_utils/precomputation_cache
+    DEPENDS SEARCH_CHECKPOINT TASK_PROPERTIES
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME VARIABLE_ORDER_FINDER
     HELP "Variable order finder"
@@ -684,6 +734,8 @@ fast_downward_plugin(
     SOURCES
         pdbs/canonical_pdbs
         pdbs/canonical_pdbs_heuristic
+        pdbs/compiled_pdb_collection
+        pdbs/distance_table
         pdbs/dominance_pruning
         pdbs/incremental_canonical_pdbs
         pdbs/match_tree
@@ -699,12 +751,13 @@ fast_downward_plugin(
         pdbs/pattern_generator_greedy
         pdbs/pattern_generator_manual
         pdbs/pattern_generator
+        pdbs/pdb_cache
         pdbs/pdb_heuristic
         pdbs/types
         pdbs/validation
         pdbs/zero_one_pdbs
         pdbs/zero_one_pdbs_heuristic
-    DEPENDS CAUSAL_GRAPH MAX_CLIQUES PRIORITY_QUEUES SAMPLING SUCCESSOR_GENERATOR TASK_PROPERTIES VARIABLE_ORDER_FINDER
+    DEPENDS CAUSAL_GRAPH COMPRESSED_LISTS MAX_CLIQUES PRIORITY_QUEUES SAMPLING SUCCESSOR_GENERATOR TASK_PROPERTIES VARIABLE_ORDER_FINDER
 )
 
 fast_downward_plugin(
@@ -754,9 +807,10 @@ fast_downward_plugin(
     HELP "Plugin containing the code for computing structural symmetries"
     SOURCES
         structural_symmetries/graph_creator.cc
+        structural_symmetries/graph_image.cc
         structural_symmetries/group.cc
         structural_symmetries/permutation.cc
-    DEPENDS BLISS
+    DEPENDS BLISS TASK_PROPERTIES
 )
 
 fast_downward_plugin(
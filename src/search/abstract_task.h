@@ -55,6 +55,13 @@ struct hash<FactPair> {
 };
 }
 
+namespace utils {
+inline void feed(HashState &hash_state, const FactPair &fact) {
+    feed(hash_state, fact.var);
+    feed(hash_state, fact.value);
+}
+}
+
 class AbstractTask {
 public:
     AbstractTask() = default;
@@ -0,0 +1,115 @@
+#ifndef ALGORITHMS_COMPRESSED_LISTS_H
+#define ALGORITHMS_COMPRESSED_LISTS_H
+
+#include <cassert>
+#include <vector>
+
+namespace compressed_lists {
+/*
+  A fixed collection of integer lists, stored in two flat arrays
+  (compressed sparse row format). The entries of list i are
+  entries[start[i]], ..., entries[start[i + 1] - 1].
+
+  Compared to a vector of vectors, this needs only two allocations, and
+  iterating over consecutive lists reads consecutive memory.
+*/
+class CompressedLists {
+    std::vector<int> start;
+    std::vector<int> entries;
+
+public:
+    class Range {
+        const int *begin_;
+        const int *end_;
+    public:
+        Range(const int *begin, const int *end)
+            : begin_(begin), end_(end) {
+        }
+
+        const int *begin() const {
+            return begin_;
+        }
+
+        const int *end() const {
+            return end_;
+        }
+
+        int size() const {
+            return end_ - begin_;
+        }
+
+        bool empty() const {
+            return begin_ == end_;
+        }
+    };
+
+    CompressedLists()
+        : start(1, 0) {
+    }
+
+    explicit CompressedLists(const std::vector<std::vector<int>> &lists) {
+        start.reserve(lists.size() + 1);
+        start.push_back(0);
+        for (const std::vector<int> &list : lists) {
+            entries.insert(entries.end(), list.begin(), list.end());
+            start.push_back(entries.size());
+        }
+    }
+
+    /*
+      Build the inverse relation: list j of the result contains all i
+      such that j occurs in list i, in increasing order of i.
+    */
+    CompressedLists invert(int num_inverse_lists) const {
+        CompressedLists inverse;
+        inverse.start.assign(num_inverse_lists + 1, 0);
+        for (int entry : entries) {
+            assert(entry >= 0 && entry < num_inverse_lists);
+            ++inverse.start[entry + 1];
+        }
+        for (int j = 0; j < num_inverse_lists; ++j) {
+            inverse.start[j + 1] += inverse.start[j];
+        }
+        inverse.entries.resize(entries.size());
+        std::vector<int> next(inverse.start.begin(), inverse.start.end() - 1);
+        for (int i = 0; i < size(); ++i) {
+            for (int entry : (*this)[i]) {
+                inverse.entries[next[entry]++] = i;
+            }
+        }
+        return inverse;
+    }
+
+    int size() const {
+        return start.size() - 1;
+    }
+
+    Range operator[](int i) const {
+        assert(i >= 0 && i < size());
+        return get_range(start[i], start[i + 1]);
+    }
+
+    /*
+      Lists can also be addressed by the positions of their first and
+      past-the-end entries. Users can store these positions next to
+      other data of the list owners to save the lookups in start.
+    */
+    int get_begin(int i) const {
+        assert(i >= 0 && i < size());
+        return start[i];
+    }
+
+    int get_end(int i) const {
+        assert(i >= 0 && i < size());
+        return start[i + 1];
+    }
+
+    Range get_range(int begin, int end) const {
+        assert(0 <= begin && begin <= end && end <= static_cast<int>(entries.size()));
+        const int *data = entries.data();
+        return Range(data + begin, data + end);
+    }
+};
+}
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef ALGORITHMS_INT_HASH_SET_H
+#define ALGORITHMS_INT_HASH_SET_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/*
+  IntHashSet is a hash set of non-negative ints (typically indices into
+  some external storage like the state data pool of a StateRegistry) that
+  are hashed and compared semantically by the given functors.
+
+  Compared to std::unordered_set, it has the following advantages:
+    1. There is no allocation per entry. All entries live in one flat array
+       of 8-byte buckets using open addressing with linear probing and
+       Robin Hood insertion, which keeps probe sequences short even at high
+       load factors.
+    2. Each bucket stores 32 bits of the hash value next to the key. We only
+       call the (expensive) equality functor if these bits match, and we
+       never need to call the hash functor again when growing.
+    3. Growing has no stop-the-world rehash: when the table is full, we
+       allocate a table of twice the size and move the entries of the old
+       table over incrementally, a few buckets per insertion. Until all
+       entries have moved, lookups also check the (read-only) old table.
+
+  The interface only offers what the state registry needs: inserting keys
+  and querying the number of keys. Keys cannot be removed.
+*/
+
+// For documentation on classes relevant to storing and working with registered
+// states see the file state_registry.h.
+
+namespace int_hash_set {
+template<typename Hasher, typename Equal>
+class IntHashSet {
+    using KeyType = int;
+    using HashType = std::uint32_t;
+
+    static const KeyType EMPTY_KEY = -1;
+    static const std::size_t MIN_CAPACITY = 16;
+    // Grow when more than MAX_LOAD_NUMERATOR / 8 of the buckets are used.
+    static const std::size_t MAX_LOAD_NUMERATOR = 7;
+    /*
+      Number of old buckets moved per insertion while growing. Moving at
+      least two buckets per insertion guarantees that we are done long
+      before the new table is full.
+    */
+    static const std::size_t MIGRATION_STEP = 4;
+
+    struct Bucket {
+        KeyType key;
+        HashType hash;
+
+        Bucket()
+            : key(EMPTY_KEY), hash(0) {
+        }
+
+        Bucket(KeyType key, HashType hash)
+            : key(key), hash(hash) {
+        }
+
+        bool is_empty() const {
+            return key == EMPTY_KEY;
+        }
+    };
+
+    class Table {
+        std::vector<Bucket> buckets;
+        std::size_t mask;
+        std::size_t num_entries;
+
+        std::size_t get_home(HashType hash) const {
+            return hash & mask;
+        }
+
+        std::size_t get_distance(std::size_t pos, const Bucket &bucket) const {
+            return (pos - get_home(bucket.hash)) & mask;
+        }
+    public:
+        explicit Table(std::size_t capacity = 0)
+            : buckets(capacity),
+              mask(capacity - 1),
+              num_entries(0) {
+            assert((capacity & (capacity - 1)) == 0);
+        }
+
+        std::size_t capacity() const {
+            return buckets.size();
+        }
+
+        std::size_t size() const {
+            return num_entries;
+        }
+
+        bool is_full() const {
+            return (num_entries + 1) * 8 > capacity() * MAX_LOAD_NUMERATOR;
+        }
+
+        const Bucket &get_bucket(std::size_t pos) const {
+            return buckets[pos];
+        }
+
+        template<typename KeyEqual>
+        KeyType find(KeyType key, HashType hash, const KeyEqual &equal) const {
+            if (buckets.empty()) {
+                return EMPTY_KEY;
+            }
+            std::size_t pos = get_home(hash);
+            for (std::size_t distance = 0;; ++distance) {
+                const Bucket &bucket = buckets[pos];
+                /*
+                  With Robin Hood insertion, the key would have displaced
+                  every bucket that is closer to its home than the key
+                  would be.
+                */
+                if (bucket.is_empty() || get_distance(pos, bucket) < distance) {
+                    return EMPTY_KEY;
+                }
+                if (bucket.hash == hash && equal(bucket.key, key)) {
+                    return bucket.key;
+                }
+                pos = (pos + 1) & mask;
+            }
+        }
+
+        // The key must not be present yet and the table must not be full.
+        void insert(Bucket entry) {
+            assert(num_entries < capacity());
+            std::size_t pos = get_home(entry.hash);
+            std::size_t distance = 0;
+            while (true) {
+                Bucket &bucket = buckets[pos];
+                if (bucket.is_empty()) {
+                    bucket = entry;
+                    ++num_entries;
+                    return;
+                }
+                std::size_t bucket_distance = get_distance(pos, bucket);
+                if (bucket_distance < distance) {
+                    std::swap(bucket, entry);
+                    distance = bucket_distance;
+                }
+                pos = (pos + 1) & mask;
+                ++distance;
+            }
+        }
+
+        void swap(Table &other) {
+            buckets.swap(other.buckets);
+            std::swap(mask, other.mask);
+            std::swap(num_entries, other.num_entries);
+        }
+    };
+
+    Hasher hasher;
+    Equal equal;
+    Table table;
+    // Table from before the last resize. Its entries move to table.
+    Table old_table;
+    // All buckets of old_table before this position have moved to table.
+    std::size_t migration_pos;
+    // Number of entries of old_table that have not moved yet.
+    std::size_t num_unmigrated_entries;
+
+    HashType get_hash(KeyType key) const {
+        std::uint64_t hash = hasher(key);
+        return static_cast<HashType>(hash ^ (hash >> 32));
+    }
+
+    void migrate(std::size_t num_buckets) {
+        std::size_t end = std::min(migration_pos + num_buckets, old_table.capacity());
+        for (; migration_pos < end; ++migration_pos) {
+            const Bucket &bucket = old_table.get_bucket(migration_pos);
+            if (!bucket.is_empty()) {
+                table.insert(bucket);
+                --num_unmigrated_entries;
+            }
+        }
+        if (migration_pos == old_table.capacity()) {
+            assert(num_unmigrated_entries == 0);
+            Table().swap(old_table);
+            migration_pos = 0;
+        }
+    }
+
+    void grow() {
+        // Finish any previous resize (never needed with a large enough MIGRATION_STEP).
+        migrate(old_table.capacity());
+        std::size_t new_capacity = 2 * table.capacity();
+        if (new_capacity < MIN_CAPACITY) {
+            new_capacity = MIN_CAPACITY;
+        }
+        Table new_table(new_capacity);
+        new_table.swap(table);
+        new_table.swap(old_table);
+        num_unmigrated_entries = old_table.size();
+        migration_pos = 0;
+    }
+
+public:
+    IntHashSet(const Hasher &hasher, const Equal &equal)
+        : hasher(hasher),
+          equal(equal),
+          migration_pos(0),
+          num_unmigrated_entries(0) {
+    }
+
+    /*
+      Insert the key unless a semantically equal key is present. Return the
+      key in the set and whether it was inserted, like std::unordered_set.
+    */
+    std::pair<KeyType, bool> insert(KeyType key) {
+        assert(key >= 0);
+        HashType hash = get_hash(key);
+        KeyType found = table.find(key, hash, equal);
+        if (found == EMPTY_KEY && num_unmigrated_entries) {
+            found = old_table.find(key, hash, equal);
+        }
+        if (found != EMPTY_KEY) {
+            return std::make_pair(found, false);
+        }
+        if (table.is_full()) {
+            grow();
+        }
+        table.insert(Bucket(key, hash));
+        if (num_unmigrated_entries) {
+            migrate(MIGRATION_STEP);
+        }
+        return std::make_pair(key, true);
+    }
+
+    std::size_t size() const {
+        return table.size() + num_unmigrated_entries;
+    }
+
+    // Memory used by the buckets (excluding the memory of the functors).
+    std::size_t get_memory_in_bytes() const {
+        return (table.capacity() + old_table.capacity()) * sizeof(Bucket);
+    }
+};
+}
+
+#endif
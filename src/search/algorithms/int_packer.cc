@@ -58,9 +58,21 @@ public:
     }
 
     void set(Bin *buffer, int value) const {
-        assert(value >= 0 && value < range);
         Bin &bin = buffer[bin_index];
-        bin = (bin & clear_mask) | (value << shift);
+        bin = (bin & clear_mask) | get_value_bits(value);
+    }
+
+    int get_bin_index() const {
+        return bin_index;
+    }
+
+    Bin get_clear_mask() const {
+        return clear_mask;
+    }
+
+    Bin get_value_bits(int value) const {
+        assert(value >= 0 && value < range);
+        return value << shift;
     }
 };
 
@@ -81,6 +93,18 @@ void IntPacker::set(Bin *buffer, int var, int value) const {
     var_infos[var].set(buffer, value);
 }
 
+int IntPacker::get_bin_index(int var) const {
+    return var_infos[var].get_bin_index();
+}
+
+IntPacker::Bin IntPacker::get_clear_mask(int var) const {
+    return var_infos[var].get_clear_mask();
+}
+
+IntPacker::Bin IntPacker::get_value_bits(int var, int value) const {
+    return var_infos[var].get_value_bits(value);
+}
+
 void IntPacker::pack_bins(const vector<int> &ranges) {
     assert(var_infos.empty());
 
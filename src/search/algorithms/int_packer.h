@@ -42,6 +42,15 @@ public:
     int get(const Bin *buffer, int var) const;
     void set(Bin *buffer, int var, int value) const;
 
+    /*
+      Index of the bin that stores the given variable, the mask that clears
+      the variable in this bin and the bits that represent the given value.
+      This allows precompiling operations that set many variables at once.
+    */
+    int get_bin_index(int var) const;
+    Bin get_clear_mask(int var) const;
+    Bin get_value_bits(int var, int value) const;
+
     int get_num_bins() const {return num_bins; }
 };
 }
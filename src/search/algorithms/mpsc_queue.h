@@ -0,0 +1,82 @@
+#ifndef ALGORITHMS_MPSC_QUEUE_H
+#define ALGORITHMS_MPSC_QUEUE_H
+
+#include <atomic>
+#include <utility>
+
+/*
+  Unbounded lock-free FIFO queue for multiple producers and a single
+  consumer (Dmitry Vyukov's non-intrusive MPSC queue).
+
+  push() can be called from any thread and never blocks. pop() must only
+  be called from the consuming thread. It returns false if the queue is
+  empty, and it may also return false for an element whose push() has
+  not completed yet. This is fine for consumers that poll the queue
+  until they know that no more elements will arrive.
+
+  The queue allocates one node per element, so producers should push
+  batches of data rather than many small elements.
+*/
+
+namespace mpsc_queue {
+template<typename T>
+class MPSCQueue {
+    struct Node {
+        std::atomic<Node *> next;
+        T value;
+
+        Node()
+            : next(nullptr) {
+        }
+
+        explicit Node(T &&value)
+            : next(nullptr),
+              value(std::move(value)) {
+        }
+    };
+
+    // Last pushed node. Producers swap themselves in here.
+    std::atomic<Node *> head;
+    // Node before the next element to pop. Only used by the consumer.
+    Node *tail;
+
+public:
+    MPSCQueue()
+        : head(new Node()) {
+        tail = head.load(std::memory_order_relaxed);
+    }
+
+    ~MPSCQueue() {
+        T value;
+        while (pop(value)) {
+        }
+        delete tail;
+    }
+
+    MPSCQueue(const MPSCQueue &) = delete;
+    MPSCQueue &operator=(const MPSCQueue &) = delete;
+
+    void push(T value) {
+        Node *node = new Node(std::move(value));
+        Node *previous = head.exchange(node, std::memory_order_acq_rel);
+        /*
+          Until the following store, the element is in the queue but not
+          reachable by the consumer.
+        */
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    bool pop(T &value) {
+        Node *next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        value = std::move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+};
+}
+
+#endif
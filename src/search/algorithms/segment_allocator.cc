@@ -0,0 +1,243 @@
+#include "segment_allocator.h"
+
+#include "../utils/system.h"
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace segmented_vector {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+/*
+  Segments are carved out of large mapped regions of the file. Freed
+  segments are kept in free lists by size, since there are only few
+  different segment sizes.
+*/
+class MappedFile {
+    // Size of the regions by which we grow the file.
+    static const size_t REGION_BYTES = 16 << 20;
+    static const size_t ALIGNMENT = alignof(max_align_t);
+
+    int file_descriptor;
+    size_t file_size;
+    vector<pair<char *, size_t>> regions;
+    // Unused part of the last region.
+    char *next_segment;
+    size_t remaining_bytes;
+    unordered_map<size_t, vector<void *>> free_segments;
+
+    char *map_region(size_t bytes);
+public:
+    explicit MappedFile(const string &directory);
+
+    void *allocate(size_t bytes);
+    bool contains(const void *segment) const;
+    void deallocate(void *segment, size_t bytes);
+
+    size_t get_file_size() const {
+        return file_size;
+    }
+};
+
+static void exit_with_system_error(const string &message) {
+    cerr << message << ": " << strerror(errno) << endl;
+    if (errno == ENOMEM || errno == ENOSPC)
+        utils::exit_with(utils::ExitCode::OUT_OF_MEMORY);
+    utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+}
+
+/*
+  The pages of mapped regions are written back to the file instead of
+  using up physical memory or swap space, so they should not count
+  towards the memory limit of the search. The driver sets this limit as
+  a soft limit on the address space (RLIMIT_AS) and leaves the hard limit
+  open when the backing store is used, so we can raise the soft limit by
+  the size of each region before mapping it.
+*/
+static void exempt_from_address_space_limit(size_t bytes) {
+    rlimit limit;
+    if (getrlimit(RLIMIT_AS, &limit) == -1 || limit.rlim_cur == RLIM_INFINITY)
+        return;
+    rlim_t soft_limit = limit.rlim_cur + bytes;
+    if (limit.rlim_max != RLIM_INFINITY && soft_limit > limit.rlim_max) {
+        static bool warned = false;
+        if (!warned) {
+            cout << "Hard address space limit reached, the segment file "
+                 << "now counts towards the memory limit." << endl;
+            warned = true;
+        }
+        soft_limit = limit.rlim_max;
+    }
+    limit.rlim_cur = soft_limit;
+    if (setrlimit(RLIMIT_AS, &limit) == -1) {
+        exit_with_system_error("Could not raise the address space limit");
+    }
+}
+
+MappedFile::MappedFile(const string &directory)
+    : file_size(0),
+      next_segment(nullptr),
+      remaining_bytes(0) {
+    string path = directory + "/segments-" +
+        to_string(utils::get_process_id()) + ".tmp";
+    file_descriptor = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (file_descriptor == -1) {
+        exit_with_system_error("Could not create " + path);
+    }
+    // The file stays accessible through the file descriptor.
+    unlink(path.c_str());
+}
+
+char *MappedFile::map_region(size_t bytes) {
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    bytes = (bytes + page_size - 1) / page_size * page_size;
+#if OPERATING_SYSTEM == LINUX
+    /*
+      Reserve the disk space now. Otherwise, writing a page back to a full
+      disk would kill the process with SIGBUS.
+    */
+    int error = posix_fallocate(file_descriptor, file_size, bytes);
+    if (error != 0) {
+        errno = error;
+        exit_with_system_error("Could not grow the segment file");
+    }
+#else
+    if (ftruncate(file_descriptor, file_size + bytes) == -1) {
+        exit_with_system_error("Could not grow the segment file");
+    }
+#endif
+    exempt_from_address_space_limit(bytes);
+    void *region = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        file_descriptor, file_size);
+    if (region == MAP_FAILED) {
+        exit_with_system_error("Could not map the segment file");
+    }
+    file_size += bytes;
+    regions.emplace_back(static_cast<char *>(region), bytes);
+    return static_cast<char *>(region);
+}
+
+void *MappedFile::allocate(size_t bytes) {
+    bytes = (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    vector<void *> &free_list = free_segments[bytes];
+    if (!free_list.empty()) {
+        void *segment = free_list.back();
+        free_list.pop_back();
+        return segment;
+    }
+    if (bytes > remaining_bytes) {
+        if (bytes > REGION_BYTES / 4) {
+            // Do not waste the rest of the current region on large segments.
+            return map_region(bytes);
+        }
+        next_segment = map_region(REGION_BYTES);
+        remaining_bytes = REGION_BYTES;
+    }
+    void *segment = next_segment;
+    next_segment += bytes;
+    remaining_bytes -= bytes;
+    return segment;
+}
+
+bool MappedFile::contains(const void *segment) const {
+    const char *address = static_cast<const char *>(segment);
+    for (const pair<char *, size_t> &region : regions) {
+        if (address >= region.first && address < region.first + region.second)
+            return true;
+    }
+    return false;
+}
+
+void MappedFile::deallocate(void *segment, size_t bytes) {
+    bytes = (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    free_segments[bytes].push_back(segment);
+}
+#else
+class MappedFile {
+public:
+    explicit MappedFile(const string &) {
+        cerr << "Memory-mapped segments are not supported on this "
+             << "operating system." << endl;
+        utils::exit_with(utils::ExitCode::UNSUPPORTED);
+    }
+
+    void *allocate(size_t) {
+        return nullptr;
+    }
+
+    bool contains(const void *) const {
+        return false;
+    }
+
+    void deallocate(void *, size_t) {
+    }
+
+    size_t get_file_size() const {
+        return 0;
+    }
+};
+#endif
+
+/*
+  Segments can be allocated by several threads at the same time (e.g., in
+  hda_astar), so we protect the mapped file by a mutex.
+*/
+static MappedFile *mapped_file = nullptr;
+static mutex mapped_file_mutex;
+static atomic<size_t> heap_segment_bytes(0);
+static atomic<size_t> mapped_segment_bytes(0);
+
+void *allocate_segment(size_t bytes) {
+    if (mapped_file) {
+        lock_guard<mutex> lock(mapped_file_mutex);
+        mapped_segment_bytes += bytes;
+        return mapped_file->allocate(bytes);
+    }
+    heap_segment_bytes += bytes;
+    return ::operator new(bytes);
+}
+
+void deallocate_segment(void *segment, size_t bytes) {
+    if (mapped_file) {
+        lock_guard<mutex> lock(mapped_file_mutex);
+        if (mapped_file->contains(segment)) {
+            mapped_segment_bytes -= bytes;
+            mapped_file->deallocate(segment, bytes);
+            return;
+        }
+    }
+    heap_segment_bytes -= bytes;
+    ::operator delete(segment);
+}
+
+void use_mapped_file(const string &directory) {
+    lock_guard<mutex> lock(mapped_file_mutex);
+    if (!mapped_file) {
+        mapped_file = new MappedFile(directory);
+    }
+}
+
+void print_segment_statistics() {
+    cout << "Segment memory on heap: " << heap_segment_bytes / 1024
+         << " KB" << endl;
+    if (mapped_file) {
+        cout << "Segment memory in mapped file: "
+             << mapped_segment_bytes / 1024 << " KB" << endl;
+        cout << "Size of mapped segment file: "
+             << mapped_file->get_file_size() / 1024 << " KB" << endl;
+    }
+}
+}
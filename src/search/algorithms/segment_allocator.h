@@ -0,0 +1,92 @@
+#ifndef ALGORITHMS_SEGMENT_ALLOCATOR_H
+#define ALGORITHMS_SEGMENT_ALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <string>
+#include <utility>
+
+/*
+  Allocator for the segments of SegmentedVector and SegmentedArrayVector
+  (and hence for the state data of the state registries and the entries of
+  PerStateInformation).
+
+  By default, segments are allocated on the heap. After calling
+  use_mapped_file(), new segments are allocated from a memory-mapped file
+  instead. The operating system can then write rarely accessed segments
+  to the file and reuse their physical memory, so a search that needs more
+  memory than is physically available becomes slower instead of being
+  killed. Mapped regions are exempted from the soft limit on the address
+  space (ulimit -v), which is how the driver enforces the memory limit of
+  the search, as long as the hard limit allows it.
+
+  Segments are allocated rarely (a few KB at a time), so the allocator
+  uses free functions and has no state.
+*/
+
+namespace segmented_vector {
+void *allocate_segment(std::size_t bytes);
+void deallocate_segment(void *segment, std::size_t bytes);
+
+/*
+  Allocate all future segments from a file in the given directory. The
+  file is removed right after it is created, so it never outlives the
+  process. Exits with an error if the file cannot be created.
+*/
+void use_mapped_file(const std::string &directory);
+
+void print_segment_statistics();
+
+template<class T>
+class SegmentAllocator {
+public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template<class U>
+    struct rebind {
+        typedef SegmentAllocator<U> other;
+    };
+
+    SegmentAllocator() = default;
+
+    template<class U>
+    SegmentAllocator(const SegmentAllocator<U> &) {
+    }
+
+    T *allocate(std::size_t n) {
+        return static_cast<T *>(allocate_segment(n * sizeof(T)));
+    }
+
+    void deallocate(T *segment, std::size_t n) {
+        deallocate_segment(segment, n * sizeof(T));
+    }
+
+    template<class U, class ... Args>
+    void construct(U *p, Args && ... args) {
+        ::new(static_cast<void *>(p))U(std::forward<Args>(args) ...);
+    }
+
+    template<class U>
+    void destroy(U *p) {
+        p->~U();
+    }
+};
+
+template<class T, class U>
+bool operator==(const SegmentAllocator<T> &, const SegmentAllocator<U> &) {
+    return true;
+}
+
+template<class T, class U>
+bool operator!=(const SegmentAllocator<T> &, const SegmentAllocator<U> &) {
+    return false;
+}
+}
+
+#endif
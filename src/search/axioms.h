@@ -60,6 +60,10 @@ class AxiomEvaluator {
 public:
     explicit AxiomEvaluator(const TaskProxy &task_proxy);
     void evaluate(PackedStateBin *buffer, const int_packer::IntPacker &state_packer);
+
+    bool has_axioms() const {
+        return task_has_axioms;
+    }
 };
 
 #endif
@@ -930,6 +930,19 @@ public:
    */
   unsigned int get_nof_vertices() const {return vertices.size(); }
 
+  /**
+   * Return the color of the vertex \a v.
+   */
+  unsigned int get_color(const unsigned int v) const {return vertices[v].color; }
+
+  /**
+   * Return the targets of the edges leaving the vertex \a v.
+   * The targets may contain duplicates.
+   */
+  const std::vector<unsigned int>& get_edges_out(const unsigned int v) const {
+    return vertices[v].edges_out;
+  }
+
   /**
    * Add a new vertex with color 'color' in the graph and return its index.
    */
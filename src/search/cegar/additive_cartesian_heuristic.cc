@@ -7,6 +7,7 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../task_utils/precomputation_cache.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 #include "../utils/rng.h"
@@ -17,9 +18,31 @@
 using namespace std;
 
 namespace cegar {
+static vector<CartesianHeuristicFunction> load_heuristic_functions(
+    search_checkpoint::CheckpointReader &reader,
+    const shared_ptr<AbstractTask> &task) {
+    int num_functions = reader.read_value<int>();
+    vector<CartesianHeuristicFunction> functions;
+    functions.reserve(num_functions);
+    for (int i = 0; i < num_functions; ++i) {
+        functions.emplace_back(task, RefinementHierarchy(reader));
+    }
+    return functions;
+}
+
 static vector<CartesianHeuristicFunction> generate_heuristic_functions(
     const options::Options &opts) {
     g_log << "Initializing additive Cartesian heuristic..." << endl;
+    shared_ptr<AbstractTask> task =
+        opts.get<shared_ptr<AbstractTask>>("transform");
+    TaskProxy task_proxy(*task);
+    unique_ptr<search_checkpoint::CheckpointReader> reader =
+        precomputation_cache::open_entry(
+            "cegar", task_proxy, opts.get_unparsed_config());
+    if (reader) {
+        return load_heuristic_functions(*reader, task);
+    }
+
     vector<shared_ptr<SubtaskGenerator>> subtask_generators =
         opts.get_list<shared_ptr<SubtaskGenerator>>("subtasks");
     shared_ptr<utils::RandomNumberGenerator> rng =
@@ -32,8 +55,20 @@ static vector<CartesianHeuristicFunction> generate_heuristic_functions(
         opts.get<bool>("use_general_costs"),
         static_cast<PickSplit>(opts.get<int>("pick")),
         *rng);
-    return cost_saturation.generate_heuristic_functions(
-        opts.get<shared_ptr<AbstractTask>>("transform"));
+    vector<CartesianHeuristicFunction> functions =
+        cost_saturation.generate_heuristic_functions(task);
+
+    unique_ptr<search_checkpoint::CheckpointWriter> writer =
+        precomputation_cache::create_entry(
+            "cegar", task_proxy, opts.get_unparsed_config());
+    if (writer) {
+        writer->write_value(static_cast<int>(functions.size()));
+        for (const CartesianHeuristicFunction &function : functions) {
+            function.save(*writer, *task);
+        }
+        writer->commit();
+    }
+    return functions;
 }
 
 AdditiveCartesianHeuristic::AdditiveCartesianHeuristic(
@@ -1,5 +1,7 @@
 #include "cartesian_heuristic_function.h"
 
+#include <algorithm>
+
 using namespace std;
 
 namespace cegar {
@@ -15,4 +17,41 @@ int CartesianHeuristicFunction::get_value(const State &parent_state) const {
     State local_state = task_proxy.convert_ancestor_state(parent_state);
     return refinement_hierarchy.get_node(local_state)->get_h_value();
 }
+
+void CartesianHeuristicFunction::save(
+    search_checkpoint::CheckpointWriter &writer,
+    const AbstractTask &ancestor_task) const {
+    TaskProxy ancestor_task_proxy(ancestor_task);
+    VariablesProxy ancestor_variables = ancestor_task_proxy.get_variables();
+    VariablesProxy variables = task_proxy.get_variables();
+    assert(variables.size() == ancestor_variables.size());
+    int max_domain_size = 0;
+    vector<vector<vector<int>>> ancestor_values;
+    for (VariableProxy var : variables) {
+        ancestor_values.emplace_back(var.get_domain_size());
+        max_domain_size = max(
+            max_domain_size,
+            ancestor_variables[var.get_id()].get_domain_size());
+    }
+    /*
+      The subtask maps each variable independently, so converting one
+      state per value yields the mapping for all variables at once.
+    */
+    for (int value = 0; value < max_domain_size; ++value) {
+        vector<int> ancestor_state_values;
+        for (VariableProxy var : ancestor_variables) {
+            ancestor_state_values.push_back(
+                min(value, var.get_domain_size() - 1));
+        }
+        State state = task_proxy.convert_ancestor_state(
+            State(ancestor_task, move(ancestor_state_values)));
+        for (VariableProxy var : ancestor_variables) {
+            if (value < var.get_domain_size()) {
+                int var_id = var.get_id();
+                ancestor_values[var_id][state[var_id].get_value()].push_back(value);
+            }
+        }
+    }
+    refinement_hierarchy.save(writer, ancestor_values);
+}
 }
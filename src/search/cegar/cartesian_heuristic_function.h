@@ -32,6 +32,14 @@ public:
     }
 
     int get_value(const State &parent_state) const;
+
+    /*
+      Write the refinement hierarchy for the states of the given ancestor
+      task (see RefinementHierarchy::save). This requires that the subtask
+      only abstracts the domains of the variables of the ancestor task.
+    */
+    void save(search_checkpoint::CheckpointWriter &writer,
+              const AbstractTask &ancestor_task) const;
 };
 }
 
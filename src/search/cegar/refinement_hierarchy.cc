@@ -2,6 +2,10 @@
 
 #include "../task_proxy.h"
 
+#include "../search_engines/search_checkpoint.h"
+
+#include <unordered_map>
+
 using namespace std;
 
 namespace cegar {
@@ -50,6 +54,97 @@ RefinementHierarchy::RefinementHierarchy()
     : root(new Node()) {
 }
 
+RefinementHierarchy::RefinementHierarchy(
+    search_checkpoint::CheckpointReader &reader) {
+    vector<int> vars = reader.read_vector<int>();
+    vector<int> values = reader.read_vector<int>();
+    vector<int> left_children = reader.read_vector<int>();
+    vector<int> right_children = reader.read_vector<int>();
+    vector<int> h_values = reader.read_vector<int>();
+    int num_nodes = vars.size();
+    vector<Node *> nodes(num_nodes);
+    for (Node *&node : nodes) {
+        node = new Node();
+    }
+    for (int id = 0; id < num_nodes; ++id) {
+        Node *node = nodes[id];
+        node->var = vars[id];
+        node->value = values[id];
+        node->h = h_values[id];
+        if (vars[id] != Node::LEAF_NODE) {
+            node->left_child = nodes[left_children[id]];
+            node->right_child = nodes[right_children[id]];
+        }
+    }
+    // The root owns all other nodes (see Node::~Node).
+    root.reset(nodes[0]);
+}
+
+void RefinementHierarchy::save(
+    search_checkpoint::CheckpointWriter &writer,
+    const vector<vector<vector<int>>> &ancestor_values) const {
+    vector<int> vars;
+    vector<int> values;
+    vector<int> left_children;
+    vector<int> right_children;
+    vector<int> h_values;
+    /*
+      Each node is written as a chain of nodes, one for each ancestor value
+      of its split value. Assign IDs to the chains in the order in which
+      they are first reached, so that the root gets ID 0. We use an
+      explicit stack since the hierarchy can be very deep.
+    */
+    unordered_map<const Node *, int> first_ids;
+    vector<const Node *> stack;
+    auto get_first_id = [&](const Node *node) {
+            auto it = first_ids.find(node);
+            if (it != first_ids.end())
+                return it->second;
+            int first_id = vars.size();
+            int chain_length = 1;
+            if (node->is_split()) {
+                chain_length = ancestor_values[node->var][node->value].size();
+                assert(chain_length >= 1);
+            }
+            vars.resize(vars.size() + chain_length);
+            values.resize(vars.size());
+            left_children.resize(vars.size(), -1);
+            right_children.resize(vars.size(), -1);
+            h_values.resize(vars.size());
+            first_ids[node] = first_id;
+            stack.push_back(node);
+            return first_id;
+        };
+    get_first_id(root.get());
+    while (!stack.empty()) {
+        const Node *node = stack.back();
+        stack.pop_back();
+        int first_id = first_ids[node];
+        if (!node->is_split()) {
+            vars[first_id] = Node::LEAF_NODE;
+            values[first_id] = Node::LEAF_NODE;
+            h_values[first_id] = node->h;
+            continue;
+        }
+        int left_id = get_first_id(node->left_child);
+        int right_id = get_first_id(node->right_child);
+        const vector<int> &split_values = ancestor_values[node->var][node->value];
+        for (size_t i = 0; i < split_values.size(); ++i) {
+            int id = first_id + i;
+            vars[id] = node->var;
+            values[id] = split_values[i];
+            left_children[id] = (i == split_values.size() - 1) ? left_id : id + 1;
+            right_children[id] = right_id;
+            h_values[id] = node->h;
+        }
+    }
+    writer.write_vector(vars);
+    writer.write_vector(values);
+    writer.write_vector(left_children);
+    writer.write_vector(right_children);
+    writer.write_vector(h_values);
+}
+
 Node *RefinementHierarchy::get_node(const State &state) const {
     assert(root);
     Node *current = root.get();
@@ -8,6 +8,11 @@
 
 class State;
 
+namespace search_checkpoint {
+class CheckpointReader;
+class CheckpointWriter;
+}
+
 namespace cegar {
 class Node;
 
@@ -28,6 +33,8 @@ class RefinementHierarchy {
 
 public:
     RefinementHierarchy();
+    // Read a hierarchy written by save.
+    explicit RefinementHierarchy(search_checkpoint::CheckpointReader &reader);
 
     // Visual Studio 2013 needs an explicit implementation.
     RefinementHierarchy(RefinementHierarchy &&other)
@@ -39,10 +46,24 @@ public:
     Node *get_root() const {
         return root.get();
     }
+
+    /*
+      Write the hierarchy for the values of an ancestor task, where
+      ancestor_values[var][value] lists the values of var in the ancestor
+      task that are mapped to the given value of var in this task. A split
+      on a value with several ancestor values becomes a chain of splits, as
+      for helper nodes, so the loaded hierarchy can look up the states of
+      the ancestor task directly.
+    */
+    void save(
+        search_checkpoint::CheckpointWriter &writer,
+        const std::vector<std::vector<std::vector<int>>> &ancestor_values) const;
 };
 
 
 class Node {
+    friend class RefinementHierarchy;
+
     static const int LEAF_NODE = -1;
     /*
       While right_child is always the node of a (possibly split)
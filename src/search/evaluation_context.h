@@ -91,6 +91,12 @@ public:
     ~EvaluationContext() = default;
 
     const EvaluationResult &get_result(Evaluator *heur);
+    /*
+      Store a result that was computed in advance (see
+      Evaluator::compute_results). It is an error to store a result for
+      an evaluator that already has one.
+    */
+    void set_result(Evaluator *heur, const EvaluationResult &result);
     const HeuristicCache &get_cache() const;
     const GlobalState &get_state() const;
     int get_g_value() const;
@@ -21,6 +21,9 @@ bool Evaluator::dead_ends_are_reliable() const {
     return true;
 }
 
+void Evaluator::compute_results(vector<EvaluationContext> &) {
+}
+
 void Evaluator::report_value_for_initial_state(const EvaluationResult &result) const {
     assert(use_for_reporting_minima);
     cout << "Initial heuristic value for " << description << ": ";
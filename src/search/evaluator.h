@@ -4,6 +4,7 @@
 #include "evaluation_result.h"
 
 #include <set>
+#include <vector>
 
 class EvaluationContext;
 class Heuristic;
@@ -66,6 +67,19 @@ public:
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) = 0;
 
+    /*
+      compute_results can compute the results for several evaluation
+      contexts at once and store them in the contexts with
+      EvaluationContext::set_result. Search algorithms call it for all
+      successors of a state before inserting them into the open list,
+      so that evaluators that can evaluate many states faster together
+      can do so.
+
+      The default implementation does nothing, i.e., the results are
+      computed one by one by compute_result when they are needed.
+    */
+    virtual void compute_results(std::vector<EvaluationContext> &eval_contexts);
+
     void report_value_for_initial_state(const EvaluationResult &result) const;
     void report_new_minimum_value(const EvaluationResult &result) const;
 
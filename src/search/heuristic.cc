@@ -42,6 +42,31 @@ State Heuristic::convert_global_state(const GlobalState &global_state) const {
     return task_proxy.convert_ancestor_state(state);
 }
 
+void Heuristic::convert_global_states(
+    const vector<GlobalState> &global_states, vector<int> &values) const {
+    int num_variables = g_root_task()->get_num_variables();
+    values.clear();
+    if (task == g_root_task()) {
+        values.reserve(global_states.size() * num_variables);
+        for (const GlobalState &global_state : global_states) {
+            for (int var = 0; var < num_variables; ++var) {
+                values.push_back(global_state[var]);
+            }
+        }
+    } else {
+        values.reserve(global_states.size() * task->get_num_variables());
+        vector<int> state_values(num_variables);
+        for (const GlobalState &global_state : global_states) {
+            state_values.resize(num_variables);
+            for (int var = 0; var < num_variables; ++var) {
+                state_values[var] = global_state[var];
+            }
+            task->convert_state_values(state_values, g_root_task().get());
+            values.insert(values.end(), state_values.begin(), state_values.end());
+        }
+    }
+}
+
 void Heuristic::add_options_to_parser(OptionParser &parser) {
     parser.add_option<shared_ptr<AbstractTask>>(
         "transform",
@@ -60,6 +85,11 @@ Options Heuristic::default_options() {
     return opts;
 }
 
+bool Heuristic::compute_heuristic_batch(
+    const vector<GlobalState> &, vector<int> &) {
+    return false;
+}
+
 EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     EvaluationResult result;
 
@@ -113,6 +143,58 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     return result;
 }
 
+bool Heuristic::is_estimate_cached(const GlobalState &state) const {
+    return cache_h_values && heuristic_cache[state].h != NO_VALUE &&
+           !heuristic_cache[state].dirty;
+}
+
+int Heuristic::get_cached_estimate(const GlobalState &state) const {
+    assert(is_estimate_cached(state));
+    return heuristic_cache[state].h;
+}
+
+void Heuristic::set_cached_estimate(const GlobalState &state, int h) {
+    assert(h == DEAD_END || h >= 0);
+    if (cache_h_values) {
+        heuristic_cache[state] = HEntry(h, false);
+    }
+}
+
+void Heuristic::compute_results(vector<EvaluationContext> &eval_contexts) {
+    batch_contexts.clear();
+    batch_states.clear();
+    for (EvaluationContext &eval_context : eval_contexts) {
+        const GlobalState &state = eval_context.get_state();
+        // compute_result handles preferred operators and cached values.
+        if (eval_context.get_calculate_preferred() ||
+            (cache_h_values && heuristic_cache[state].h != NO_VALUE &&
+             !heuristic_cache[state].dirty)) {
+            continue;
+        }
+        batch_contexts.push_back(&eval_context);
+        batch_states.push_back(state);
+    }
+    if (batch_states.empty() ||
+        !compute_heuristic_batch(batch_states, batch_values))
+        return;
+    assert(batch_values.size() == batch_states.size());
+
+    for (size_t i = 0; i < batch_states.size(); ++i) {
+        int heuristic = batch_values[i];
+        assert(heuristic == DEAD_END || heuristic >= 0);
+        if (cache_h_values) {
+            heuristic_cache[batch_states[i]] = HEntry(heuristic, false);
+        }
+        if (heuristic == DEAD_END) {
+            heuristic = EvaluationResult::INFTY;
+        }
+        EvaluationResult result;
+        result.set_count_evaluation(true);
+        result.set_h_value(heuristic);
+        batch_contexts[i]->set_result(this, result);
+    }
+}
+
 
 static PluginTypePlugin<Heuristic> _type_plugin(
     "Heuristic",
@@ -2,6 +2,7 @@
 #define HEURISTIC_H
 
 #include "evaluator.h"
+#include "global_state.h"
 #include "operator_id.h"
 #include "per_state_information.h"
 #include "task_proxy.h"
@@ -11,7 +12,6 @@
 #include <memory>
 #include <vector>
 
-class GlobalState;
 class TaskProxy;
 
 namespace options {
@@ -45,6 +45,11 @@ class Heuristic : public Evaluator {
     */
     ordered_set::OrderedSet<OperatorID> preferred_operators;
 
+    // Buffers for batch evaluation.
+    std::vector<EvaluationContext *> batch_contexts;
+    std::vector<GlobalState> batch_states;
+    std::vector<int> batch_values;
+
 protected:
     /*
       Cache for saving h values
@@ -65,6 +70,17 @@ protected:
     // TODO: Call with State directly once all heuristics support it.
     virtual int compute_heuristic(const GlobalState &state) = 0;
 
+    /*
+      Heuristics that can compute the values of many states faster
+      together override this method. It should store the heuristic
+      values (or DEAD_END) of the states in values and return true.
+      Preferred operators cannot be computed this way. The default
+      implementation returns false, and the states are then evaluated
+      one by one with compute_heuristic.
+    */
+    virtual bool compute_heuristic_batch(
+        const std::vector<GlobalState> &states, std::vector<int> &values);
+
     /*
       Usage note: Marking the same operator as preferred multiple times
       is OK -- it will only appear once in the list of preferred
@@ -76,6 +92,16 @@ protected:
        heuristics use the TaskProxy class. */
     State convert_global_state(const GlobalState &global_state) const;
 
+    /*
+      Convert several global states for batch evaluation without
+      creating State objects. The values of the i-th state are stored in
+      values[i * n], ..., values[i * n + n - 1], where n is the number of
+      variables of the task of the heuristic.
+    */
+    void convert_global_states(
+        const std::vector<GlobalState> &global_states,
+        std::vector<int> &values) const;
+
 public:
     explicit Heuristic(const options::Options &options);
     virtual ~Heuristic() override;
@@ -91,6 +117,23 @@ public:
         const GlobalState &parent_state, OperatorID op_id,
         const GlobalState &state);
 
+    // Called by search algorithms after the search.
+    virtual void print_statistics() const {
+    }
+
+    // Return true iff an up-to-date h value of the state is cached.
+    bool is_estimate_cached(const GlobalState &state) const;
+    /*
+      Return the cached h value of a state for which is_estimate_cached
+      returns true. Dead ends have the value DEAD_END.
+    */
+    int get_cached_estimate(const GlobalState &state) const;
+    /*
+      Cache an h value returned by get_cached_estimate, e.g. when a search
+      is resumed. Does nothing if the heuristic does not cache estimates.
+    */
+    void set_cached_estimate(const GlobalState &state, int h);
+
     virtual void get_involved_heuristics(std::set<Heuristic *> &hset) override {
         hset.insert(this);
     }
@@ -100,6 +143,8 @@ public:
 
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
+    virtual void compute_results(
+        std::vector<EvaluationContext> &eval_contexts) override;
 };
 
 #endif
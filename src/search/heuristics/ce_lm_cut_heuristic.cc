@@ -9,6 +9,7 @@
 #include "../task_utils/task_properties.h"
 #include "../utils/memory.h"
 
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -16,8 +17,15 @@ using namespace std;
 namespace ce_lm_cut_heuristic {
 CELandmarkCutHeuristic::CELandmarkCutHeuristic(const Options &opts)
     : Heuristic(opts),
-      landmark_generator(utils::make_unique_ptr<CELandmarkCutLandmarks>(task_proxy)) {
+      landmark_generator(utils::make_unique_ptr<CELandmarkCutLandmarks>(task_proxy)),
+      incremental(opts.get<bool>("incremental")),
+      num_inherited_landmarks(0),
+      num_computed_landmarks(0) {
     cout << "Initializing landmark cut heuristic..." << endl;
+    if (incremental) {
+        // We apply operators to states to check the inherited landmarks.
+        task_properties::verify_no_axioms(task_proxy);
+    }
 }
 
 CELandmarkCutHeuristic::~CELandmarkCutHeuristic() {
@@ -25,6 +33,9 @@ CELandmarkCutHeuristic::~CELandmarkCutHeuristic() {
 
 int CELandmarkCutHeuristic::compute_heuristic(const GlobalState &global_state) {
     State state = convert_global_state(global_state);
+    if (incremental) {
+        return compute_heuristic_incrementally(state, landmarks[global_state]);
+    }
     return compute_heuristic(state);
 }
 
@@ -40,6 +51,103 @@ int CELandmarkCutHeuristic::compute_heuristic(const State &state) {
     return total_cost;
 }
 
+int CELandmarkCutHeuristic::compute_heuristic_incrementally(
+    const State &state, vector<int> &state_landmarks) {
+    // Initially, state_landmarks contains the inherited landmarks.
+    int total_cost = 0;
+    int num_inherited = 0;
+    for (size_t pos = 0; pos < state_landmarks.size();
+         pos += 2 + state_landmarks[pos + 1]) {
+        total_cost += state_landmarks[pos];
+        ++num_inherited;
+    }
+
+    vector<int> new_landmarks;
+    int num_computed = 0;
+    bool dead_end = landmark_generator->compute_landmarks(
+        state,
+        nullptr,
+        [&](const CELandmarkCutLandmarks::Landmark &landmark, int cut_cost) {
+            total_cost += cut_cost;
+            ++num_computed;
+            // Landmarks may contain operators repeatedly.
+            int begin = new_landmarks.size();
+            new_landmarks.push_back(cut_cost);
+            new_landmarks.push_back(0);
+            new_landmarks.insert(
+                new_landmarks.end(), landmark.begin(), landmark.end());
+            sort(new_landmarks.begin() + begin + 2, new_landmarks.end());
+            new_landmarks.erase(
+                unique(new_landmarks.begin() + begin + 2, new_landmarks.end()),
+                new_landmarks.end());
+            new_landmarks[begin + 1] = new_landmarks.size() - begin - 2;
+        },
+        &state_landmarks);
+
+    if (dead_end) {
+        vector<int>().swap(state_landmarks);
+        return DEAD_END;
+    }
+    num_inherited_landmarks += num_inherited;
+    num_computed_landmarks += num_computed;
+    state_landmarks.insert(
+        state_landmarks.end(), new_landmarks.begin(), new_landmarks.end());
+    state_landmarks.shrink_to_fit();
+    return total_cost;
+}
+
+bool CELandmarkCutHeuristic::notify_state_transition(
+    const GlobalState &parent_state, OperatorID op_id,
+    const GlobalState &state) {
+    if (!incremental) {
+        return false;
+    }
+    vector<int> &state_landmarks = landmarks[state];
+    if (!state_landmarks.empty()) {
+        // The state has been reached before.
+        return false;
+    }
+    const vector<int> &parent_landmarks = landmarks[parent_state];
+    if (parent_landmarks.empty()) {
+        return false;
+    }
+    /*
+      The landmarks are only inherited if the state is the successor of
+      the parent state. This is not the case, e.g., in orbit search, where
+      the state may be a symmetric copy of the successor.
+    */
+    OperatorProxy op = task_proxy.get_operators()[op_id];
+    if (convert_global_state(parent_state).get_successor(op) !=
+        convert_global_state(state)) {
+        return false;
+    }
+    int op_index = op.get_id();
+    for (size_t pos = 0; pos < parent_landmarks.size();
+         pos += 2 + parent_landmarks[pos + 1]) {
+        auto operators_begin = parent_landmarks.begin() + pos + 2;
+        auto operators_end = operators_begin + parent_landmarks[pos + 1];
+        if (!binary_search(operators_begin, operators_end, op_index)) {
+            state_landmarks.insert(
+                state_landmarks.end(), operators_begin - 2, operators_end);
+        }
+    }
+    state_landmarks.shrink_to_fit();
+    return false;
+}
+
+void CELandmarkCutHeuristic::print_statistics() const {
+    if (incremental) {
+        int64_t num_landmarks = num_inherited_landmarks + num_computed_landmarks;
+        cout << "Landmarks inherited from parent states: "
+             << num_inherited_landmarks << "/" << num_landmarks;
+        if (num_landmarks > 0) {
+            cout << " (" << 100.0 * num_inherited_landmarks / num_landmarks
+                 << "% of the cut computations saved)";
+        }
+        cout << endl;
+    }
+}
+
 static Heuristic *_parse(OptionParser &parser) {
     parser.document_synopsis("Landmark-cut heuristic", "");
     parser.document_language_support("action costs", "supported");
@@ -50,6 +158,14 @@ static Heuristic *_parse(OptionParser &parser) {
     parser.document_property("safe", "yes");
     parser.document_property("preferred operators", "no");
 
+    parser.add_option<bool>(
+        "incremental",
+        "Store the landmarks of all evaluated states and reuse the landmarks "
+        "of the parent state that remain landmarks in the successor state. "
+        "Only the remaining cuts are computed. This is faster, but needs "
+        "memory for the landmarks of every state, and the heuristic values "
+        "depend on the path on which a state is reached first.",
+        "false");
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
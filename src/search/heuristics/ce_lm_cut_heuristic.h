@@ -2,8 +2,11 @@
 #define HEURISTICS_CE_LM_CUT_HEURISTIC_H
 
 #include "../heuristic.h"
+#include "../per_state_information.h"
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 class GlobalState;
 
@@ -17,11 +20,31 @@ class CELandmarkCutLandmarks;
 class CELandmarkCutHeuristic : public Heuristic {
     std::unique_ptr<CELandmarkCutLandmarks> landmark_generator;
 
+    /*
+      In incremental mode, we store the landmarks of every evaluated state
+      in the format of CELandmarkCutLandmarks::compute_landmarks. When a
+      state is reached by an operator, all landmarks of its parent that do
+      not contain the operator are landmarks of the state as well. They
+      seed the computation for the state, so that only the remaining cuts
+      need to be found.
+    */
+    const bool incremental;
+    PerStateInformation<std::vector<int>> landmarks;
+    std::int64_t num_inherited_landmarks;
+    std::int64_t num_computed_landmarks;
+
     virtual int compute_heuristic(const GlobalState &global_state) override;
     int compute_heuristic(const State &state);
+    int compute_heuristic_incrementally(
+        const State &state, std::vector<int> &state_landmarks);
 public:
     explicit CELandmarkCutHeuristic(const options::Options &opts);
     virtual ~CELandmarkCutHeuristic() override;
+
+    virtual bool notify_state_transition(
+        const GlobalState &parent_state, OperatorID op_id,
+        const GlobalState &state) override;
+    virtual void print_statistics() const override;
 };
 }
 
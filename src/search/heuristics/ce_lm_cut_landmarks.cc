@@ -14,26 +14,70 @@ CELandmarkCutLandmarks::CELandmarkCutLandmarks(const TaskProxy &task_proxy) {
     task_properties::verify_no_axioms(task_proxy);
 
     // Build propositions.
-    num_propositions = 2; // artificial goal and artificial precondition
     VariablesProxy variables = task_proxy.get_variables();
-    propositions.resize(variables.size());
-    for (FactProxy fact : variables.get_facts()) {
-        int var_id = fact.get_variable().get_id();
-        propositions[var_id].push_back(RelaxedProposition());
-        ++num_propositions;
+    int num_facts = 0;
+    fact_offsets.reserve(variables.size());
+    for (VariableProxy var : variables) {
+        fact_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
     }
+    artificial_precondition = num_facts;
+    artificial_goal = num_facts + 1;
+    num_propositions = num_facts + 2;
+    propositions.resize(num_propositions);
 
     // Build relaxed operators for operators and axioms.
-    relaxed_operator_groups.reserve(task_proxy.get_operators().size() + 1);
-    for (OperatorProxy op : task_proxy.get_operators()) {
-        relaxed_operator_groups.push_back(RelaxedOperatorGroup(op.get_id(), op.get_cost()));
-    }
-    // Add group for artificial goal operator.
-    // This must be added before groups are used to keep pointers stable.
-    relaxed_operator_groups.push_back(RelaxedOperatorGroup(0, 0));
-    for (size_t i = 0; i < task_proxy.get_operators().size(); ++i) {
-        OperatorProxy op = task_proxy.get_operators()[i];
-        build_relaxed_operator(op, relaxed_operator_groups[i]);
+    OperatorsProxy operators = task_proxy.get_operators();
+    vector<vector<int>> operator_preconditions;
+    vector<vector<int>> operator_effects;
+    vector<int> operator_groups;
+    auto add_relaxed_operator =
+        [&](vector<int> &&precondition, vector<int> &&effects, int group) {
+            if (precondition.empty())
+                precondition.push_back(artificial_precondition);
+            operator_preconditions.push_back(move(precondition));
+            operator_effects.push_back(move(effects));
+            operator_groups.push_back(group);
+        };
+    relaxed_operator_groups.resize(operators.size() + 1);
+    for (OperatorProxy op : operators) {
+        int group = op.get_id();
+        original_op_ids.push_back(op.get_id());
+        base_costs.push_back(op.get_cost());
+        relaxed_operator_groups[group].operators_begin = operator_groups.size();
+
+        vector<int> precondition;
+        vector<int> effects;
+        for (FactProxy pre : op.get_preconditions()) {
+            precondition.push_back(get_proposition(pre));
+        }
+        for (EffectProxy eff : op.get_effects()) {
+            if (eff.get_conditions().empty()) {
+                effects.push_back(get_proposition(eff.get_fact()));
+            }
+        }
+        if (!effects.empty()) {
+            vector<int> precondition_copy(precondition);
+            add_relaxed_operator(
+                move(precondition_copy), move(effects), group);
+        }
+        for (EffectProxy eff : op.get_effects()) {
+            if (!eff.get_conditions().empty()) {
+                vector<int> cond_precondition(precondition);
+                for (FactProxy effect_cond : eff.get_conditions()) {
+                    cond_precondition.push_back(get_proposition(effect_cond));
+                }
+                // TODO: If it's worth grouping together effects that have no effect
+                // condition, then it's probably also worth otherwise grouping together
+                // effects that have the same effect condition. It would require copying
+                // the operator representation in some form and then sorting based on the
+                // preconditions.
+                add_relaxed_operator(
+                    move(cond_precondition),
+                    {get_proposition(eff.get_fact())}, group);
+            }
+        }
+        relaxed_operator_groups[group].operators_end = operator_groups.size();
     }
 
     // Simplify relaxed operators.
@@ -42,112 +86,77 @@ CELandmarkCutLandmarks::CELandmarkCutLandmarks(const TaskProxy &task_proxy) {
        but only after trying out whether and how much the change to
        unary operators hurts. */
 
-    // Build artificial goal proposition and operator.
-    vector<RelaxedProposition *> goal_op_pre, goal_op_eff;
+    // Build artificial goal operator in its own group.
+    int goal_group = operators.size();
+    original_op_ids.push_back(0);
+    base_costs.push_back(0);
+    relaxed_operator_groups[goal_group].operators_begin = operator_groups.size();
+    vector<int> goal_op_pre;
     for (FactProxy goal : task_proxy.get_goals()) {
         goal_op_pre.push_back(get_proposition(goal));
     }
-    goal_op_eff.push_back(&artificial_goal);
-    /* Use the invalid operator ID -1 so accessing
-       the artificial operator will generate an error. */
-//    add_relaxed_operator(move(goal_op_pre), move(goal_op_eff), -1, 0);
-    add_relaxed_operator(move(goal_op_pre), move(goal_op_eff),
-                         relaxed_operator_groups[task_proxy.get_operators().size()]);
+    add_relaxed_operator(move(goal_op_pre), {artificial_goal}, goal_group);
+    relaxed_operator_groups[goal_group].operators_end = operator_groups.size();
 
-    // Cross-reference relaxed operators.
     for (RelaxedOperatorGroup &group : relaxed_operator_groups) {
-        for (RelaxedOperator &op : group.relaxed_operators) {
-            for (RelaxedProposition *pre : op.preconditions)
-                pre->precondition_of.push_back(&op);
-            for (RelaxedProposition *eff : op.effects)
-                eff->effect_of.push_back(&op);
-        }
+        group.marked = false;
     }
-}
 
-CELandmarkCutLandmarks::~CELandmarkCutLandmarks() {
-}
+    preconditions = compressed_lists::CompressedLists(operator_preconditions);
+    effects = compressed_lists::CompressedLists(operator_effects);
 
-void CELandmarkCutLandmarks::build_relaxed_operator(
-    const OperatorProxy &op, RelaxedOperatorGroup &group) {
-    vector<RelaxedProposition *> precondition;
-    vector<RelaxedProposition *> effects;
-    for (FactProxy pre : op.get_preconditions()) {
-        precondition.push_back(get_proposition(pre));
-    }
-    for (EffectProxy eff : op.get_effects()) {
-        if (eff.get_conditions().empty()) {
-            effects.push_back(get_proposition(eff.get_fact()));
-        }
-    }
-    if (!effects.empty()) {
-        vector<RelaxedProposition *> precondition_copy(precondition);
-        add_relaxed_operator(
-            move(precondition_copy), move(effects), group);
+    // Cross-reference relaxed operators.
+    precondition_of = preconditions.invert(num_propositions);
+    effect_of = effects.invert(num_propositions);
+
+    int num_relaxed_operators = operator_groups.size();
+    relaxed_operators.resize(num_relaxed_operators);
+    h_max_supporters.resize(num_relaxed_operators, -1);
+    for (int op_id = 0; op_id < num_relaxed_operators; ++op_id) {
+        RelaxedOperator &op = relaxed_operators[op_id];
+        op.group = operator_groups[op_id];
+        op.preconditions_begin = preconditions.get_begin(op_id);
+        op.preconditions_end = preconditions.get_end(op_id);
+        op.effects_begin = effects.get_begin(op_id);
+        op.effects_end = effects.get_end(op_id);
     }
-    for (EffectProxy eff : op.get_effects()) {
-        if (!eff.get_conditions().empty()) {
-            vector<RelaxedProposition *> cond_precondition(precondition);
-            vector<RelaxedProposition *> cond_effects;
-            for (FactProxy effect_cond : eff.get_conditions()) {
-                cond_precondition.push_back(get_proposition(effect_cond));
-            }
-            cond_effects.push_back(get_proposition(eff.get_fact()));
-            // TODO: If it's worth grouping together effects that have no effect
-            // condition, then it's probably also worth otherwise grouping together
-            // effects that have the same effect condition. It would require copying
-            // the operator representation in some form and then sorting based on the
-            // preconditions.
-            add_relaxed_operator(move(cond_precondition), move(cond_effects), group);
-        }
+    for (int prop_id = 0; prop_id < num_propositions; ++prop_id) {
+        RelaxedProposition &prop = propositions[prop_id];
+        prop.precondition_of_begin = precondition_of.get_begin(prop_id);
+        prop.precondition_of_end = precondition_of.get_end(prop_id);
     }
 }
 
-void CELandmarkCutLandmarks::add_relaxed_operator(
-    vector<RelaxedProposition *> &&precondition,
-    vector<RelaxedProposition *> &&effects,
-    RelaxedOperatorGroup &group) {
-    RelaxedOperator relaxed_op(
-        move(precondition), move(effects), &group);
-    if (relaxed_op.preconditions.empty())
-        relaxed_op.preconditions.push_back(&artificial_precondition);
-    group.relaxed_operators.push_back(relaxed_op);
+CELandmarkCutLandmarks::~CELandmarkCutLandmarks() {
 }
 
-RelaxedProposition *CELandmarkCutLandmarks::get_proposition(
-    const FactProxy &fact) {
+int CELandmarkCutLandmarks::get_proposition(const FactProxy &fact) const {
     int var_id = fact.get_variable().get_id();
     int val = fact.get_value();
-    return &propositions[var_id][val];
+    return fact_offsets[var_id] + val;
 }
 
 // heuristic computation
 void CELandmarkCutLandmarks::setup_exploration_queue() {
     priority_queue.clear();
 
-    for (auto &var_props : propositions) {
-        for (RelaxedProposition &prop : var_props) {
-            prop.status = UNREACHED;
-        }
+    for (RelaxedProposition &prop : propositions) {
+        prop.status = UNREACHED;
     }
 
-    artificial_goal.status = UNREACHED;
-    artificial_precondition.status = UNREACHED;
-
-    for (RelaxedOperatorGroup &group : relaxed_operator_groups) {
-        for (RelaxedOperator &op : group.relaxed_operators) {
-            op.unsatisfied_preconditions = op.preconditions.size();
-            op.h_max_supporter = 0;
-            op.h_max_supporter_cost = numeric_limits<int>::max();
-        }
+    for (RelaxedOperator &op : relaxed_operators) {
+        op.unsatisfied_preconditions =
+            op.preconditions_end - op.preconditions_begin;
+        op.h_max_supporter_cost = numeric_limits<int>::max();
     }
+    fill(h_max_supporters.begin(), h_max_supporters.end(), -1);
 }
 
 void CELandmarkCutLandmarks::setup_exploration_queue_state(const State &state) {
     for (FactProxy init_fact : state) {
         enqueue_if_necessary(get_proposition(init_fact), 0);
     }
-    enqueue_if_necessary(&artificial_precondition, 0);
+    enqueue_if_necessary(artificial_precondition, 0);
 }
 
 void CELandmarkCutLandmarks::first_exploration(const State &state) {
@@ -155,23 +164,23 @@ void CELandmarkCutLandmarks::first_exploration(const State &state) {
     setup_exploration_queue();
     setup_exploration_queue_state(state);
     while (!priority_queue.empty()) {
-        pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
+        pair<int, int> top_pair = priority_queue.pop();
         int popped_cost = top_pair.first;
-        RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        int prop_id = top_pair.second;
+        const RelaxedProposition &prop = propositions[prop_id];
+        int prop_cost = prop.h_max_cost;
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            --relaxed_op->unsatisfied_preconditions;
-            assert(relaxed_op->unsatisfied_preconditions >= 0);
-            if (relaxed_op->unsatisfied_preconditions == 0) {
-                relaxed_op->h_max_supporter = prop;
-                relaxed_op->h_max_supporter_cost = prop_cost;
-                int target_cost = prop_cost + relaxed_op->group->cost;
-                for (RelaxedProposition *effect : relaxed_op->effects) {
+        for (int op_id : get_precondition_of(prop)) {
+            RelaxedOperator &relaxed_op = relaxed_operators[op_id];
+            --relaxed_op.unsatisfied_preconditions;
+            assert(relaxed_op.unsatisfied_preconditions >= 0);
+            if (relaxed_op.unsatisfied_preconditions == 0) {
+                h_max_supporters[op_id] = prop_id;
+                relaxed_op.h_max_supporter_cost = prop_cost;
+                int target_cost = prop_cost + get_cost(relaxed_op);
+                for (int effect : get_effects(relaxed_op)) {
                     enqueue_if_necessary(effect, target_cost);
                 }
             }
@@ -179,8 +188,7 @@ void CELandmarkCutLandmarks::first_exploration(const State &state) {
     }
 }
 
-void CELandmarkCutLandmarks::first_exploration_incremental(
-    vector<RelaxedOperator *> &cut) {
+void CELandmarkCutLandmarks::first_exploration_incremental(vector<int> &cut) {
     assert(priority_queue.empty());
     /* We pretend that this queue has had as many pushes already as we
        have propositions to avoid switching from bucket-based to
@@ -188,38 +196,40 @@ void CELandmarkCutLandmarks::first_exploration_incremental(
        to heap-based in problems where action costs are at most 1.
     */
     priority_queue.add_virtual_pushes(num_propositions);
-    for (RelaxedOperator *cut_op : cut) {
-        RelaxedOperatorGroup *group = cut_op->group;
-        assert(group);
-        for (RelaxedOperator &op : group->relaxed_operators) {
-            if (op.h_max_supporter) {
-                int cost = op.h_max_supporter_cost + group->cost;
-                for (RelaxedProposition *effect : op.effects)
+    for (int cut_op_id : cut) {
+        const RelaxedOperatorGroup &group =
+            relaxed_operator_groups[relaxed_operators[cut_op_id].group];
+        for (int op_id = group.operators_begin; op_id < group.operators_end;
+             ++op_id) {
+            const RelaxedOperator &relaxed_op = relaxed_operators[op_id];
+            if (h_max_supporters[op_id] != -1) {
+                int cost = relaxed_op.h_max_supporter_cost + group.cost;
+                for (int effect : get_effects(relaxed_op))
                     enqueue_if_necessary(effect, cost);
             }
         }
     }
     while (!priority_queue.empty()) {
-        pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
+        pair<int, int> top_pair = priority_queue.pop();
         int popped_cost = top_pair.first;
-        RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        int prop_id = top_pair.second;
+        const RelaxedProposition &prop = propositions[prop_id];
+        int prop_cost = prop.h_max_cost;
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            if (relaxed_op->h_max_supporter == prop) {
-                int old_supp_cost = relaxed_op->h_max_supporter_cost;
+        for (int op_id : get_precondition_of(prop)) {
+            if (h_max_supporters[op_id] == prop_id) {
+                RelaxedOperator &relaxed_op = relaxed_operators[op_id];
+                int old_supp_cost = relaxed_op.h_max_supporter_cost;
                 if (old_supp_cost > prop_cost) {
-                    relaxed_op->update_h_max_supporter();
-                    int new_supp_cost = relaxed_op->h_max_supporter_cost;
+                    update_h_max_supporter(op_id);
+                    int new_supp_cost = relaxed_op.h_max_supporter_cost;
                     if (new_supp_cost != old_supp_cost) {
                         // This operator has become cheaper.
                         assert(new_supp_cost < old_supp_cost);
-                        int target_cost = new_supp_cost + relaxed_op->group->cost;
-                        for (RelaxedProposition *effect : relaxed_op->effects)
+                        int target_cost = new_supp_cost + get_cost(relaxed_op);
+                        for (int effect : get_effects(relaxed_op))
                             enqueue_if_necessary(effect, target_cost);
                     }
                 }
@@ -229,41 +239,41 @@ void CELandmarkCutLandmarks::first_exploration_incremental(
 }
 
 void CELandmarkCutLandmarks::second_exploration(
-    const State &state, vector<RelaxedProposition *> &second_exploration_queue,
-    vector<RelaxedOperator *> &cut) {
+    const State &state, vector<int> &second_exploration_queue,
+    vector<int> &cut) {
     assert(second_exploration_queue.empty());
     assert(cut.empty());
 
-    artificial_precondition.status = BEFORE_GOAL_ZONE;
-    second_exploration_queue.push_back(&artificial_precondition);
+    propositions[artificial_precondition].status = BEFORE_GOAL_ZONE;
+    second_exploration_queue.push_back(artificial_precondition);
 
     for (FactProxy init_fact : state) {
-        RelaxedProposition *init_prop = get_proposition(init_fact);
-        init_prop->status = BEFORE_GOAL_ZONE;
+        int init_prop = get_proposition(init_fact);
+        propositions[init_prop].status = BEFORE_GOAL_ZONE;
         second_exploration_queue.push_back(init_prop);
     }
 
     while (!second_exploration_queue.empty()) {
-        RelaxedProposition *prop = second_exploration_queue.back();
+        int prop_id = second_exploration_queue.back();
         second_exploration_queue.pop_back();
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            if (relaxed_op->h_max_supporter == prop) {
+        for (int op_id : get_precondition_of(propositions[prop_id])) {
+            if (h_max_supporters[op_id] == prop_id) {
+                const RelaxedOperator &relaxed_op = relaxed_operators[op_id];
                 bool reached_goal_zone = false;
-                for (RelaxedProposition *effect : relaxed_op->effects) {
-                    if (effect->status == GOAL_ZONE) {
-                        assert(relaxed_op->group->cost > 0);
+                for (int effect : get_effects(relaxed_op)) {
+                    if (propositions[effect].status == GOAL_ZONE) {
+                        assert(get_cost(relaxed_op) > 0);
                         reached_goal_zone = true;
-                        cut.push_back(relaxed_op);
+                        cut.push_back(op_id);
                         break;
                     }
                 }
                 if (!reached_goal_zone) {
-                    for (RelaxedProposition *effect : relaxed_op->effects) {
-                        if (effect->status != BEFORE_GOAL_ZONE) {
-                            assert(effect->status == REACHED);
-                            effect->status = BEFORE_GOAL_ZONE;
+                    for (int effect : get_effects(relaxed_op)) {
+                        RelaxedProposition &effect_prop = propositions[effect];
+                        if (effect_prop.status != BEFORE_GOAL_ZONE) {
+                            assert(effect_prop.status == REACHED);
+                            effect_prop.status = BEFORE_GOAL_ZONE;
                             second_exploration_queue.push_back(effect);
                         }
                     }
@@ -273,16 +283,18 @@ void CELandmarkCutLandmarks::second_exploration(
     }
 }
 
-void CELandmarkCutLandmarks::mark_goal_plateau(RelaxedProposition *subgoal) {
-    // NOTE: subgoal can be null if we got here via recursion through
+void CELandmarkCutLandmarks::mark_goal_plateau(int subgoal) {
+    // NOTE: subgoal can be -1 if we got here via recursion through
     // a zero-cost action that is relaxed unreachable. (This can only
     // happen in domains which have zero-cost actions to start with.)
     // For example, this happens in pegsol-strips #01.
-    if (subgoal && subgoal->status != GOAL_ZONE) {
-        subgoal->status = GOAL_ZONE;
-        for (RelaxedOperator *achiever : subgoal->effect_of)
-            if (achiever->group->cost == 0)
-                mark_goal_plateau(achiever->h_max_supporter);
+    if (subgoal != -1 && propositions[subgoal].status != GOAL_ZONE) {
+        propositions[subgoal].status = GOAL_ZONE;
+        for (int achiever : effect_of[subgoal]) {
+            const RelaxedOperator &relaxed_op = relaxed_operators[achiever];
+            if (get_cost(relaxed_op) == 0)
+                mark_goal_plateau(h_max_supporters[achiever]);
+        }
     }
 }
 
@@ -291,27 +303,28 @@ void CELandmarkCutLandmarks::validate_h_max() const {
     // Using conditional compilation to avoid complaints about unused
     // variables when using NDEBUG. This whole code does nothing useful
     // when assertions are switched off anyway.
-    for (const RelaxedOperatorGroup &group : relaxed_operator_groups) {
-        for (const RelaxedOperator &op : group.relaxed_operators) {
-            if (op.unsatisfied_preconditions) {
-                bool reachable = true;
-                for (RelaxedProposition *pre : op.preconditions) {
-                    if (pre->status == UNREACHED) {
-                        reachable = false;
-                        break;
-                    }
-                }
-                assert(!reachable);
-                assert(!op.h_max_supporter);
-            } else {
-                assert(op.h_max_supporter);
-                int h_max_cost = op.h_max_supporter_cost;
-                assert(h_max_cost == op.h_max_supporter->h_max_cost);
-                for (RelaxedProposition *pre : op.preconditions) {
-                    assert(pre->status != UNREACHED);
-                    assert(pre->h_max_cost <= h_max_cost);
+    int num_relaxed_operators = relaxed_operators.size();
+    for (int op_id = 0; op_id < num_relaxed_operators; ++op_id) {
+        const RelaxedOperator &op = relaxed_operators[op_id];
+        int h_max_supporter = h_max_supporters[op_id];
+        if (op.unsatisfied_preconditions) {
+            bool reachable = true;
+            for (int pre : get_preconditions(op)) {
+                if (propositions[pre].status == UNREACHED) {
+                    reachable = false;
+                    break;
                 }
             }
+            assert(!reachable);
+            assert(h_max_supporter == -1);
+        } else {
+            assert(h_max_supporter != -1);
+            int h_max_cost = op.h_max_supporter_cost;
+            assert(h_max_cost == propositions[h_max_supporter].h_max_cost);
+            for (int pre : get_preconditions(op)) {
+                assert(propositions[pre].status != UNREACHED);
+                assert(propositions[pre].h_max_cost <= h_max_cost);
+            }
         }
     }
 #endif
@@ -319,43 +332,58 @@ void CELandmarkCutLandmarks::validate_h_max() const {
 
 bool CELandmarkCutLandmarks::compute_landmarks(
     State state, CostCallback cost_callback,
-    LandmarkCallback landmark_callback) {
-    for (RelaxedOperatorGroup &group : relaxed_operator_groups) {
-        group.cost = group.base_cost;
+    LandmarkCallback landmark_callback,
+    const vector<int> *known_landmarks) {
+    int num_groups = relaxed_operator_groups.size();
+    for (int group_id = 0; group_id < num_groups; ++group_id) {
+        relaxed_operator_groups[group_id].cost = base_costs[group_id];
+    }
+    if (known_landmarks) {
+        // Relaxed operator groups have the IDs of their original operators.
+        auto it = known_landmarks->begin();
+        while (it != known_landmarks->end()) {
+            int cost = *it++;
+            int num_operators = *it++;
+            for (int i = 0; i < num_operators; ++i) {
+                RelaxedOperatorGroup &group = relaxed_operator_groups[*it++];
+                group.cost -= cost;
+                assert(group.cost >= 0);
+            }
+        }
     }
     // The following three variables could be declared inside the loop
     // ("second_exploration_queue" even inside second_exploration),
     // but having them here saves reallocations and hence provides a
     // measurable speed boost.
-    vector<RelaxedOperator *> cut;
+    vector<int> cut;
     Landmark landmark;
-    vector<RelaxedProposition *> second_exploration_queue;
+    vector<int> second_exploration_queue;
     first_exploration(state);
     // validate_h_max();  // too expensive to use even in regular debug mode
-    if (artificial_goal.status == UNREACHED)
+    if (propositions[artificial_goal].status == UNREACHED)
         return true;
 
     int num_iterations = 0;
-    while (artificial_goal.h_max_cost != 0) {
+    while (propositions[artificial_goal].h_max_cost != 0) {
         ++num_iterations;
-        mark_goal_plateau(&artificial_goal);
+        mark_goal_plateau(artificial_goal);
         assert(cut.empty());
         second_exploration(state, second_exploration_queue, cut);
         assert(!cut.empty());
         int cut_cost = numeric_limits<int>::max();
-        for (RelaxedOperator *op : cut)
-            cut_cost = min(cut_cost, op->group->cost);
-
-        for (RelaxedOperator *cut_op : cut) {
-            RelaxedOperatorGroup *group = cut_op->group;
-            assert(group);
-            if (!group->marked) {
-                group->cost -= cut_cost;
-                group->marked = true;
+        for (int op_id : cut)
+            cut_cost = min(cut_cost, get_cost(relaxed_operators[op_id]));
+
+        for (int op_id : cut) {
+            RelaxedOperatorGroup &group =
+                relaxed_operator_groups[relaxed_operators[op_id].group];
+            if (!group.marked) {
+                group.cost -= cut_cost;
+                group.marked = true;
             }
         }
-        for (RelaxedOperator *cut_op : cut) {
-            cut_op->group->marked = false;
+        for (int op_id : cut) {
+            relaxed_operator_groups[relaxed_operators[op_id].group].marked = false;
         }
 
         if (cost_callback) {
@@ -363,9 +391,9 @@ bool CELandmarkCutLandmarks::compute_landmarks(
         }
         if (landmark_callback) {
             landmark.clear();
-            for (RelaxedOperator *cut_op : cut) {
-                RelaxedOperatorGroup *group = cut_op->group;
-                landmark.push_back(group->original_op_id);
+            for (int op_id : cut) {
+                landmark.push_back(
+                    original_op_ids[relaxed_operators[op_id].group]);
             }
             landmark_callback(landmark, cut_cost);
         }
@@ -380,14 +408,10 @@ bool CELandmarkCutLandmarks::compute_landmarks(
           or something based on total_cost, so that we don't need a per-round
           reinitialization.
         */
-        for (auto &var_props : propositions) {
-            for (RelaxedProposition &prop : var_props) {
-                if (prop.status == GOAL_ZONE || prop.status == BEFORE_GOAL_ZONE)
-                    prop.status = REACHED;
-            }
+        for (RelaxedProposition &prop : propositions) {
+            if (prop.status == GOAL_ZONE || prop.status == BEFORE_GOAL_ZONE)
+                prop.status = REACHED;
         }
-        artificial_goal.status = REACHED;
-        artificial_precondition.status = REACHED;
     }
     return false;
 }
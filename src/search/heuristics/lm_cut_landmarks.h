@@ -3,6 +3,7 @@
 
 #include "../task_proxy.h"
 
+#include "../algorithms/compressed_lists.h"
 #include "../algorithms/priority_queues.h"
 
 #include <cassert>
@@ -12,8 +13,6 @@
 
 namespace lm_cut_heuristic {
 // TODO: Fix duplication with the other relaxation heuristics.
-struct RelaxedProposition;
-
 enum PropositionStatus {
     UNREACHED = 0,
     REACHED = 1,
@@ -21,65 +20,113 @@ enum PropositionStatus {
     BEFORE_GOAL_ZONE = 3
 };
 
+/*
+  The relaxed task is stored in flat arrays. Propositions and relaxed
+  operators are identified by consecutive IDs and described by small
+  records. The preconditions and effects of operators and their
+  inverses are stored as compressed lists of IDs. The records contain
+  the positions of the lists that the explorations access, so that a
+  single cache line holds everything needed to process an operator or
+  proposition.
+*/
 struct RelaxedOperator {
-    int original_op_id;
-    std::vector<RelaxedProposition *> preconditions;
-    std::vector<RelaxedProposition *> effects;
-    int base_cost; // 0 for axioms, 1 for regular operators
-
     int cost;
     int unsatisfied_preconditions;
     int h_max_supporter_cost; // h_max_cost of h_max_supporter
-    RelaxedProposition *h_max_supporter;
-    RelaxedOperator(std::vector<RelaxedProposition *> &&pre,
-                    std::vector<RelaxedProposition *> &&eff,
-                    int op_id, int base)
-        : original_op_id(op_id), preconditions(pre), effects(eff), base_cost(base) {
-    }
-
-    inline void update_h_max_supporter();
+    int preconditions_begin;
+    int preconditions_end;
+    int effects_begin;
+    int effects_end;
 };
 
 struct RelaxedProposition {
-    std::vector<RelaxedOperator *> precondition_of;
-    std::vector<RelaxedOperator *> effect_of;
-
-    PropositionStatus status;
     int h_max_cost;
+    PropositionStatus status;
+    int precondition_of_begin;
+    int precondition_of_end;
 };
 
 class LandmarkCutLandmarks {
-    std::vector<RelaxedOperator> relaxed_operators;
-    std::vector<std::vector<RelaxedProposition>> propositions;
-    RelaxedProposition artificial_precondition;
-    RelaxedProposition artificial_goal;
+    using Range = compressed_lists::CompressedLists::Range;
+
+    /*
+      The propositions of variable var have the IDs fact_offsets[var] +
+      value. They are followed by the artificial precondition and the
+      artificial goal. The artificial goal operator has the highest
+      operator ID.
+    */
+    std::vector<int> fact_offsets;
+    int artificial_precondition;
+    int artificial_goal;
     int num_propositions;
-    priority_queues::AdaptiveQueue<RelaxedProposition *> priority_queue;
-
-    void initialize();
-    void build_relaxed_operator(const OperatorProxy &op);
-    void add_relaxed_operator(std::vector<RelaxedProposition *> &&precondition,
-                              std::vector<RelaxedProposition *> &&effects,
-                              int op_id, int base_cost);
-    RelaxedProposition *get_proposition(const FactProxy &fact);
+
+    std::vector<RelaxedOperator> relaxed_operators;
+    /*
+      The h_max supporters of the relaxed operators (-1 if the operator is
+      unreached). The second exploration scans the operators triggered by
+      a proposition for the ones it supports, so we keep them in a dense
+      array of their own.
+    */
+    std::vector<int> h_max_supporters;
+    std::vector<int> original_op_ids;
+    std::vector<int> base_costs; // 0 for axioms, 1 for regular operators
+    compressed_lists::CompressedLists preconditions;
+    compressed_lists::CompressedLists effects;
+
+    std::vector<RelaxedProposition> propositions;
+    compressed_lists::CompressedLists precondition_of;
+    compressed_lists::CompressedLists effect_of;
+
+    priority_queues::AdaptiveQueue<int> priority_queue;
+
+    Range get_preconditions(const RelaxedOperator &op) const {
+        return preconditions.get_range(
+            op.preconditions_begin, op.preconditions_end);
+    }
+
+    Range get_effects(const RelaxedOperator &op) const {
+        return effects.get_range(op.effects_begin, op.effects_end);
+    }
+
+    Range get_precondition_of(const RelaxedProposition &prop) const {
+        return precondition_of.get_range(
+            prop.precondition_of_begin, prop.precondition_of_end);
+    }
+
+    int get_proposition(const FactProxy &fact) const;
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void first_exploration(const State &state);
-    void first_exploration_incremental(std::vector<RelaxedOperator *> &cut);
+    void first_exploration_incremental(std::vector<int> &cut);
     void second_exploration(const State &state,
-                            std::vector<RelaxedProposition *> &queue,
-                            std::vector<RelaxedOperator *> &cut);
+                            std::vector<int> &queue,
+                            std::vector<int> &cut);
 
-    void enqueue_if_necessary(RelaxedProposition *prop, int cost) {
+    void enqueue_if_necessary(int prop_id, int cost) {
         assert(cost >= 0);
-        if (prop->status == UNREACHED || prop->h_max_cost > cost) {
-            prop->status = REACHED;
-            prop->h_max_cost = cost;
-            priority_queue.push(cost, prop);
+        RelaxedProposition &prop = propositions[prop_id];
+        if (prop.status == UNREACHED || prop.h_max_cost > cost) {
+            prop.status = REACHED;
+            prop.h_max_cost = cost;
+            priority_queue.push(cost, prop_id);
         }
     }
 
-    void mark_goal_plateau(RelaxedProposition *subgoal);
+    void update_h_max_supporter(int op_id) {
+        RelaxedOperator &op = relaxed_operators[op_id];
+        assert(!op.unsatisfied_preconditions);
+        int &supporter = h_max_supporters[op_id];
+        int supporter_cost = propositions[supporter].h_max_cost;
+        for (int pre : get_preconditions(op)) {
+            if (propositions[pre].h_max_cost > supporter_cost) {
+                supporter = pre;
+                supporter_cost = propositions[pre].h_max_cost;
+            }
+        }
+        op.h_max_supporter_cost = supporter_cost;
+    }
+
+    void mark_goal_plateau(int subgoal);
     void validate_h_max() const;
 public:
     using Landmark = std::vector<int>;
@@ -105,14 +152,6 @@ public:
     bool compute_landmarks(State state, CostCallback cost_callback,
                            LandmarkCallback landmark_callback);
 };
-
-inline void RelaxedOperator::update_h_max_supporter() {
-    assert(!unsatisfied_preconditions);
-    for (size_t i = 0; i < preconditions.size(); ++i)
-        if (preconditions[i]->h_max_cost > h_max_supporter->h_max_cost)
-            h_max_supporter = preconditions[i];
-    h_max_supporter_cost = h_max_supporter->h_max_cost;
-}
 }
 
 #endif
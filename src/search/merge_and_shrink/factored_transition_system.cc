@@ -49,6 +49,7 @@ FactoredTransitionSystem::FactoredTransitionSystem(
       transition_systems(move(transition_systems)),
       mas_representations(move(mas_representations)),
       distances(move(distances)),
+      versions(this->transition_systems.size(), 0),
       compute_init_distances(compute_init_distances),
       compute_goal_distances(compute_goal_distances),
       num_active_entries(this->transition_systems.size()) {
@@ -67,6 +68,7 @@ FactoredTransitionSystem::FactoredTransitionSystem(FactoredTransitionSystem &&ot
       transition_systems(move(other.transition_systems)),
       mas_representations(move(other.mas_representations)),
       distances(move(other.distances)),
+      versions(move(other.versions)),
       compute_init_distances(move(other.compute_init_distances)),
       compute_goal_distances(move(other.compute_goal_distances)),
       num_active_entries(move(other.num_active_entries)) {
@@ -109,6 +111,7 @@ bool FactoredTransitionSystem::apply_abstraction(
     }
     mas_representations[index]->apply_abstraction_to_lookup_table(
         abstraction_mapping);
+    ++versions[index];
 
     /* If distances need to be recomputed, this already happened in the
        Distances object. */
@@ -158,6 +161,7 @@ void FactoredTransitionSystem::apply_label_mapping(
         if (transition_systems[i]) {
             transition_systems[i]->apply_label_reduction(
                 label_mapping, static_cast<int>(i) != combinable_index);
+            ++versions[i];
         }
     }
     assert_all_components_valid();
@@ -215,6 +219,7 @@ int FactoredTransitionSystem::merge(
     }
     const TransitionSystem &new_ts = *transition_systems.back();
     distances.push_back(utils::make_unique_ptr<Distances>(new_ts));
+    versions.push_back(0);
     int new_index = transition_systems.size() - 1;
     // Restore the invariant that distances are computed.
     if (compute_init_distances || compute_goal_distances) {
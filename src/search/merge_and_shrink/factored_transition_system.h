@@ -50,6 +50,11 @@ class FactoredTransitionSystem {
     std::vector<std::unique_ptr<TransitionSystem>> transition_systems;
     std::vector<std::unique_ptr<MergeAndShrinkRepresentation>> mas_representations;
     std::vector<std::unique_ptr<Distances>> distances;
+    /*
+      Number of transformations (shrinking, pruning, label reduction) that
+      changed each factor so far.
+    */
+    std::vector<int> versions;
     const bool compute_init_distances;
     const bool compute_goal_distances;
     int num_active_entries;
@@ -170,6 +175,16 @@ public:
     }
 
     bool is_active(int index) const;
+
+    /*
+      Indices are never reused, so a factor did not change between two
+      calls iff the calls return the same version. Used by
+      MergeScoringFunctionMIASM to reuse scores of unchanged factors.
+    */
+    int get_version(int index) const {
+        return versions[index];
+    }
+
     int get_init_state_goal_distance(int index) const;
     void remove(int index);
 };
@@ -16,6 +16,7 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../task_utils/precomputation_cache.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
@@ -71,7 +72,21 @@ MergeAndShrinkHeuristic::MergeAndShrinkHeuristic(const Options &opts)
     warn_on_unusual_options();
     cout << endl;
 
-    build(timer);
+    unique_ptr<search_checkpoint::CheckpointReader> reader =
+        precomputation_cache::open_entry(
+            "mas", task_proxy, opts.get_unparsed_config());
+    if (reader) {
+        mas_representation = MergeAndShrinkRepresentation::load(*reader);
+    } else {
+        build(timer);
+        unique_ptr<search_checkpoint::CheckpointWriter> writer =
+            precomputation_cache::create_entry(
+                "mas", task_proxy, opts.get_unparsed_config());
+        if (writer) {
+            mas_representation->save(*writer);
+            writer->commit();
+        }
+    }
     const bool final = true;
     report_peak_memory_delta(final);
     cout << "Done initializing merge-and-shrink heuristic [" << timer << "]"
@@ -5,6 +5,7 @@
 
 #include "../task_proxy.h"
 
+#include "../search_engines/search_checkpoint.h"
 #include "../utils/memory.h"
 
 #include <algorithm>
@@ -26,6 +27,26 @@ int MergeAndShrinkRepresentation::get_domain_size() const {
     return domain_size;
 }
 
+unique_ptr<MergeAndShrinkRepresentation> MergeAndShrinkRepresentation::load(
+    search_checkpoint::CheckpointReader &reader) {
+    int var_id = reader.read_value<int>();
+    int domain_size = reader.read_value<int>();
+    if (var_id != -1) {
+        return utils::make_unique_ptr<MergeAndShrinkRepresentationLeaf>(
+            var_id, domain_size, reader.read_vector<int>());
+    }
+    unique_ptr<MergeAndShrinkRepresentation> left_child = load(reader);
+    unique_ptr<MergeAndShrinkRepresentation> right_child = load(reader);
+    int num_rows = reader.read_value<int>();
+    vector<vector<int>> lookup_table;
+    lookup_table.reserve(num_rows);
+    for (int row = 0; row < num_rows; ++row) {
+        lookup_table.push_back(reader.read_vector<int>());
+    }
+    return utils::make_unique_ptr<MergeAndShrinkRepresentationMerge>(
+        move(left_child), move(right_child), domain_size, move(lookup_table));
+}
+
 
 MergeAndShrinkRepresentationLeaf::MergeAndShrinkRepresentationLeaf(
     int var_id, int domain_size)
@@ -35,6 +56,13 @@ MergeAndShrinkRepresentationLeaf::MergeAndShrinkRepresentationLeaf(
     iota(lookup_table.begin(), lookup_table.end(), 0);
 }
 
+MergeAndShrinkRepresentationLeaf::MergeAndShrinkRepresentationLeaf(
+    int var_id, int domain_size, vector<int> &&lookup_table)
+    : MergeAndShrinkRepresentation(domain_size),
+      var_id(var_id),
+      lookup_table(move(lookup_table)) {
+}
+
 MergeAndShrinkRepresentationLeaf::MergeAndShrinkRepresentationLeaf(const MergeAndShrinkRepresentationLeaf *other)
     : MergeAndShrinkRepresentation(other->domain_size),
       var_id(other->var_id),
@@ -76,6 +104,13 @@ void MergeAndShrinkRepresentationLeaf::dump() const {
     cout << endl;
 }
 
+void MergeAndShrinkRepresentationLeaf::save(
+    search_checkpoint::CheckpointWriter &writer) const {
+    writer.write_value(var_id);
+    writer.write_value(domain_size);
+    writer.write_vector(lookup_table);
+}
+
 
 MergeAndShrinkRepresentationMerge::MergeAndShrinkRepresentationMerge(
     unique_ptr<MergeAndShrinkRepresentation> left_child_,
@@ -95,6 +130,16 @@ MergeAndShrinkRepresentationMerge::MergeAndShrinkRepresentationMerge(
     }
 }
 
+MergeAndShrinkRepresentationMerge::MergeAndShrinkRepresentationMerge(
+    unique_ptr<MergeAndShrinkRepresentation> left_child_,
+    unique_ptr<MergeAndShrinkRepresentation> right_child_,
+    int domain_size, vector<vector<int>> &&lookup_table)
+    : MergeAndShrinkRepresentation(domain_size),
+      left_child(move(left_child_)),
+      right_child(move(right_child_)),
+      lookup_table(move(lookup_table)) {
+}
+
 void MergeAndShrinkRepresentationMerge::set_distances(
     const Distances &distances) {
     assert(distances.are_goal_distances_computed());
@@ -164,4 +209,17 @@ void MergeAndShrinkRepresentationMerge::dump() const {
     cout << "dump right child:" << endl;
     right_child->dump();
 }
+
+void MergeAndShrinkRepresentationMerge::save(
+    search_checkpoint::CheckpointWriter &writer) const {
+    // Merge nodes are marked by the variable -1.
+    writer.write_value(-1);
+    writer.write_value(domain_size);
+    left_child->save(writer);
+    right_child->save(writer);
+    writer.write_value(static_cast<int>(lookup_table.size()));
+    for (const vector<int> &row : lookup_table) {
+        writer.write_vector(row);
+    }
+}
 }
@@ -7,6 +7,11 @@
 
 class State;
 
+namespace search_checkpoint {
+class CheckpointReader;
+class CheckpointWriter;
+}
+
 namespace merge_and_shrink {
 class Distances;
 class MergeAndShrinkRepresentation {
@@ -28,6 +33,12 @@ public:
         const std::vector<int> &abstraction_mapping) = 0;
     virtual bool operator==(const MergeAndShrinkRepresentation &other) const = 0;
     virtual void dump() const = 0;
+
+    // Write the representation with its children (in preorder).
+    virtual void save(search_checkpoint::CheckpointWriter &writer) const = 0;
+    // Read a representation written by save.
+    static std::unique_ptr<MergeAndShrinkRepresentation> load(
+        search_checkpoint::CheckpointReader &reader);
 };
 
 
@@ -37,6 +48,8 @@ class MergeAndShrinkRepresentationLeaf : public MergeAndShrinkRepresentation {
     std::vector<int> lookup_table;
 public:
     MergeAndShrinkRepresentationLeaf(int var_id, int domain_size);
+    MergeAndShrinkRepresentationLeaf(
+        int var_id, int domain_size, std::vector<int> &&lookup_table);
     explicit MergeAndShrinkRepresentationLeaf(const MergeAndShrinkRepresentationLeaf *other);
     virtual ~MergeAndShrinkRepresentationLeaf() = default;
 
@@ -57,6 +70,7 @@ public:
         }
     }
     virtual void dump() const override;
+    virtual void save(search_checkpoint::CheckpointWriter &writer) const override;
 };
 
 
@@ -68,6 +82,10 @@ public:
     MergeAndShrinkRepresentationMerge(
         std::unique_ptr<MergeAndShrinkRepresentation> left_child,
         std::unique_ptr<MergeAndShrinkRepresentation> right_child);
+    MergeAndShrinkRepresentationMerge(
+        std::unique_ptr<MergeAndShrinkRepresentation> left_child,
+        std::unique_ptr<MergeAndShrinkRepresentation> right_child,
+        int domain_size, std::vector<std::vector<int>> &&lookup_table);
     explicit MergeAndShrinkRepresentationMerge(const MergeAndShrinkRepresentationMerge *other);
     virtual ~MergeAndShrinkRepresentationMerge() = default;
 
@@ -89,6 +107,7 @@ public:
         }
     }
     virtual void dump() const override;
+    virtual void save(search_checkpoint::CheckpointWriter &writer) const override;
 };
 }
 
@@ -12,6 +12,10 @@
 #include "../options/plugin.h"
 
 #include "../utils/markup.h"
+#include "../utils/parallel.h"
+
+#include <algorithm>
+#include <iostream>
 
 using namespace std;
 
@@ -21,56 +25,114 @@ MergeScoringFunctionMIASM::MergeScoringFunctionMIASM(
     : shrink_strategy(options.get<shared_ptr<ShrinkStrategy>>("shrink_strategy")),
       max_states(options.get<int>("max_states")),
       max_states_before_merge(options.get<int>("max_states_before_merge")),
-      shrink_threshold_before_merge(options.get<int>("threshold_before_merge")) {
+      shrink_threshold_before_merge(options.get<int>("threshold_before_merge")),
+      num_threads(options.get<int>("num_threads")) {
+}
+
+double MergeScoringFunctionMIASM::compute_score(
+    const FactoredTransitionSystem &fts, int index1, int index2) const {
+    /*
+      The factors are only read; shrinking works on copies. Hence several
+      threads can score candidates of the same factors at the same time.
+    */
+    unique_ptr<TransitionSystem> product = shrink_before_merge_externally(
+        fts,
+        index1,
+        index2,
+        *shrink_strategy,
+        max_states,
+        max_states_before_merge,
+        shrink_threshold_before_merge);
+
+    // Compute distances for the product and count the alive states.
+    unique_ptr<Distances> distances = utils::make_unique_ptr<Distances>(*product);
+    const bool compute_init_distances = true;
+    const bool compute_goal_distances = true;
+    const Verbosity verbosity = Verbosity::SILENT;
+    distances->compute_distances(compute_init_distances, compute_goal_distances, verbosity);
+    int num_states = product->get_size();
+    int alive_states_count = 0;
+    for (int state = 0; state < num_states; ++state) {
+        if (distances->get_init_distance(state) != INF &&
+            distances->get_goal_distance(state) != INF) {
+            ++alive_states_count;
+        }
+    }
+
+    /*
+      Compute the score as the ratio of alive states of the product
+      compared to the number of states of the full product.
+    */
+    return static_cast<double>(alive_states_count) /
+           static_cast<double>(num_states);
 }
 
 vector<double> MergeScoringFunctionMIASM::compute_scores(
     const FactoredTransitionSystem &fts,
     const vector<pair<int, int>> &merge_candidates) {
-    vector<double> scores;
-    scores.reserve(merge_candidates.size());
-    for (pair<int, int> merge_candidate : merge_candidates) {
-        int index1 = merge_candidate.first;
-        int index2 = merge_candidate.second;
-        unique_ptr<TransitionSystem> product = shrink_before_merge_externally(
-            fts,
-            index1,
-            index2,
-            *shrink_strategy,
-            max_states,
-            max_states_before_merge,
-            shrink_threshold_before_merge);
-
-        // Compute distances for the product and count the alive states.
-        unique_ptr<Distances> distances = utils::make_unique_ptr<Distances>(*product);
-        const bool compute_init_distances = true;
-        const bool compute_goal_distances = true;
-        const Verbosity verbosity = Verbosity::SILENT;
-        distances->compute_distances(compute_init_distances, compute_goal_distances, verbosity);
-        int num_states = product->get_size();
-        int alive_states_count = 0;
-        for (int state = 0; state < num_states; ++state) {
-            if (distances->get_init_distance(state) != INF &&
-                distances->get_goal_distance(state) != INF) {
-                ++alive_states_count;
-            }
+    // Forget the scores of factors that were merged or changed since.
+    for (auto it = cached_scores.begin(); it != cached_scores.end();) {
+        int index1 = it->first.first;
+        int index2 = it->first.second;
+        if (!fts.is_active(index1) || !fts.is_active(index2) ||
+            fts.get_version(index1) != it->second.version1 ||
+            fts.get_version(index2) != it->second.version2) {
+            it = cached_scores.erase(it);
+        } else {
+            ++it;
         }
+    }
 
-        /*
-          Compute the score as the ratio of alive states of the product
-          compared to the number of states of the full product.
-        */
-        double score = static_cast<double>(alive_states_count) /
-                       static_cast<double>(num_states);
-        scores.push_back(score);
+    vector<double> scores(merge_candidates.size());
+    vector<int> uncached_candidates;
+    for (size_t i = 0; i < merge_candidates.size(); ++i) {
+        int index1 = min(merge_candidates[i].first, merge_candidates[i].second);
+        int index2 = max(merge_candidates[i].first, merge_candidates[i].second);
+        auto it = cached_scores.find(make_pair(index1, index2));
+        if (it != cached_scores.end()) {
+            scores[i] = it->second.score;
+        } else {
+            uncached_candidates.push_back(i);
+        }
+    }
+
+    /*
+      Shrink strategies that draw random numbers are used sequentially,
+      so the scores only depend on the random seed.
+    */
+    int threads = shrink_strategy->is_thread_safe() ? num_threads : 1;
+    utils::run_in_parallel(
+        threads, uncached_candidates.size(),
+        [&](int task) {
+            const pair<int, int> &merge_candidate =
+                merge_candidates[uncached_candidates[task]];
+            scores[uncached_candidates[task]] = compute_score(
+                fts, merge_candidate.first, merge_candidate.second);
+        });
+
+    for (int i : uncached_candidates) {
+        int index1 = min(merge_candidates[i].first, merge_candidates[i].second);
+        int index2 = max(merge_candidates[i].first, merge_candidates[i].second);
+        cached_scores[make_pair(index1, index2)] = CachedScore {
+            fts.get_version(index1), fts.get_version(index2), scores[i]};
     }
     return scores;
 }
 
+void MergeScoringFunctionMIASM::initialize(const TaskProxy &) {
+    cached_scores.clear();
+    initialized = true;
+}
+
 string MergeScoringFunctionMIASM::name() const {
     return "miasm";
 }
 
+void MergeScoringFunctionMIASM::dump_function_specific_options() const {
+    cout << "Number of threads: " << utils::get_num_threads(num_threads)
+         << endl;
+}
+
 static shared_ptr<MergeScoringFunction>_parse(options::OptionParser &parser) {
     parser.document_synopsis(
         "miasm",
@@ -110,6 +172,12 @@ static shared_ptr<MergeScoringFunction>_parse(options::OptionParser &parser) {
         "configured to use full pruning, i.e. {{{prune_unreachable_states=true"
         "}}} and {{{prune_irrelevant_states=true}}} (the default).");
 
+    parser.document_note(
+        "Note",
+        "The score of a merge candidate is reused in later merge steps as "
+        "long as neither of its transition systems has been shrunk, pruned "
+        "or changed by label reduction.");
+
     // TODO: use shrink strategy and limit options from MergeAndShrinkHeuristic
     // instead of having the identical options here again.
     parser.add_option<shared_ptr<ShrinkStrategy>>(
@@ -117,6 +185,18 @@ static shared_ptr<MergeScoringFunction>_parse(options::OptionParser &parser) {
         "The given shrink strategy configuration should match the one "
         "given to {{{merge_and_shrink}}}, cf the note below.");
     MergeAndShrinkHeuristic::add_shrink_limit_options_to_parser(parser);
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads for scoring merge candidates. 0 uses one thread "
+        "per hardware thread. Shrink strategies that use random numbers are "
+        "always run in a single thread. The scores do not depend on the "
+        "number of threads. Each thread builds its own product of two "
+        "factors, so the temporary memory grows with the number of threads "
+        "(up to one product of max_states states per thread). Note that the "
+        "max_time option of merge_and_shrink limits the CPU time of all "
+        "threads together.",
+        "1",
+        options::Bounds("0", "infinity"));
 
     options::Options options = parser.parse();
     MergeAndShrinkHeuristic::handle_shrink_limit_options_defaults(options);
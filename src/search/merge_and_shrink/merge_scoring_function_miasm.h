@@ -5,7 +5,10 @@
 
 #include "types.h"
 
+#include "../utils/hash.h"
+
 #include <memory>
+#include <utility>
 
 namespace options {
 class Options;
@@ -16,18 +19,36 @@ class Distances;
 class ShrinkStrategy;
 class TransitionSystem;
 class MergeScoringFunctionMIASM : public MergeScoringFunction {
+    struct CachedScore {
+        // Versions of the two factors (see FactoredTransitionSystem::get_version).
+        int version1;
+        int version2;
+        double score;
+    };
+
     std::shared_ptr<ShrinkStrategy> shrink_strategy;
     const int max_states;
     const int max_states_before_merge;
     const int shrink_threshold_before_merge;
+    const int num_threads;
+    /*
+      Scores of merge candidates from previous calls, keyed by the pair of
+      factor indices with the smaller index first. Scores are symmetric.
+    */
+    utils::HashMap<std::pair<int, int>, CachedScore> cached_scores;
+
+    double compute_score(
+        const FactoredTransitionSystem &fts, int index1, int index2) const;
 protected:
     virtual std::string name() const override;
+    virtual void dump_function_specific_options() const override;
 public:
     explicit MergeScoringFunctionMIASM(const options::Options &options);
     virtual ~MergeScoringFunctionMIASM() override = default;
     virtual std::vector<double> compute_scores(
         const FactoredTransitionSystem &fts,
         const std::vector<std::pair<int, int>> &merge_candidates) override;
+    virtual void initialize(const TaskProxy &task_proxy) override;
 
     virtual bool requires_init_distances() const override {
         return true;
@@ -352,7 +352,7 @@ StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
         }
     }
     assert(potentially_miss_qualified_states <= ts.get_size());
-    miss_qualified_states_ratios.push_back(
+    add_miss_qualified_states_ratio(
         static_cast<double>(potentially_miss_qualified_states) /
         static_cast<double>(ts.get_size()));
 
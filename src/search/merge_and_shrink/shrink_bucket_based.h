@@ -56,6 +56,12 @@ public:
         const TransitionSystem &ts,
         const Distances &distances,
         int target_size) const override;
+
+    // All calls draw from the same random number generator.
+    virtual bool is_thread_safe() const override {
+        return false;
+    }
+
     static void add_options_to_parser(options::OptionParser &parser);
 };
 }
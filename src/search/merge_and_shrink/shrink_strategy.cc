@@ -10,6 +10,11 @@
 using namespace std;
 
 namespace merge_and_shrink {
+void ShrinkStrategy::add_miss_qualified_states_ratio(double ratio) const {
+    lock_guard<mutex> lock(miss_qualified_states_ratios_mutex);
+    miss_qualified_states_ratios.push_back(ratio);
+}
+
 void ShrinkStrategy::dump_options() const {
     cout << "Shrink strategy options: " << endl;
     cout << "Type: " << name() << endl;
@@ -3,6 +3,7 @@
 
 #include "types.h"
 
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -11,8 +12,11 @@ class Distances;
 class TransitionSystem;
 
 class ShrinkStrategy {
+    mutable std::mutex miss_qualified_states_ratios_mutex;
 protected:
     mutable std::vector<double> miss_qualified_states_ratios;
+    // Thread-safe, see is_thread_safe.
+    void add_miss_qualified_states_ratio(double ratio) const;
     virtual std::string name() const = 0;
     virtual void dump_strategy_specific_options() const = 0;
 public:
@@ -40,6 +44,15 @@ public:
     virtual bool requires_init_distances() const = 0;
     virtual bool requires_goal_distances() const = 0;
 
+    /*
+      Return true if compute_equivalence_relation may be called from several
+      threads at the same time (see MergeScoringFunctionMIASM) and the
+      results do not depend on the order of the calls.
+    */
+    virtual bool is_thread_safe() const {
+        return true;
+    }
+
     std::vector<double> &get_miss_qualified_states_ratios() {
         return miss_qualified_states_ratios;
     }
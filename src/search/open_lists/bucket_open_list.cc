@@ -0,0 +1,364 @@
+#include "bucket_open_list.h"
+
+#include "../evaluator.h"
+#include "../open_list.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../utils/memory.h"
+#include "../utils/system.h"
+
+#include <cassert>
+#include <deque>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+namespace bucket_open_list {
+template<class Entry>
+class BucketOpenList : public OpenList<Entry> {
+    // Number of entries per chunk.
+    static const int CHUNK_SIZE = 256;
+
+    struct Chunk {
+        vector<Entry> entries;
+        // Index of the next chunk of the bucket, or -1.
+        int next;
+    };
+
+    /*
+      A bucket is a linked list of chunks. FIFO buckets push to the last
+      chunk and pop from the first chunk, starting at first_pos. LIFO
+      buckets push to and pop from the back of the first chunk, and the
+      following chunks hold older entries.
+    */
+    struct Bucket {
+        int first_chunk;
+        int last_chunk;
+        int first_pos;
+
+        Bucket()
+            : first_chunk(-1), last_chunk(-1), first_pos(0) {
+        }
+
+        bool empty() const {
+            return first_chunk == -1;
+        }
+    };
+
+    /*
+      All buckets with the same first key value. The bucket at index i
+      holds the entries with second key value first_key + i. Empty
+      buckets at the front are removed, so the first bucket of a
+      non-empty layer holds its minimum entries.
+    */
+    struct Layer {
+        deque<Bucket> buckets;
+        int first_key;
+        int size;
+
+        Layer()
+            : first_key(0), size(0) {
+        }
+    };
+
+    /*
+      The layer at index i holds the entries with first key value
+      first_layer_key + i. As for buckets, empty layers at the front are
+      removed, so we only store layers for the range of first key values
+      between the minimum and maximum value in the open list.
+    */
+    deque<Layer> layers;
+    int first_layer_key;
+    int size;
+
+    // Chunks are shared by all buckets and reused when they become empty.
+    vector<Chunk> chunks;
+    vector<int> free_chunks;
+
+    vector<Evaluator *> evaluators;
+    /*
+      If allow_unsafe_pruning is true, we ignore (don't insert) states
+      which the first evaluator considers a dead end, even if it is
+      not a safe heuristic.
+    */
+    bool allow_unsafe_pruning;
+    bool lifo;
+
+    int get_key_value(EvaluationContext &eval_context, Evaluator *evaluator) const;
+    int allocate_chunk();
+    void release_chunk(int chunk_id);
+    void push(Bucket &bucket, const Entry &entry);
+    Entry pop(Bucket &bucket);
+    template<class Element>
+    static Element &get_or_create(
+        deque<Element> &elements, int &first_key, int key);
+
+protected:
+    virtual void do_insertion(EvaluationContext &eval_context,
+                              const Entry &entry) override;
+
+public:
+    explicit BucketOpenList(const Options &opts);
+    virtual ~BucketOpenList() override = default;
+
+    virtual Entry remove_min(vector<int> *key = nullptr) override;
+    virtual bool empty() const override;
+    virtual void clear() override;
+    virtual void get_involved_heuristics(set<Heuristic *> &hset) override;
+    virtual bool is_dead_end(
+        EvaluationContext &eval_context) const override;
+    virtual bool is_reliable_dead_end(
+        EvaluationContext &eval_context) const override;
+};
+
+
+template<class Entry>
+BucketOpenList<Entry>::BucketOpenList(const Options &opts)
+    : OpenList<Entry>(opts.get<bool>("pref_only")),
+      first_layer_key(0),
+      size(0),
+      evaluators(opts.get_list<Evaluator *>("evals")),
+      allow_unsafe_pruning(opts.get<bool>("unsafe_pruning")),
+      lifo(opts.get<bool>("lifo")) {
+    assert(evaluators.size() == 2);
+}
+
+template<class Entry>
+int BucketOpenList<Entry>::get_key_value(
+    EvaluationContext &eval_context, Evaluator *evaluator) const {
+    int value = eval_context.get_heuristic_value_or_infinity(evaluator);
+    if (value < 0 || value == EvaluationResult::INFTY) {
+        cerr << "Bucket open lists only support finite non-negative values, "
+             << "but " << evaluator->get_description() << " has value "
+             << value << "." << endl;
+        utils::exit_with(utils::ExitCode::UNSUPPORTED);
+    }
+    return value;
+}
+
+template<class Entry>
+int BucketOpenList<Entry>::allocate_chunk() {
+    int chunk_id;
+    if (free_chunks.empty()) {
+        chunk_id = chunks.size();
+        chunks.emplace_back();
+        chunks.back().entries.reserve(CHUNK_SIZE);
+    } else {
+        chunk_id = free_chunks.back();
+        free_chunks.pop_back();
+    }
+    chunks[chunk_id].next = -1;
+    return chunk_id;
+}
+
+template<class Entry>
+void BucketOpenList<Entry>::release_chunk(int chunk_id) {
+    chunks[chunk_id].entries.clear();
+    free_chunks.push_back(chunk_id);
+}
+
+template<class Entry>
+void BucketOpenList<Entry>::push(Bucket &bucket, const Entry &entry) {
+    if (lifo) {
+        if (bucket.empty() ||
+            chunks[bucket.first_chunk].entries.size() == CHUNK_SIZE) {
+            int chunk_id = allocate_chunk();
+            chunks[chunk_id].next = bucket.first_chunk;
+            bucket.first_chunk = chunk_id;
+        }
+        chunks[bucket.first_chunk].entries.push_back(entry);
+    } else {
+        if (bucket.empty()) {
+            bucket.first_chunk = bucket.last_chunk = allocate_chunk();
+            bucket.first_pos = 0;
+        } else if (chunks[bucket.last_chunk].entries.size() == CHUNK_SIZE) {
+            int chunk_id = allocate_chunk();
+            chunks[bucket.last_chunk].next = chunk_id;
+            bucket.last_chunk = chunk_id;
+        }
+        chunks[bucket.last_chunk].entries.push_back(entry);
+    }
+}
+
+template<class Entry>
+Entry BucketOpenList<Entry>::pop(Bucket &bucket) {
+    assert(!bucket.empty());
+    int chunk_id = bucket.first_chunk;
+    Chunk &chunk = chunks[chunk_id];
+    if (lifo) {
+        Entry result = chunk.entries.back();
+        chunk.entries.pop_back();
+        if (chunk.entries.empty()) {
+            bucket.first_chunk = chunk.next;
+            release_chunk(chunk_id);
+        }
+        return result;
+    } else {
+        Entry result = chunk.entries[bucket.first_pos];
+        ++bucket.first_pos;
+        if (bucket.first_pos == static_cast<int>(chunk.entries.size())) {
+            if (chunk_id == bucket.last_chunk) {
+                bucket.first_chunk = bucket.last_chunk = -1;
+            } else {
+                bucket.first_chunk = chunk.next;
+            }
+            bucket.first_pos = 0;
+            release_chunk(chunk_id);
+        }
+        return result;
+    }
+}
+
+template<class Entry>
+template<class Element>
+Element &BucketOpenList<Entry>::get_or_create(
+    deque<Element> &elements, int &first_key, int key) {
+    if (elements.empty()) {
+        first_key = key;
+        elements.emplace_back();
+    } else if (key < first_key) {
+        elements.insert(elements.begin(), first_key - key, Element());
+        first_key = key;
+    } else if (key - first_key >= static_cast<int>(elements.size())) {
+        elements.resize(key - first_key + 1);
+    }
+    return elements[key - first_key];
+}
+
+template<class Entry>
+void BucketOpenList<Entry>::do_insertion(
+    EvaluationContext &eval_context, const Entry &entry) {
+    int layer_key = get_key_value(eval_context, evaluators[0]);
+    int bucket_key = get_key_value(eval_context, evaluators[1]);
+
+    Layer &layer = get_or_create(layers, first_layer_key, layer_key);
+    push(get_or_create(layer.buckets, layer.first_key, bucket_key), entry);
+    ++layer.size;
+    ++size;
+}
+
+template<class Entry>
+Entry BucketOpenList<Entry>::remove_min(vector<int> *key) {
+    assert(size > 0);
+    Layer &layer = layers.front();
+    assert(layer.size > 0 && !layer.buckets.front().empty());
+    if (key) {
+        assert(key->empty());
+        key->push_back(first_layer_key);
+        key->push_back(layer.first_key);
+    }
+    Entry result = pop(layer.buckets.front());
+    --size;
+    --layer.size;
+
+    // Restore the invariant that the first bucket and layer are not empty.
+    if (layer.size > 0) {
+        while (layer.buckets.front().empty()) {
+            layer.buckets.pop_front();
+            ++layer.first_key;
+        }
+    } else {
+        while (!layers.empty() && layers.front().size == 0) {
+            layers.pop_front();
+            ++first_layer_key;
+        }
+    }
+    return result;
+}
+
+template<class Entry>
+bool BucketOpenList<Entry>::empty() const {
+    return size == 0;
+}
+
+template<class Entry>
+void BucketOpenList<Entry>::clear() {
+    layers.clear();
+    first_layer_key = 0;
+    size = 0;
+    chunks.clear();
+    free_chunks.clear();
+}
+
+template<class Entry>
+void BucketOpenList<Entry>::get_involved_heuristics(
+    set<Heuristic *> &hset) {
+    for (Evaluator *evaluator : evaluators)
+        evaluator->get_involved_heuristics(hset);
+}
+
+template<class Entry>
+bool BucketOpenList<Entry>::is_dead_end(
+    EvaluationContext &eval_context) const {
+    // Same semantics as for tie-breaking open lists.
+    if (is_reliable_dead_end(eval_context))
+        return true;
+    if (allow_unsafe_pruning &&
+        eval_context.is_heuristic_infinite(evaluators[0]))
+        return true;
+    for (Evaluator *evaluator : evaluators)
+        if (!eval_context.is_heuristic_infinite(evaluator))
+            return false;
+    return true;
+}
+
+template<class Entry>
+bool BucketOpenList<Entry>::is_reliable_dead_end(
+    EvaluationContext &eval_context) const {
+    for (Evaluator *evaluator : evaluators)
+        if (eval_context.is_heuristic_infinite(evaluator) &&
+            evaluator->dead_ends_are_reliable())
+            return true;
+    return false;
+}
+
+BucketOpenListFactory::BucketOpenListFactory(const Options &options)
+    : options(options) {
+}
+
+unique_ptr<StateOpenList>
+BucketOpenListFactory::create_state_open_list() {
+    return utils::make_unique_ptr<BucketOpenList<StateOpenListEntry>>(options);
+}
+
+unique_ptr<EdgeOpenList>
+BucketOpenListFactory::create_edge_open_list() {
+    return utils::make_unique_ptr<BucketOpenList<EdgeOpenListEntry>>(options);
+}
+
+static shared_ptr<OpenListFactory> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Bucket open list",
+        "Tie-breaking open list for exactly two evaluators, which must only "
+        "return finite non-negative values for the inserted entries (e.g., "
+        "f = g + h and h for a heuristic h). Entries are stored in buckets "
+        "indexed by the two values, which is faster than the general "
+        "tie-breaking open list. The planner exits with an error if an "
+        "evaluator returns another value.");
+    parser.add_list_option<Evaluator *>("evals", "evaluators");
+    parser.add_option<bool>(
+        "pref_only",
+        "insert only nodes generated by preferred operators", "false");
+    parser.add_option<bool>(
+        "unsafe_pruning",
+        "allow unsafe pruning when the main evaluator regards a state a dead end",
+        "true");
+    parser.add_option<bool>(
+        "lifo",
+        "break remaining ties in last-in-first-out order instead of "
+        "first-in-first-out order",
+        "false");
+    Options opts = parser.parse();
+    if (!parser.help_mode() && opts.get_list<Evaluator *>("evals").size() != 2) {
+        parser.error("bucket open lists need exactly two evaluators");
+    }
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<BucketOpenListFactory>(opts);
+}
+
+static PluginShared<OpenListFactory> _plugin("buckets", _parse);
+}
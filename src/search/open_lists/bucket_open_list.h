@@ -0,0 +1,30 @@
+#ifndef OPEN_LISTS_BUCKET_OPEN_LIST_H
+#define OPEN_LISTS_BUCKET_OPEN_LIST_H
+
+#include "../open_list_factory.h"
+#include "../option_parser_util.h"
+
+/*
+  Open list for two evaluators with finite non-negative values, e.g., the
+  [f, h] keys of A*. Entries are ordered lexicographically by their keys
+  like in the tie-breaking open list, but stored in a two-level array of
+  buckets indexed by the two values instead of a map from key vectors to
+  deques. Both levels are indexed relative to the smallest value in the
+  open list, so the memory usage and the time for finding the minimum
+  depend on the range of the values, not on their magnitude. The list is
+  only efficient if these ranges are small, e.g., for small action costs.
+*/
+
+namespace bucket_open_list {
+class BucketOpenListFactory : public OpenListFactory {
+    Options options;
+public:
+    explicit BucketOpenListFactory(const Options &options);
+    virtual ~BucketOpenListFactory() override = default;
+
+    virtual std::unique_ptr<StateOpenList> create_state_open_list() override;
+    virtual std::unique_ptr<EdgeOpenList> create_edge_open_list() override;
+};
+}
+
+#endif
@@ -7,6 +7,9 @@
 
 #include "../globals.h"
 
+#include "../algorithms/segment_allocator.h"
+#include "../task_utils/precomputation_cache.h"
+
 #include "../ext/tree_util.hh"
 
 #include "../utils/rng.h"
@@ -254,6 +257,21 @@ shared_ptr<SearchEngine> OptionParser::parse_cmd_line_aux(
             }
             cout << "Help output finished." << endl;
             exit(0);
+        } else if (arg == "--segment-backing-store") {
+            if (is_last)
+                throw ArgError("missing argument after --segment-backing-store");
+            ++i;
+            if (!dry_run)
+                segmented_vector::use_mapped_file(args[i]);
+        } else if (arg == "--precomputation-cache") {
+            if (is_last)
+                throw ArgError("missing argument after --precomputation-cache");
+            ++i;
+            /*
+              Also set in the dry run, so that the cache is used by
+              heuristics that are defined before this option.
+            */
+            precomputation_cache::use_directory(args[i]);
         } else if (arg == "--internal-plan-file") {
             if (is_last)
                 throw ArgError("missing argument after --internal-plan-file");
@@ -292,6 +310,15 @@ string OptionParser::usage(const string &progname) {
            "--symmetries SYMMETRY_PREDEFINITION\n"
            "    Predefines a structural symmetry group that can afterwards be\n"
            "    referenced by the name that is specified in the definition.\n"
+           "--segment-backing-store DIRECTORY\n"
+           "    Allocates the segments of the state registries and per-state\n"
+           "    information from a memory-mapped file in DIRECTORY, which\n"
+           "    lets the operating system page out rarely used states. The\n"
+           "    mapped file is exempted from the soft address space limit.\n"
+           "--precomputation-cache DIRECTORY\n"
+           "    Stores the PDBs, merge-and-shrink abstractions and Cartesian\n"
+           "    abstractions built by heuristics in DIRECTORY and reuses them\n"
+           "    in later runs with the same task and heuristic configuration.\n"
            "--internal-plan-file FILENAME\n"
            "    Plan will be output to a file called FILENAME\n\n"
            "--internal-previous-portfolio-plans COUNTER\n"
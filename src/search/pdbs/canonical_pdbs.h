@@ -1,6 +1,7 @@
 #ifndef PDBS_CANONICAL_PDBS_H
 #define PDBS_CANONICAL_PDBS_H
 
+#include "compiled_pdb_collection.h"
 #include "types.h"
 
 #include <memory>
@@ -9,7 +10,7 @@ class State;
 
 namespace pdbs {
 class CanonicalPDBs {
-    std::shared_ptr<MaxAdditivePDBSubsets> max_additive_subsets;
+    CompiledPDBCollection pdbs;
 
 public:
     explicit CanonicalPDBs(
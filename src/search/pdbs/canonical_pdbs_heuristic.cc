@@ -1,22 +1,84 @@
 #include "canonical_pdbs_heuristic.h"
 
 #include "dominance_pruning.h"
+#include "pattern_database.h"
 #include "pattern_generator.h"
 
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../task_utils/precomputation_cache.h"
 #include "../utils/timer.h"
 
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <unordered_map>
 
 using namespace std;
 
 namespace pdbs {
+/*
+  Write each PDB once, followed by the additive subsets as lists of
+  indices into the PDBs.
+*/
+static void save_max_additive_subsets(
+    search_checkpoint::CheckpointWriter &writer,
+    const MaxAdditivePDBSubsets &max_additive_subsets) {
+    unordered_map<const PatternDatabase *, int> pdb_ids;
+    vector<const PatternDatabase *> pdbs;
+    for (const PDBCollection &subset : max_additive_subsets) {
+        for (const shared_ptr<PatternDatabase> &pdb : subset) {
+            if (pdb_ids.emplace(pdb.get(), pdbs.size()).second)
+                pdbs.push_back(pdb.get());
+        }
+    }
+    writer.write_value(static_cast<int>(pdbs.size()));
+    for (const PatternDatabase *pdb : pdbs) {
+        pdb->save(writer);
+    }
+    writer.write_value(static_cast<int>(max_additive_subsets.size()));
+    for (const PDBCollection &subset : max_additive_subsets) {
+        vector<int> subset_ids;
+        for (const shared_ptr<PatternDatabase> &pdb : subset) {
+            subset_ids.push_back(pdb_ids[pdb.get()]);
+        }
+        writer.write_vector(subset_ids);
+    }
+}
+
+static shared_ptr<MaxAdditivePDBSubsets> load_max_additive_subsets(
+    search_checkpoint::CheckpointReader &reader) {
+    int num_pdbs = reader.read_value<int>();
+    PDBCollection pdbs;
+    pdbs.reserve(num_pdbs);
+    for (int i = 0; i < num_pdbs; ++i) {
+        pdbs.push_back(make_shared<PatternDatabase>(reader));
+    }
+    int num_subsets = reader.read_value<int>();
+    shared_ptr<MaxAdditivePDBSubsets> max_additive_subsets =
+        make_shared<MaxAdditivePDBSubsets>();
+    max_additive_subsets->reserve(num_subsets);
+    for (int i = 0; i < num_subsets; ++i) {
+        PDBCollection subset;
+        for (int pdb_id : reader.read_vector<int>()) {
+            subset.push_back(pdbs[pdb_id]);
+        }
+        max_additive_subsets->push_back(move(subset));
+    }
+    return max_additive_subsets;
+}
+
 CanonicalPDBs get_canonical_pdbs_from_options(
     const shared_ptr<AbstractTask> &task, const Options &opts) {
+    TaskProxy task_proxy(*task);
+    unique_ptr<search_checkpoint::CheckpointReader> reader =
+        precomputation_cache::open_entry(
+            "cpdbs", task_proxy, opts.get_unparsed_config());
+    if (reader) {
+        return CanonicalPDBs(load_max_additive_subsets(*reader));
+    }
+
     shared_ptr<PatternCollectionGenerator> pattern_generator =
         opts.get<shared_ptr<PatternCollectionGenerator>>("patterns");
     utils::Timer timer;
@@ -28,10 +90,18 @@ CanonicalPDBs get_canonical_pdbs_from_options(
     cout << "PDB collection construction time: " << timer << endl;
 
     if (opts.get<bool>("dominance_pruning")) {
-        int num_variables = TaskProxy(*task).get_variables().size();
+        int num_variables = task_proxy.get_variables().size();
         max_additive_subsets = prune_dominated_subsets(
             *pdbs, *max_additive_subsets, num_variables);
     }
+
+    unique_ptr<search_checkpoint::CheckpointWriter> writer =
+        precomputation_cache::create_entry(
+            "cpdbs", task_proxy, opts.get_unparsed_config());
+    if (writer) {
+        save_max_additive_subsets(*writer, *max_additive_subsets);
+        writer->commit();
+    }
     return CanonicalPDBs(max_additive_subsets);
 }
 
@@ -0,0 +1,124 @@
+#include "compiled_pdb_collection.h"
+
+#include "pattern_database.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <unordered_map>
+
+using namespace std;
+
+namespace pdbs {
+CompiledPDBCollection::CompiledPDBCollection(
+    const MaxAdditivePDBSubsets &subsets) {
+    // Collect the PDBs that occur in the subsets and sort them by size.
+    vector<PatternDatabase *> pdbs;
+    unordered_map<const PatternDatabase *, int> pdb_indices;
+    for (const PDBCollection &subset : subsets) {
+        for (const shared_ptr<PatternDatabase> &pdb : subset) {
+            if (pdb_indices.emplace(pdb.get(), pdbs.size()).second) {
+                pdbs.push_back(pdb.get());
+            }
+        }
+    }
+    stable_sort(pdbs.begin(), pdbs.end(),
+                [](const PatternDatabase *pdb1, const PatternDatabase *pdb2) {
+                    return pdb1->get_pattern().size() > pdb2->get_pattern().size();
+                });
+    num_pdbs = pdbs.size();
+    for (int i = 0; i < num_pdbs; ++i) {
+        pdb_indices[pdbs[i]] = i;
+    }
+
+    size_t max_pattern_size = pdbs.empty() ? 0 : pdbs[0]->get_pattern().size();
+    for (size_t pos = 0; pos < max_pattern_size; ++pos) {
+        int num_pdbs_with_position = 0;
+        for (const PatternDatabase *pdb : pdbs) {
+            const Pattern &pattern = pdb->get_pattern();
+            if (pattern.size() <= pos)
+                break;
+            variables.push_back(pattern[pos]);
+            multipliers.push_back(pdb->get_hash_multipliers()[pos]);
+            ++num_pdbs_with_position;
+        }
+        num_pdbs_by_position.push_back(num_pdbs_with_position);
+    }
+
+    min_compressions.reserve(num_pdbs);
+    distances.reserve(num_pdbs);
+    for (PatternDatabase *pdb : pdbs) {
+        min_compressions.push_back(pdb->get_min_compression());
+        distances.push_back(pdb->release_distances());
+    }
+
+    vector<vector<int>> subset_pdb_indices;
+    subset_pdb_indices.reserve(subsets.size());
+    for (const PDBCollection &subset : subsets) {
+        vector<int> indices;
+        indices.reserve(subset.size());
+        for (const shared_ptr<PatternDatabase> &pdb : subset) {
+            indices.push_back(pdb_indices[pdb.get()]);
+        }
+        subset_pdb_indices.push_back(move(indices));
+    }
+    additive_subsets = compressed_lists::CompressedLists(subset_pdb_indices);
+
+    pdb_values.resize(num_pdbs);
+}
+
+int CompiledPDBCollection::get_value(const vector<int> &state_values) const {
+    /*
+      Compute the hash indices of all PDBs. The indices fit into ints
+      (see PatternDatabase constructor).
+    */
+    int *values = pdb_values.data();
+    fill(values, values + num_pdbs, 0);
+    const int *state = state_values.data();
+    const int *pattern_variables = variables.data();
+    const int *pattern_multipliers = multipliers.data();
+    for (int num_pdbs_with_position : num_pdbs_by_position) {
+        for (int i = 0; i < num_pdbs_with_position; ++i) {
+            values[i] += pattern_multipliers[i] * state[pattern_variables[i]];
+        }
+        pattern_variables += num_pdbs_with_position;
+        pattern_multipliers += num_pdbs_with_position;
+    }
+
+    for (int i = 0; i < num_pdbs; ++i) {
+        values[i] = distances[i].get(values[i] >> min_compressions[i]);
+        if (values[i] == numeric_limits<int>::max())
+            return numeric_limits<int>::max();
+    }
+
+    // If we have an empty collection, then subsets = { \emptyset }.
+    assert(additive_subsets.size() > 0);
+    int max_h = 0;
+    for (int subset = 0; subset < additive_subsets.size(); ++subset) {
+        int subset_h = 0;
+        for (int pdb_index : additive_subsets[subset]) {
+            subset_h += values[pdb_index];
+        }
+        max_h = max(max_h, subset_h);
+    }
+    return max_h;
+}
+
+double CompiledPDBCollection::compute_mean_finite_h(int pdb_index) const {
+    double sum = 0;
+    int size = 0;
+    const DistanceTable &pdb_distances = distances[pdb_index];
+    for (size_t i = 0; i < pdb_distances.size(); ++i) {
+        int h = pdb_distances.get(i);
+        if (h != numeric_limits<int>::max()) {
+            sum += h;
+            ++size;
+        }
+    }
+    if (size == 0) { // All states are dead ends.
+        return numeric_limits<double>::infinity();
+    } else {
+        return sum / size;
+    }
+}
+}
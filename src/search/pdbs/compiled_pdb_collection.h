@@ -0,0 +1,65 @@
+#ifndef PDBS_COMPILED_PDB_COLLECTION_H
+#define PDBS_COMPILED_PDB_COLLECTION_H
+
+#include "distance_table.h"
+#include "types.h"
+
+#include "../algorithms/compressed_lists.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace pdbs {
+/*
+  Evaluates the maximum over the sums of PDB values of a fixed family of
+  additive PDB subsets (the canonical heuristic).
+
+  The PDBs are compiled into flat arrays, so an evaluation needs no
+  State proxies and no pointer chasing. Each PDB keeps its own distance
+  table, so every table keeps the entry width chosen for its values.
+  The pattern variables and hash multipliers are stored by position in
+  the pattern: first the first variables of all patterns,
+  then the second variables, etc. Since the PDBs are sorted by
+  decreasing pattern size, each position is a contiguous block for the
+  first PDBs. The hash indices of all PDBs are thus computed by one
+  simple loop per position, which the compiler can vectorize (with
+  gather instructions where the target supports them).
+
+  The distance tables are moved out of the PDBs, so the compilation
+  needs no additional memory, but the PDBs can no longer be evaluated
+  afterwards. The other PDB data is copied.
+*/
+class CompiledPDBCollection {
+    int num_pdbs;
+    // Number of PDBs whose patterns have more than i variables.
+    std::vector<int> num_pdbs_by_position;
+    std::vector<int> variables;
+    std::vector<int> multipliers;
+    // See PatternDatabase::min_compression.
+    std::vector<int> min_compressions;
+    std::vector<DistanceTable> distances;
+    // PDB indices of the additive subsets.
+    compressed_lists::CompressedLists additive_subsets;
+    // Avoid reallocating the buffer for the values of the PDBs.
+    mutable std::vector<int> pdb_values;
+
+public:
+    explicit CompiledPDBCollection(const MaxAdditivePDBSubsets &subsets);
+
+    /*
+      Compute the heuristic value for the given values of all task
+      variables. Dead ends are represented by numeric_limits<int>::max().
+      Not thread-safe, since all calls use the same buffer.
+    */
+    int get_value(const std::vector<int> &state_values) const;
+
+    int get_num_pdbs() const {
+        return num_pdbs;
+    }
+
+    // See PatternDatabase::compute_mean_finite_h.
+    double compute_mean_finite_h(int pdb_index) const;
+};
+}
+
+#endif
@@ -0,0 +1,116 @@
+#include "distance_table.h"
+
+#include "../search_engines/search_checkpoint.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace pdbs {
+static const int ENTRY_WIDTHS[] = {4, 8, 32};
+
+DistanceTable::DistanceTable(int bits, size_t num_entries)
+    : bits(bits),
+      num_entries(num_entries) {
+    assert(bits == 4 || bits == 8 || bits == 32);
+    data.resize((num_entries * bits + 7) / 8);
+}
+
+DistanceTable::DistanceTable(const vector<int> &values)
+    : DistanceTable(compute_best_entry_width(values), values.size()) {
+    for (size_t index = 0; index < values.size(); ++index) {
+        set(index, values[index]);
+    }
+    large_values.shrink_to_fit();
+}
+
+DistanceTable::DistanceTable(search_checkpoint::CheckpointReader &reader)
+    : bits(reader.read_value<int>()),
+      num_entries(reader.read_value<uint64_t>()),
+      data(reader.read_vector<uint8_t>()) {
+    assert(bits == 4 || bits == 8 || bits == 32);
+    assert(data.size() == (num_entries * bits + 7) / 8);
+    vector<uint64_t> large_value_indices = reader.read_vector<uint64_t>();
+    vector<int> large_value_values = reader.read_vector<int>();
+    assert(large_value_indices.size() == large_value_values.size());
+    large_values.reserve(large_value_indices.size());
+    for (size_t i = 0; i < large_value_indices.size(); ++i) {
+        large_values.emplace_back(large_value_indices[i], large_value_values[i]);
+    }
+}
+
+void DistanceTable::save(search_checkpoint::CheckpointWriter &writer) const {
+    writer.write_value(bits);
+    writer.write_value(static_cast<uint64_t>(num_entries));
+    writer.write_vector(data);
+    vector<uint64_t> large_value_indices;
+    vector<int> large_value_values;
+    for (const pair<size_t, int> &large_value : large_values) {
+        large_value_indices.push_back(large_value.first);
+        large_value_values.push_back(large_value.second);
+    }
+    writer.write_vector(large_value_indices);
+    writer.write_vector(large_value_values);
+}
+
+int DistanceTable::compute_best_entry_width(const vector<int> &values) {
+    // Count the values that do not fit into 4 and 8 bits, respectively.
+    size_t num_large_values[2] = {0, 0};
+    for (int value : values) {
+        if (value != numeric_limits<int>::max()) {
+            num_large_values[0] += (value >= 14);
+            num_large_values[1] += (value >= 254);
+        }
+    }
+    int best_bits = 32;
+    size_t best_bytes = values.size() * sizeof(int);
+    for (int i = 0; i < 2; ++i) {
+        int bits = ENTRY_WIDTHS[i];
+        size_t bytes = (values.size() * bits + 7) / 8 +
+            num_large_values[i] * sizeof(pair<size_t, int>);
+        if (bytes < best_bytes) {
+            best_bits = bits;
+            best_bytes = bytes;
+        }
+    }
+    return best_bits;
+}
+
+void DistanceTable::set(size_t index, int value) {
+    assert(index < num_entries);
+    assert(value >= 0);
+    if (bits == 32) {
+        memcpy(&data[index * 4], &value, sizeof(int));
+        return;
+    }
+    int code;
+    if (value == numeric_limits<int>::max()) {
+        code = get_infinity_code();
+    } else if (value >= get_large_value_code()) {
+        code = get_large_value_code();
+        assert(large_values.empty() || large_values.back().first < index);
+        large_values.emplace_back(index, value);
+    } else {
+        code = value;
+    }
+    if (bits == 4) {
+        int shift = index % 2 * 4;
+        uint8_t &byte = data[index / 2];
+        byte = (byte & ~(15 << shift)) | (code << shift);
+    } else {
+        data[index] = code;
+    }
+}
+
+int DistanceTable::get_large_value(size_t index) const {
+    auto it = lower_bound(
+        large_values.begin(), large_values.end(), make_pair(index, 0));
+    assert(it != large_values.end() && it->first == index);
+    return it->second;
+}
+
+size_t DistanceTable::get_memory_usage() const {
+    return data.capacity() +
+           large_values.capacity() * sizeof(pair<size_t, int>);
+}
+}
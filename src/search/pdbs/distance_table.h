@@ -0,0 +1,103 @@
+#ifndef PDBS_DISTANCE_TABLE_H
+#define PDBS_DISTANCE_TABLE_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace search_checkpoint {
+class CheckpointReader;
+class CheckpointWriter;
+}
+
+namespace pdbs {
+/*
+  Compact storage for the h-values of abstract states. Dead ends are
+  represented by numeric_limits<int>::max().
+
+  Entries use 4, 8 or 32 bits. With 4 and 8 bits, the largest code
+  represents infinity and the second largest code marks values that do
+  not fit into the entry. These values are stored in a list sorted by
+  index, which is searched on lookup. Since most PDB values are small,
+  most tables need only 4 or 8 bits per entry.
+*/
+class DistanceTable {
+    int bits;
+    std::size_t num_entries;
+    std::vector<std::uint8_t> data;
+    std::vector<std::pair<std::size_t, int>> large_values;
+
+    int get_infinity_code() const {
+        return (1 << bits) - 1;
+    }
+
+    int get_large_value_code() const {
+        return (1 << bits) - 2;
+    }
+
+    int get_large_value(std::size_t index) const;
+public:
+    DistanceTable()
+        : bits(32),
+          num_entries(0) {
+    }
+    // Create a table of the given size for entries of the given width.
+    DistanceTable(int bits, std::size_t num_entries);
+    // Create a table with the smallest footprint for the given values.
+    explicit DistanceTable(const std::vector<int> &values);
+    // Read a table written by save.
+    explicit DistanceTable(search_checkpoint::CheckpointReader &reader);
+
+    void save(search_checkpoint::CheckpointWriter &writer) const;
+
+    /*
+      Return the number of bits per entry for which a table holding the
+      given values needs the least memory.
+    */
+    static int compute_best_entry_width(const std::vector<int> &values);
+
+    /*
+      Set the value of an entry. Entries with values that do not fit
+      into the entry must be set in increasing order of their indices.
+    */
+    void set(std::size_t index, int value);
+
+    int get(std::size_t index) const {
+        assert(index < num_entries);
+        int code;
+        if (bits == 4) {
+            code = (data[index / 2] >> (index % 2 * 4)) & 15;
+        } else if (bits == 8) {
+            code = data[index];
+        } else {
+            int value;
+            std::memcpy(&value, &data[index * 4], sizeof(int));
+            return value;
+        }
+        if (code < get_large_value_code()) {
+            return code;
+        } else if (code == get_infinity_code()) {
+            return std::numeric_limits<int>::max();
+        } else {
+            return get_large_value(index);
+        }
+    }
+
+    int get_entry_width() const {
+        return bits;
+    }
+
+    std::size_t size() const {
+        return num_entries;
+    }
+
+    // Return the number of bytes used by the table.
+    std::size_t get_memory_usage() const;
+};
+}
+
+#endif
@@ -1,10 +1,10 @@
 #include "incremental_canonical_pdbs.h"
 
-#include "canonical_pdbs.h"
 #include "pattern_database.h"
 
 #include "../utils/timer.h"
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
 
@@ -18,7 +18,8 @@ IncrementalCanonicalPDBs::IncrementalCanonicalPDBs(
                                               intitial_patterns.end())),
       pattern_databases(make_shared<PDBCollection>()),
       max_additive_subsets(nullptr),
-      size(0) {
+      size(0),
+      memory_usage(0) {
     utils::Timer timer;
     pattern_databases->reserve(patterns->size());
     for (const Pattern &pattern : *patterns)
@@ -31,12 +32,14 @@ IncrementalCanonicalPDBs::IncrementalCanonicalPDBs(
 void IncrementalCanonicalPDBs::add_pdb_for_pattern(const Pattern &pattern) {
     pattern_databases->push_back(make_shared<PatternDatabase>(task_proxy, pattern));
     size += pattern_databases->back()->get_size();
+    memory_usage += pattern_databases->back()->get_memory_usage();
 }
 
 void IncrementalCanonicalPDBs::add_pdb(const shared_ptr<PatternDatabase> &pdb) {
     patterns->push_back(pdb->get_pattern());
     pattern_databases->push_back(pdb);
     size += pattern_databases->back()->get_size();
+    memory_usage += pattern_databases->back()->get_memory_usage();
     recompute_max_additive_subsets();
 }
 
@@ -52,8 +55,22 @@ MaxAdditivePDBSubsets IncrementalCanonicalPDBs::get_max_additive_subsets(
 }
 
 int IncrementalCanonicalPDBs::get_value(const State &state) const {
-    CanonicalPDBs canonical_pdbs(max_additive_subsets);
-    return canonical_pdbs.get_value(state);
+    /*
+      The collection changes frequently, so we do not compile it into a
+      CanonicalPDBs object here.
+    */
+    int max_h = 0;
+    for (const PDBCollection &subset : *max_additive_subsets) {
+        int subset_h = 0;
+        for (const shared_ptr<PatternDatabase> &pdb : subset) {
+            int h = pdb->get_value(state);
+            if (h == numeric_limits<int>::max())
+                return numeric_limits<int>::max();
+            subset_h += h;
+        }
+        max_h = max(max_h, subset_h);
+    }
+    return max_h;
 }
 
 bool IncrementalCanonicalPDBs::is_dead_end(const State &state) const {
@@ -7,6 +7,7 @@
 
 #include "../task_proxy.h"
 
+#include <cstddef>
 #include <memory>
 
 namespace pdbs {
@@ -21,7 +22,9 @@ class IncrementalCanonicalPDBs {
     VariableAdditivity are_additive;
 
     // The sum of all abstract state sizes of all pdbs in the collection.
-    int size;
+    std::size_t size;
+    // The number of bytes used by the h-values of all pdbs.
+    std::size_t memory_usage;
 
     // Adds a PDB for pattern but does not recompute max_additive_subsets.
     void add_pdb_for_pattern(const Pattern &pattern);
@@ -55,9 +58,13 @@ public:
         return pattern_databases;
     }
 
-    int get_size() const {
+    std::size_t get_size() const {
         return size;
     }
+
+    std::size_t get_memory_usage() const {
+        return memory_usage;
+    }
 };
 }
 
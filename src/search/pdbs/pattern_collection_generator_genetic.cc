@@ -1,5 +1,7 @@
 #include "pattern_collection_generator_genetic.h"
 
+#include "pattern_database.h"
+#include "pdb_cache.h"
 #include "validation.h"
 #include "zero_one_pdbs.h"
 
@@ -10,6 +12,8 @@
 #include "../task_utils/causal_graph.h"
 #include "../utils/markup.h"
 #include "../utils/math.h"
+#include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
@@ -30,9 +34,14 @@ PatternCollectionGeneratorGenetic::PatternCollectionGeneratorGenetic(
       num_episodes(opts.get<int>("num_episodes")),
       mutation_probability(opts.get<double>("mutation_probability")),
       disjoint_patterns(opts.get<bool>("disjoint")),
+      cache_memory(static_cast<size_t>(opts.get<int>("cache_memory")) * 1024 * 1024),
+      num_threads(opts.get<int>("num_threads")),
       rng(utils::parse_rng_from_options(opts)) {
 }
 
+PatternCollectionGeneratorGenetic::~PatternCollectionGeneratorGenetic() {
+}
+
 void PatternCollectionGeneratorGenetic::select(
     const vector<double> &fitness_values) {
     vector<double> cumulative_fitness;
@@ -159,10 +168,14 @@ bool PatternCollectionGeneratorGenetic::mark_used_variables(
 
 void PatternCollectionGeneratorGenetic::evaluate(vector<double> &fitness_values) {
     TaskProxy task_proxy(*task);
-    for (const auto &collection : pattern_collections) {
+    int num_pattern_collections = pattern_collections.size();
+    // Normalized pattern collections, nullptr for invalid collections.
+    vector<shared_ptr<PatternCollection>> normalized_collections(
+        num_pattern_collections);
+    for (int i = 0; i < num_pattern_collections; ++i) {
         //cout << "evaluate pattern collection " << (i + 1) << " of "
         //     << pattern_collections.size() << endl;
-        double fitness = 0;
+        const auto &collection = pattern_collections[i];
         bool pattern_valid = true;
         vector<bool> variables_used(task_proxy.get_variables().size(), false);
         shared_ptr<PatternCollection> pattern_collection = make_shared<PatternCollection>();
@@ -187,20 +200,44 @@ void PatternCollectionGeneratorGenetic::evaluate(vector<double> &fitness_values)
             remove_irrelevant_variables(pattern);
             pattern_collection->push_back(pattern);
         }
-        if (!pattern_valid) {
+        if (pattern_valid) {
+            normalized_collections[i] = pattern_collection;
+        }
+    }
+
+    /*
+      Generate the zero-one PDBs of the valid pattern collections and
+      compute their fitness values. Building PDBs only reads the task and
+      the cache is thread-safe, so we can do this in parallel.
+    */
+    vector<double> collection_fitness(num_pattern_collections, 0);
+    utils::run_in_parallel(
+        num_threads, num_pattern_collections,
+        [&](int i) {
+            if (!normalized_collections[i])
+                return;
+            PDBCollection pdbs = compute_zero_one_pdbs(
+                task_proxy, *normalized_collections[i], pdb_cache.get());
+            double fitness = 0;
+            for (const shared_ptr<PatternDatabase> &pdb : pdbs) {
+                fitness += pdb->compute_mean_finite_h();
+            }
+            collection_fitness[i] = fitness;
+        });
+
+    for (int i = 0; i < num_pattern_collections; ++i) {
+        double fitness;
+        if (!normalized_collections[i]) {
             /* Set fitness to a very small value to cover cases in which all
                patterns are invalid. */
             fitness = 0.001;
         } else {
-            /* Generate the pattern collection heuristic and get its fitness
-               value. */
-            ZeroOnePDBs zero_one_pdbs(task_proxy, *pattern_collection);
-            fitness = zero_one_pdbs.compute_approx_mean_finite_h();
+            fitness = collection_fitness[i];
             // Update the best heuristic found so far.
             if (fitness > best_fitness) {
                 best_fitness = fitness;
                 cout << "best_fitness = " << best_fitness << endl;
-                best_patterns = pattern_collection;
+                best_patterns = normalized_collections[i];
             }
         }
         fitness_values.push_back(fitness);
@@ -259,6 +296,7 @@ void PatternCollectionGeneratorGenetic::genetic_algorithm(
     task = task_;
     best_fitness = -1;
     best_patterns = nullptr;
+    pdb_cache = utils::make_unique_ptr<PDBCache>(cache_memory);
     bin_packing();
     vector<double> initial_fitness_values;
     evaluate(initial_fitness_values);
@@ -271,6 +309,8 @@ void PatternCollectionGeneratorGenetic::genetic_algorithm(
         // We allow to select invalid pattern collections.
         select(fitness_values);
     }
+    pdb_cache->print_statistics();
+    pdb_cache = nullptr;
 }
 
 PatternCollectionInformation PatternCollectionGeneratorGenetic::generate(
@@ -365,6 +405,23 @@ static shared_ptr<PatternCollectionGenerator> _parse(OptionParser &parser) {
         "consider a pattern collection invalid (giving it very low "
         "fitness) if its patterns are not disjoint",
         "false");
+    parser.add_option<int>(
+        "cache_memory",
+        "memory in MB for keeping PDBs between evaluations. Patterns recur "
+        "frequently after mutation and selection, and their PDBs are only "
+        "built again if they have been evicted from the cache (least "
+        "recently used first). 0 disables the cache.",
+        "100",
+        Bounds("0", "infinity"));
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads for evaluating pattern collections. 0 uses one "
+        "thread per hardware thread. The result does not depend on the "
+        "number of threads. Each thread builds the PDBs of its own pattern "
+        "collection, so the memory for PDBs that are not in the cache grows "
+        "with the number of threads (up to pdb_max_size entries per PDB).",
+        "1",
+        Bounds("0", "infinity"));
 
     utils::add_rng_options(parser);
 
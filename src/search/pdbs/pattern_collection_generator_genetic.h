@@ -4,6 +4,7 @@
 #include "pattern_generator.h"
 #include "types.h"
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -18,6 +19,8 @@ class RandomNumberGenerator;
 }
 
 namespace pdbs {
+class PDBCache;
+
 /*
   Implementation of the pattern generation algorithm by Edelkamp. See:
   Stefan Edelkamp, Automated Creation of Pattern Database Search
@@ -33,10 +36,20 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
     /* Specifies whether patterns in each pattern collection need to be disjoint
        or not. */
     const bool disjoint_patterns;
+    // Memory budget in bytes for PDBs kept between evaluations.
+    const std::size_t cache_memory;
+    const int num_threads;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
 
     std::shared_ptr<AbstractTask> task;
 
+    /*
+      Mutation and selection keep reproducing the same patterns, so we
+      cache their PDBs (for the given operator costs) across collections
+      and episodes.
+    */
+    std::unique_ptr<PDBCache> pdb_cache;
+
     // All current pattern collections.
     std::vector<std::vector<std::vector<bool>>> pattern_collections;
 
@@ -79,6 +92,10 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
       ( = summed up mean h-values (dead ends are ignored) of all PDBs in the
       collection) computed. The overall best heuristic is eventually updated and
       saved for further episodes.
+
+      The fitness values of the valid collections are computed in parallel.
+      All other steps are done sequentially in the order of the collections,
+      so the result does not depend on the number of threads.
     */
     void evaluate(std::vector<double> &fitness_values);
     bool is_pattern_too_large(const Pattern &pattern) const;
@@ -114,7 +131,7 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
     void genetic_algorithm(const std::shared_ptr<AbstractTask> &task);
 public:
     PatternCollectionGeneratorGenetic(const options::Options &opts);
-    virtual ~PatternCollectionGeneratorGenetic() = default;
+    virtual ~PatternCollectionGeneratorGenetic();
 
     virtual PatternCollectionInformation generate(
         const std::shared_ptr<AbstractTask> &task) override;
@@ -16,11 +16,13 @@
 #include "../utils/markup.h"
 #include "../utils/math.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <exception>
 #include <iostream>
@@ -37,6 +39,7 @@ PatternCollectionGeneratorHillclimbing::PatternCollectionGeneratorHillclimbing(c
       num_samples(opts.get<int>("num_samples")),
       min_improvement(opts.get<int>("min_improvement")),
       max_time(opts.get<double>("max_time")),
+      num_threads(opts.get<int>("num_threads")),
       rng(utils::parse_rng_from_options(opts)),
       num_rejected(0),
       hill_climbing_timer(0) {
@@ -50,7 +53,7 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
     const causal_graph::CausalGraph &causal_graph = task_proxy.get_causal_graph();
     const Pattern &pattern = pdb.get_pattern();
     int pdb_size = pdb.get_size();
-    int max_pdb_size = 0;
+    PatternCollection new_patterns;
     for (int pattern_var : pattern) {
         /* Only consider variables used in preconditions for current
            variable from pattern. It would also make sense to consider
@@ -77,16 +80,32 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
                       surpass the size limit.
                     */
                     generated_patterns.insert(new_pattern);
-                    candidate_pdbs.push_back(
-                        make_shared<PatternDatabase>(task_proxy, new_pattern));
-                    max_pdb_size = max(max_pdb_size,
-                                       candidate_pdbs.back()->get_size());
+                    new_patterns.push_back(move(new_pattern));
                 }
             } else {
                 ++num_rejected;
             }
         }
     }
+
+    /*
+      PDB construction only reads the task, so we can build the PDBs in
+      parallel. Each PDB is stored at the position of its pattern.
+    */
+    int num_new_pdbs = new_patterns.size();
+    PDBCollection new_pdbs(num_new_pdbs);
+    utils::run_in_parallel(
+        num_threads, num_new_pdbs,
+        [&](int i) {
+            new_pdbs[i] = make_shared<PatternDatabase>(
+                task_proxy, new_patterns[i]);
+        });
+
+    int max_pdb_size = 0;
+    for (shared_ptr<PatternDatabase> &new_pdb : new_pdbs) {
+        max_pdb_size = max(max_pdb_size, new_pdb->get_size());
+        candidate_pdbs.push_back(move(new_pdb));
+    }
     return max_pdb_size;
 }
 
@@ -119,53 +138,78 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
       We require that a pattern must have an improvement of at least one in
       order to be taken into account.
     */
-    int improvement = 0;
-    int best_pdb_index = -1;
-
-    // Iterate over all candidates and search for the best improving pattern/pdb
+    /*
+      Forget all candidates whose memory added to the current collection's
+      memory exceeds the memory of collection_max_size uncompressed entries.
+      The current collection does not change during this method, so we can
+      do this before evaluating the remaining candidates.
+    */
+    vector<int> candidate_indices;
     for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
-        if (hill_climbing_timer->is_expired())
-            throw HillClimbingTimeout();
-
         const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
         if (!pdb) {
             /* candidate pattern is too large or has already been added to
                the canonical heuristic. */
             continue;
         }
-        /*
-          If a candidate's size added to the current collection's size exceeds
-          the maximum collection size, then forget the pdb.
-        */
-        int combined_size = current_pdbs->get_size() + pdb->get_size();
-        if (combined_size > collection_max_size) {
+        size_t combined_memory =
+            current_pdbs->get_memory_usage() + pdb->get_memory_usage();
+        if (combined_memory > collection_max_size * sizeof(int)) {
             candidate_pdbs[i] = nullptr;
             continue;
         }
+        candidate_indices.push_back(i);
+    }
 
-        /*
-          Calculate the "counting approximation" for all sample states: count
-          the number of samples for which the current pattern collection
-          heuristic would be improved if the new pattern was included into it.
-        */
-        /*
-          TODO: The original implementation by Haslum et al. uses m/t as a
-          statistical confidence interval to stop the A*-search (which they use,
-          see above) earlier.
-        */
-        int count = 0;
-        MaxAdditivePDBSubsets max_additive_subsets =
-            current_pdbs->get_max_additive_subsets(pdb->get_pattern());
-        for (State &sample : samples) {
-            if (is_heuristic_improved(*pdb, sample, max_additive_subsets))
-                ++count;
-        }
+    /*
+      Calculate the "counting approximation" for all sample states: count
+      the number of samples for which the current pattern collection
+      heuristic would be improved if the new pattern was included into it.
+
+      The candidates are evaluated in parallel. All threads only read the
+      candidates, the samples and the current collection, and each thread
+      writes the count of a candidate to its own slot in counts.
+    */
+    /*
+      TODO: The original implementation by Haslum et al. uses m/t as a
+      statistical confidence interval to stop the A*-search (which they use,
+      see above) earlier.
+    */
+    int num_candidates = candidate_indices.size();
+    vector<int> counts(num_candidates, 0);
+    atomic<bool> timeout(false);
+    utils::run_in_parallel(
+        num_threads, num_candidates,
+        [&](int i) {
+            if (timeout || hill_climbing_timer->is_expired()) {
+                timeout = true;
+                return;
+            }
+            const PatternDatabase &pdb = *candidate_pdbs[candidate_indices[i]];
+            MaxAdditivePDBSubsets max_additive_subsets =
+                current_pdbs->get_max_additive_subsets(pdb.get_pattern());
+            int count = 0;
+            for (const State &sample : samples) {
+                if (is_heuristic_improved(pdb, sample, max_additive_subsets))
+                    ++count;
+            }
+            counts[i] = count;
+        });
+    if (timeout)
+        throw HillClimbingTimeout();
+
+    // Select the best candidate in the order of candidate_pdbs.
+    int improvement = 0;
+    int best_pdb_index = -1;
+    for (int i = 0; i < num_candidates; ++i) {
+        int pdb_index = candidate_indices[i];
+        int count = counts[i];
         if (count > improvement) {
             improvement = count;
-            best_pdb_index = i;
+            best_pdb_index = pdb_index;
         }
         if (count > 0) {
-            cout << "pattern: " << candidate_pdbs[i]->get_pattern()
+            cout << "pattern: " << candidate_pdbs[pdb_index]->get_pattern()
                  << " - improvement: " << count << endl;
         }
     }
@@ -175,7 +219,7 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
 
 bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
     const PatternDatabase &pdb, const State &sample,
-    const MaxAdditivePDBSubsets &max_additive_subsets) {
+    const MaxAdditivePDBSubsets &max_additive_subsets) const {
     // h_pattern: h-value of the new pattern
     int h_pattern = pdb.get_value(sample);
 
@@ -297,6 +341,8 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
     cout << "iPDB: number of patterns = "
          << current_pdbs->get_pattern_databases()->size() << endl;
     cout << "iPDB: size = " << current_pdbs->get_size() << endl;
+    cout << "iPDB: memory = " << current_pdbs->get_memory_usage() / 1024
+         << " KB" << endl;
     cout << "iPDB: generated = " << generated_patterns.size() << endl;
     cout << "iPDB: rejected = " << num_rejected << endl;
     cout << "iPDB: maximum pdb size = " << max_pdb_size << endl;
@@ -339,7 +385,10 @@ void add_hillclimbing_options(OptionParser &parser) {
         Bounds("1", "infinity"));
     parser.add_option<int>(
         "collection_max_size",
-        "maximal number of states in the pattern collection",
+        "maximal size of the pattern collection. The limit applies to the "
+        "memory of the collection: it may use as many bytes as this number "
+        "of uncompressed (4-byte) PDB entries. Since PDB entries are usually "
+        "stored with 4 or 8 bits, the collection can contain more states.",
         "20000000",
         Bounds("1", "infinity"));
     parser.add_option<int>(
@@ -362,6 +411,16 @@ void add_hillclimbing_options(OptionParser &parser) {
         "is performed at all.",
         "infinity",
         Bounds("0.0", "infinity"));
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads for building and evaluating candidate PDBs. "
+        "0 uses one thread per hardware thread. The result does not depend "
+        "on the number of threads. Each thread builds its own PDB, so the "
+        "temporary memory for building PDBs grows with the number of "
+        "threads (up to one PDB of pdb_max_size entries per thread). Note "
+        "that max_time limits the CPU time of all threads together.",
+        "1",
+        Bounds("0", "infinity"));
     utils::add_rng_options(parser);
 }
 
@@ -37,6 +37,8 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
     // minimal improvement required for hill climbing to continue search
     const int min_improvement;
     const double max_time;
+    // number of threads for building and evaluating candidate pdbs
+    const int num_threads;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
 
     std::unique_ptr<IncrementalCanonicalPDBs> current_pdbs;
@@ -50,7 +52,8 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       relevant variable are considered as candidate patterns. If the candidate
       pattern has not been previously considered (not contained in
       generated_patterns) and if building a PDB for it does not surpass the
-      size limit, then the PDB is built and added to candidate_pdbs.
+      size limit, then the PDB is built and added to candidate_pdbs. The new
+      PDBs are built in parallel and added in a fixed order.
 
       The method returns the size of the largest PDB added to candidate_pdbs.
     */
@@ -80,6 +83,10 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       Searches for the best improving pdb in candidate_pdbs according to the
       counting approximation and the given samples. Returns the improvement and
       the index of the best pdb in candidate_pdbs.
+
+      The candidates are evaluated in parallel. Ties are broken in favor of
+      the candidate with the lowest index, so the result does not depend on
+      the number of threads.
     */
     std::pair<int, int> find_best_improving_pdb(
         std::vector<State> &samples,
@@ -94,7 +101,7 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
     bool is_heuristic_improved(
         const PatternDatabase &pdb,
         const State &sample,
-        const MaxAdditivePDBSubsets &max_additive_subsets);
+        const MaxAdditivePDBSubsets &max_additive_subsets) const;
 
     /*
       This is the core algorithm of this class. The initial PDB collection
@@ -3,6 +3,7 @@
 #include "match_tree.h"
 
 #include "../algorithms/priority_queues.h"
+#include "../search_engines/search_checkpoint.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/collections.h"
 #include "../utils/logging.h"
@@ -70,8 +71,10 @@ PatternDatabase::PatternDatabase(
     const TaskProxy &task_proxy,
     const Pattern &pattern,
     bool dump,
-    const vector<int> &operator_costs)
-    : pattern(pattern) {
+    const vector<int> &operator_costs,
+    int min_compression)
+    : pattern(pattern),
+      min_compression(min_compression) {
     task_properties::verify_no_axioms(task_proxy);
     task_properties::verify_no_conditional_effects(task_proxy);
     assert(operator_costs.empty() ||
@@ -94,8 +97,31 @@ PatternDatabase::PatternDatabase(
         }
     }
     create_pdb(task_proxy, operator_costs);
-    if (dump)
+    if (dump) {
         cout << "PDB construction time: " << timer << endl;
+        cout << "PDB entry width: " << distances.get_entry_width()
+             << " bits" << endl;
+        cout << "PDB memory: " << get_memory_usage() / 1024 << " KB" << endl;
+    }
+}
+
+PatternDatabase::PatternDatabase(search_checkpoint::CheckpointReader &reader)
+    : pattern(reader.read_vector<int>()),
+      num_states(reader.read_value<uint64_t>()),
+      distances(reader),
+      min_compression(reader.read_value<int>()) {
+    vector<uint64_t> multipliers = reader.read_vector<uint64_t>();
+    hash_multipliers.assign(multipliers.begin(), multipliers.end());
+    assert(hash_multipliers.size() == pattern.size());
+}
+
+void PatternDatabase::save(search_checkpoint::CheckpointWriter &writer) const {
+    writer.write_vector(pattern);
+    writer.write_value(static_cast<uint64_t>(num_states));
+    distances.save(writer);
+    writer.write_value(min_compression);
+    writer.write_vector(vector<uint64_t>(
+                            hash_multipliers.begin(), hash_multipliers.end()));
 }
 
 void PatternDatabase::multiply_out(
@@ -224,58 +250,128 @@ void PatternDatabase::create_pdb(
         }
     }
 
-    distances.reserve(num_states);
-    // first implicit entry: priority, second entry: index for an abstract state
-    priority_queues::AdaptiveQueue<size_t> pq;
+    vector<int> h_values(num_states, numeric_limits<int>::max());
+    vector<size_t> goal_states = compute_goal_states(abstract_goals, variables);
+    for (size_t state_index : goal_states) {
+        h_values[state_index] = 0;
+    }
 
-    // initialize queue
-    for (size_t state_index = 0; state_index < num_states; ++state_index) {
-        if (is_goal_state(state_index, abstract_goals, variables)) {
-            pq.push(0, state_index);
-            distances.push_back(0);
-        } else {
-            distances.push_back(numeric_limits<int>::max());
+    bool uniform_costs = !operators.empty() && operators[0].get_cost() > 0;
+    for (const AbstractOperator &op : operators) {
+        if (op.get_cost() != operators[0].get_cost()) {
+            uniform_costs = false;
+            break;
         }
     }
-
-    // Dijkstra loop
-    while (!pq.empty()) {
-        pair<int, size_t> node = pq.pop();
-        int distance = node.first;
-        size_t state_index = node.second;
-        if (distance > distances[state_index]) {
-            continue;
+    // Reuse the buffer for the operators applicable in a state.
+    vector<const AbstractOperator *> applicable_operators;
+    if (uniform_costs) {
+        /*
+          With uniform positive costs, the states are reached in order of
+          increasing distance, so a breadth-first search suffices. Each
+          state enters the queue at most once.
+        */
+        int cost = operators[0].get_cost();
+        vector<size_t> &queue = goal_states;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            size_t state_index = queue[head];
+            int predecessor_cost = h_values[state_index] + cost;
+            applicable_operators.clear();
+            match_tree.get_applicable_operators(state_index, applicable_operators);
+            for (const AbstractOperator *op : applicable_operators) {
+                size_t predecessor = state_index + op->get_hash_effect();
+                if (h_values[predecessor] == numeric_limits<int>::max()) {
+                    h_values[predecessor] = predecessor_cost;
+                    queue.push_back(predecessor);
+                }
+            }
         }
+    } else {
+        /*
+          Dijkstra search. While the keys are small, the adaptive queue
+          is a bucket queue.
+        */
+        // first implicit entry: priority, second entry: index for an abstract state
+        priority_queues::AdaptiveQueue<size_t> pq;
+        for (size_t state_index : goal_states) {
+            pq.push(0, state_index);
+        }
+        vector<size_t>().swap(goal_states);
+
+        while (!pq.empty()) {
+            pair<int, size_t> node = pq.pop();
+            int distance = node.first;
+            size_t state_index = node.second;
+            if (distance > h_values[state_index]) {
+                continue;
+            }
 
-        // regress abstract_state
-        vector<const AbstractOperator *> applicable_operators;
-        match_tree.get_applicable_operators(state_index, applicable_operators);
-        for (const AbstractOperator *op : applicable_operators) {
-            size_t predecessor = state_index + op->get_hash_effect();
-            int alternative_cost = distances[state_index] + op->get_cost();
-            if (alternative_cost < distances[predecessor]) {
-                distances[predecessor] = alternative_cost;
-                pq.push(alternative_cost, predecessor);
+            // regress abstract_state
+            applicable_operators.clear();
+            match_tree.get_applicable_operators(state_index, applicable_operators);
+            for (const AbstractOperator *op : applicable_operators) {
+                size_t predecessor = state_index + op->get_hash_effect();
+                int alternative_cost = h_values[state_index] + op->get_cost();
+                if (alternative_cost < h_values[predecessor]) {
+                    h_values[predecessor] = alternative_cost;
+                    pq.push(alternative_cost, predecessor);
+                }
             }
         }
     }
+
+    if (min_compression > 0) {
+        size_t block_size = size_t(1) << min_compression;
+        size_t num_blocks = (num_states + block_size - 1) / block_size;
+        for (size_t block = 0; block < num_blocks; ++block) {
+            auto block_begin = h_values.begin() + block * block_size;
+            auto block_end = h_values.begin() +
+                min(num_states, (block + 1) * block_size);
+            h_values[block] = *min_element(block_begin, block_end);
+        }
+        h_values.resize(num_blocks);
+    }
+    distances = DistanceTable(h_values);
 }
 
-bool PatternDatabase::is_goal_state(
-    const size_t state_index,
+vector<size_t> PatternDatabase::compute_goal_states(
     const vector<FactPair> &abstract_goals,
     const VariablesProxy &variables) const {
+    // Fix the goal variables and enumerate the values of the others.
+    size_t base_index = 0;
+    vector<bool> is_goal_variable(pattern.size(), false);
     for (const FactPair &abstract_goal : abstract_goals) {
-        int pattern_var_id = abstract_goal.var;
-        int var_id = pattern[pattern_var_id];
-        VariableProxy var = variables[var_id];
-        int temp = state_index / hash_multipliers[pattern_var_id];
-        int val = temp % var.get_domain_size();
-        if (val != abstract_goal.value) {
-            return false;
+        base_index += hash_multipliers[abstract_goal.var] * abstract_goal.value;
+        is_goal_variable[abstract_goal.var] = true;
+    }
+    vector<size_t> free_multipliers;
+    vector<int> free_domain_sizes;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        if (!is_goal_variable[i]) {
+            free_multipliers.push_back(hash_multipliers[i]);
+            free_domain_sizes.push_back(variables[pattern[i]].get_domain_size());
         }
     }
-    return true;
+
+    vector<size_t> goal_states;
+    vector<int> free_values(free_multipliers.size(), 0);
+    size_t state_index = base_index;
+    while (true) {
+        goal_states.push_back(state_index);
+        // Increment the values of the free variables like a counter.
+        size_t i = 0;
+        while (i < free_values.size() &&
+               free_values[i] == free_domain_sizes[i] - 1) {
+            state_index -= free_multipliers[i] * free_values[i];
+            free_values[i] = 0;
+            ++i;
+        }
+        if (i == free_values.size())
+            break;
+        ++free_values[i];
+        state_index += free_multipliers[i];
+    }
+    return goal_states;
 }
 
 size_t PatternDatabase::hash_index(const State &state) const {
@@ -287,15 +383,34 @@ size_t PatternDatabase::hash_index(const State &state) const {
 }
 
 int PatternDatabase::get_value(const State &state) const {
-    return distances[hash_index(state)];
+    return distances.get(hash_index(state) >> min_compression);
+}
+
+void PatternDatabase::get_values(
+    const vector<int> &state_values, int num_variables, vector<int> &values) const {
+    assert(state_values.size() % num_variables == 0);
+    int num_states = state_values.size() / num_variables;
+    // Compute the indices in values. They fit into ints (see constructor).
+    values.assign(num_states, 0);
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        int multiplier = hash_multipliers[i];
+        const int *var_values = state_values.data() + pattern[i];
+        for (int state = 0; state < num_states; ++state) {
+            values[state] += multiplier * var_values[state * num_variables];
+        }
+    }
+    for (int state = 0; state < num_states; ++state) {
+        values[state] = distances.get(values[state] >> min_compression);
+    }
 }
 
 double PatternDatabase::compute_mean_finite_h() const {
     double sum = 0;
     int size = 0;
     for (size_t i = 0; i < distances.size(); ++i) {
-        if (distances[i] != numeric_limits<int>::max()) {
-            sum += distances[i];
+        int h = distances.get(i);
+        if (h != numeric_limits<int>::max()) {
+            sum += h;
             ++size;
         }
     }
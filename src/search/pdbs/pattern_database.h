@@ -1,6 +1,7 @@
 #ifndef PDBS_PATTERN_DATABASE_H
 #define PDBS_PATTERN_DATABASE_H
 
+#include "distance_table.h"
 #include "types.h"
 
 #include "../task_proxy.h"
@@ -8,6 +9,11 @@
 #include <utility>
 #include <vector>
 
+namespace search_checkpoint {
+class CheckpointReader;
+class CheckpointWriter;
+}
+
 namespace pdbs {
 class AbstractOperator {
     /*
@@ -79,8 +85,12 @@ class PatternDatabase {
     /*
       final h-values for abstract-states.
       dead-ends are represented by numeric_limits<int>::max()
+      With min-compression, entry i holds the minimum h-value of the
+      abstract states with indices i * 2^min_compression, ...,
+      (i + 1) * 2^min_compression - 1.
     */
-    std::vector<int> distances;
+    DistanceTable distances;
+    int min_compression;
 
     // multipliers for each variable for perfect hash function
     std::vector<std::size_t> hash_multipliers;
@@ -115,23 +125,22 @@ class PatternDatabase {
 
     /*
       Computes all abstract operators, builds the match tree (successor
-      generator) and then does a Dijkstra regression search to compute
+      generator) and then does a Dijkstra regression search (a
+      breadth-first search if all operators have the same cost) to compute
       all final h-values (stored in distances). operator_costs can
       specify individual operator costs for each operator for action
       cost partitioning. If left empty, default operator costs are used.
+      The h-values are then compressed (see DistanceTable).
     */
     void create_pdb(
         const TaskProxy &task_proxy,
         const std::vector<int> &operator_costs = std::vector<int>());
 
     /*
-      For a given abstract state (given as index), the according values
-      for each variable in the state are computed and compared with the
-      given pairs of goal variables and values. Returns true iff the
-      state is a goal state.
+      Returns the indices of all abstract states that satisfy the given
+      pairs of goal variables and values, in increasing order.
     */
-    bool is_goal_state(
-        const std::size_t state_index,
+    std::vector<std::size_t> compute_goal_states(
         const std::vector<FactPair> &abstract_goals,
         const VariablesProxy &variables) const;
 
@@ -151,16 +160,35 @@ public:
        operator_costs: Can specify individual operator costs for each
        operator. This is useful for action cost partitioning. If left
        empty, default operator costs are used.
+       min_compression: If positive, blocks of 2^min_compression
+       adjacent entries are merged into one entry holding their minimum.
+       This saves memory, but the PDB is no longer consistent and
+       detects fewer dead ends.
     */
     PatternDatabase(
         const TaskProxy &task_proxy,
         const Pattern &pattern,
         bool dump = false,
-        const std::vector<int> &operator_costs = std::vector<int>());
+        const std::vector<int> &operator_costs = std::vector<int>(),
+        int min_compression = 0);
+    // Read a PDB written by save (see task_utils/precomputation_cache.h).
+    explicit PatternDatabase(search_checkpoint::CheckpointReader &reader);
     ~PatternDatabase() = default;
 
+    void save(search_checkpoint::CheckpointWriter &writer) const;
+
     int get_value(const State &state) const;
 
+    /*
+      Compute the values of several states at once. state_values
+      contains the values of all num_variables variables of the first
+      state, followed by those of the second state, etc. The loops run
+      over all states for one pattern variable at a time, so that the
+      compiler can vectorize them.
+    */
+    void get_values(const std::vector<int> &state_values, int num_variables,
+                    std::vector<int> &values) const;
+
     // Returns the pattern (i.e. all variables used) of the PDB
     const Pattern &get_pattern() const {
         return pattern;
@@ -171,6 +199,30 @@ public:
         return num_states;
     }
 
+    // Returns the multipliers of the pattern variables for the hash function
+    const std::vector<std::size_t> &get_hash_multipliers() const {
+        return hash_multipliers;
+    }
+
+    /*
+      Moves the (possibly min-compressed) h-values of all abstract states
+      out of the PDB. Afterwards, the PDB can no longer be evaluated.
+    */
+    DistanceTable release_distances() {
+        DistanceTable result = std::move(distances);
+        distances = DistanceTable();
+        return result;
+    }
+
+    int get_min_compression() const {
+        return min_compression;
+    }
+
+    // Returns the number of bytes used by the h-values
+    std::size_t get_memory_usage() const {
+        return distances.get_memory_usage();
+    }
+
     /*
       Returns the average h-value over all states, where dead-ends are
       ignored (they neither increase the sum of all h-values nor the
@@ -0,0 +1,94 @@
+#include "pdb_cache.h"
+
+#include "pattern_database.h"
+
+#include "../task_proxy.h"
+
+#include "../utils/collections.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+using namespace std;
+
+namespace pdbs {
+PDBCache::PDBCache(size_t max_memory)
+    : max_memory(max_memory),
+      memory_usage(0),
+      num_lookups(0),
+      num_hits(0),
+      num_evictions(0) {
+}
+
+void PDBCache::evict_least_recently_used() {
+    assert(!lru_order.empty());
+    auto it = entries.find(*lru_order.front());
+    assert(it != entries.end());
+    memory_usage -= it->second.memory;
+    lru_order.pop_front();
+    entries.erase(it);
+    ++num_evictions;
+}
+
+shared_ptr<PatternDatabase> PDBCache::get_pdb(
+    const TaskProxy &task_proxy, const Pattern &pattern,
+    const vector<int> &operator_costs) {
+    assert(utils::is_sorted_unique(pattern));
+    Key key;
+    key.first = pattern;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        for (EffectProxy effect : op.get_effects()) {
+            int var_id = effect.get_fact().get_variable().get_id();
+            if (binary_search(pattern.begin(), pattern.end(), var_id)) {
+                key.second.push_back(operator_costs[op.get_id()]);
+                break;
+            }
+        }
+    }
+
+    {
+        lock_guard<mutex> lock(cache_mutex);
+        ++num_lookups;
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            ++num_hits;
+            Entry &entry = it->second;
+            lru_order.splice(lru_order.end(), lru_order, entry.lru_position);
+            return entry.pdb;
+        }
+    }
+
+    /*
+      Build the PDB without holding the lock, so that other threads can
+      use the cache in the meantime. If another thread builds the same
+      PDB concurrently, we keep the PDB that is inserted first.
+    */
+    shared_ptr<PatternDatabase> pdb = make_shared<PatternDatabase>(
+        task_proxy, pattern, false, operator_costs);
+    size_t memory = pdb->get_memory_usage() +
+        (key.first.capacity() + key.second.capacity()) * sizeof(int);
+    if (memory > max_memory)
+        return pdb;
+
+    lock_guard<mutex> lock(cache_mutex);
+    auto result = entries.insert(make_pair(move(key), Entry {pdb, memory, {}}));
+    if (!result.second) {
+        return result.first->second.pdb;
+    }
+    while (memory_usage + memory > max_memory) {
+        evict_least_recently_used();
+    }
+    memory_usage += memory;
+    result.first->second.lru_position =
+        lru_order.insert(lru_order.end(), &result.first->first);
+    return pdb;
+}
+
+void PDBCache::print_statistics() const {
+    lock_guard<mutex> lock(cache_mutex);
+    cout << "PDB cache: " << num_hits << "/" << num_lookups << " hits, "
+         << num_evictions << " evictions, " << entries.size()
+         << " PDBs using " << memory_usage / 1024 << " KB" << endl;
+}
+}
@@ -0,0 +1,68 @@
+#ifndef PDBS_PDB_CACHE_H
+#define PDBS_PDB_CACHE_H
+
+#include "types.h"
+
+#include "../utils/hash.h"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class TaskProxy;
+
+namespace pdbs {
+/*
+  Cache for PDBs that are built over and over again, e.g., for the
+  patterns of the genetic pattern generator. A PDB is identified by its
+  pattern (in normal form) and the costs of the operators that are
+  relevant to the pattern, since the costs of all other operators do not
+  influence the PDB.
+
+  The cache keeps the PDBs as long as their memory usage fits into the
+  given budget and evicts the least recently used PDB otherwise. All
+  methods may be called from several threads at the same time.
+*/
+class PDBCache {
+    // Pattern and costs of the relevant operators in the order of their IDs.
+    using Key = std::pair<Pattern, std::vector<int>>;
+    struct Entry {
+        std::shared_ptr<PatternDatabase> pdb;
+        std::size_t memory;
+        std::list<const Key *>::iterator lru_position;
+    };
+
+    const std::size_t max_memory;
+    std::size_t memory_usage;
+    utils::HashMap<Key, Entry> entries;
+    // Keys of all entries, from least to most recently used.
+    std::list<const Key *> lru_order;
+    mutable std::mutex cache_mutex;
+
+    // for stats only
+    int num_lookups;
+    int num_hits;
+    int num_evictions;
+
+    void evict_least_recently_used();
+public:
+    // max_memory is given in bytes. A budget of 0 disables the cache.
+    explicit PDBCache(std::size_t max_memory);
+    ~PDBCache() = default;
+
+    /*
+      Return the PDB for the given pattern (sorted, without duplicates) and
+      operator costs. The PDB is built if it is not in the cache.
+    */
+    std::shared_ptr<PatternDatabase> get_pdb(
+        const TaskProxy &task_proxy, const Pattern &pattern,
+        const std::vector<int> &operator_costs);
+
+    void print_statistics() const;
+};
+}
+
+#endif
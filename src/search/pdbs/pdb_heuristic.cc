@@ -6,19 +6,39 @@
 #include "../plugin.h"
 #include "../task_proxy.h"
 
+#include "../task_utils/precomputation_cache.h"
+
 #include <limits>
 #include <memory>
+#include <vector>
 
 using namespace std;
 
 namespace pdbs {
 PatternDatabase get_pdb_from_options(const shared_ptr<AbstractTask> &task,
                                      const Options &opts) {
+    TaskProxy task_proxy(*task);
+    unique_ptr<search_checkpoint::CheckpointReader> reader =
+        precomputation_cache::open_entry(
+            "pdb", task_proxy, opts.get_unparsed_config());
+    if (reader) {
+        return PatternDatabase(*reader);
+    }
+
     shared_ptr<PatternGenerator> pattern_generator =
         opts.get<shared_ptr<PatternGenerator>>("pattern");
     Pattern pattern = pattern_generator->generate(task);
-    TaskProxy task_proxy(*task);
-    return PatternDatabase(task_proxy, pattern, true);
+    PatternDatabase pdb(task_proxy, pattern, true, vector<int>(),
+                        opts.get<int>("min_compression"));
+
+    unique_ptr<search_checkpoint::CheckpointWriter> writer =
+        precomputation_cache::create_entry(
+            "pdb", task_proxy, opts.get_unparsed_config());
+    if (writer) {
+        pdb.save(*writer);
+        writer->commit();
+    }
+    return pdb;
 }
 
 PDBHeuristic::PDBHeuristic(const Options &opts)
@@ -38,13 +58,24 @@ int PDBHeuristic::compute_heuristic(const State &state) const {
     return h;
 }
 
+bool PDBHeuristic::compute_heuristic_batch(
+    const vector<GlobalState> &states, vector<int> &values) {
+    convert_global_states(states, batch_state_values);
+    pdb.get_values(batch_state_values, task_proxy.get_variables().size(), values);
+    for (int &h : values) {
+        if (h == numeric_limits<int>::max())
+            h = DEAD_END;
+    }
+    return true;
+}
+
 static Heuristic *_parse(OptionParser &parser) {
     parser.document_synopsis("Pattern database heuristic", "TODO");
     parser.document_language_support("action costs", "supported");
     parser.document_language_support("conditional effects", "not supported");
     parser.document_language_support("axioms", "not supported");
     parser.document_property("admissible", "yes");
-    parser.document_property("consistent", "yes");
+    parser.document_property("consistent", "yes (without min_compression)");
     parser.document_property("safe", "yes");
     parser.document_property("preferred operators", "no");
 
@@ -52,6 +83,14 @@ static Heuristic *_parse(OptionParser &parser) {
         "pattern",
         "pattern generation method",
         "greedy()");
+    parser.add_option<int>(
+        "min_compression",
+        "merge blocks of 2^min_compression adjacent PDB entries into one "
+        "entry holding their minimum. This reduces the memory of the PDB, "
+        "but the heuristic is then no longer guaranteed to be consistent "
+        "and may detect fewer dead ends.",
+        "0",
+        Bounds("0", "20"));
     Heuristic::add_options_to_parser(parser);
 
     Options opts = parser.parse();
@@ -16,6 +16,8 @@ namespace pdbs {
 // Implements a heuristic for a single PDB.
 class PDBHeuristic : public Heuristic {
     PatternDatabase pdb;
+    // Buffer for batch evaluation.
+    std::vector<int> batch_state_values;
 protected:
     virtual int compute_heuristic(const GlobalState &global_state) override;
     /* TODO: we want to get rid of compute_heuristic(const GlobalState &state)
@@ -23,6 +25,9 @@ protected:
        this, the following method already allows to get the heuristic value
        for a State object. */
     int compute_heuristic(const State &state) const;
+    virtual bool compute_heuristic_batch(
+        const std::vector<GlobalState> &states,
+        std::vector<int> &values) override;
 public:
     /*
       Important: It is assumed that the pattern (passed via Options) is
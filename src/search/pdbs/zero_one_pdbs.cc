@@ -1,6 +1,7 @@
 #include "zero_one_pdbs.h"
 
 #include "pattern_database.h"
+#include "pdb_cache.h"
 
 #include "../task_proxy.h"
 
@@ -14,18 +15,26 @@
 using namespace std;
 
 namespace pdbs {
-ZeroOnePDBs::ZeroOnePDBs(
-    const TaskProxy &task_proxy, const PatternCollection &patterns) {
+PDBCollection compute_zero_one_pdbs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    PDBCache *pdb_cache) {
     vector<int> remaining_operator_costs;
     OperatorsProxy operators = task_proxy.get_operators();
     remaining_operator_costs.reserve(operators.size());
     for (OperatorProxy op : operators)
         remaining_operator_costs.push_back(op.get_cost());
 
+    PDBCollection pattern_databases;
     pattern_databases.reserve(patterns.size());
     for (const Pattern &pattern : patterns) {
-        shared_ptr<PatternDatabase> pdb = make_shared<PatternDatabase>(
-            task_proxy, pattern, false, remaining_operator_costs);
+        shared_ptr<PatternDatabase> pdb;
+        if (pdb_cache) {
+            pdb = pdb_cache->get_pdb(
+                task_proxy, pattern, remaining_operator_costs);
+        } else {
+            pdb = make_shared<PatternDatabase>(
+                task_proxy, pattern, false, remaining_operator_costs);
+        }
 
         /* Set cost of relevant operators to 0 for further iterations
            (action cost partitioning). */
@@ -36,35 +45,40 @@ ZeroOnePDBs::ZeroOnePDBs(
 
         pattern_databases.push_back(pdb);
     }
+    return pattern_databases;
 }
 
+ZeroOnePDBs::ZeroOnePDBs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns)
+    : ZeroOnePDBs(compute_zero_one_pdbs(task_proxy, patterns)) {
+}
 
-int ZeroOnePDBs::get_value(const State &state) const {
+ZeroOnePDBs::ZeroOnePDBs(const PDBCollection &pattern_databases)
+    : pdbs(MaxAdditivePDBSubsets {pattern_databases}) {
     /*
       Because we use cost partitioning, we can simply add up all
       heuristic values of all patterns in the pattern collection.
     */
-    int h_val = 0;
     for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
-        int pdb_value = pdb->get_value(state);
-        if (pdb_value == numeric_limits<int>::max())
-            return numeric_limits<int>::max();
-        h_val += pdb_value;
+        patterns.push_back(pdb->get_pattern());
     }
-    return h_val;
+}
+
+int ZeroOnePDBs::get_value(const State &state) const {
+    return pdbs.get_value(state.get_values());
 }
 
 double ZeroOnePDBs::compute_approx_mean_finite_h() const {
     double approx_mean_finite_h = 0;
-    for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
-        approx_mean_finite_h += pdb->compute_mean_finite_h();
+    for (int i = 0; i < pdbs.get_num_pdbs(); ++i) {
+        approx_mean_finite_h += pdbs.compute_mean_finite_h(i);
     }
     return approx_mean_finite_h;
 }
 
 void ZeroOnePDBs::dump() const {
-    for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
-        cout << pdb->get_pattern() << endl;
+    for (const Pattern &pattern : patterns) {
+        cout << pattern << endl;
     }
 }
 }
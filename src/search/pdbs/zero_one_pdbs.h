@@ -1,16 +1,33 @@
 #ifndef PDBS_ZERO_ONE_PDBS_H
 #define PDBS_ZERO_ONE_PDBS_H
 
+#include "compiled_pdb_collection.h"
 #include "types.h"
 
 class State;
 class TaskProxy;
 
 namespace pdbs {
+class PDBCache;
+
+/*
+  Build one PDB per pattern, where each PDB uses the operator costs that
+  are left after all PDBs for previous patterns have been built (zero-one
+  cost partitioning). If pdb_cache is given, PDBs are taken from it
+  where possible.
+*/
+extern PDBCollection compute_zero_one_pdbs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    PDBCache *pdb_cache = nullptr);
+
 class ZeroOnePDBs {
-    PDBCollection pattern_databases;
+    PatternCollection patterns;
+    // All PDBs form a single additive subset.
+    CompiledPDBCollection pdbs;
 public:
     ZeroOnePDBs(const TaskProxy &task_proxy, const PatternCollection &patterns);
+    // Use PDBs that were computed by compute_zero_one_pdbs before.
+    explicit ZeroOnePDBs(const PDBCollection &pattern_databases);
     ~ZeroOnePDBs() = default;
 
     int get_value(const State &state) const;
@@ -1,23 +1,51 @@
 #include "zero_one_pdbs_heuristic.h"
 
+#include "pattern_database.h"
 #include "pattern_generator.h"
 
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../task_utils/precomputation_cache.h"
+
 using namespace std;
 
 namespace pdbs {
 ZeroOnePDBs get_zero_one_pdbs_from_options(
     const shared_ptr<AbstractTask> &task, const Options &opts) {
+    TaskProxy task_proxy(*task);
+    unique_ptr<search_checkpoint::CheckpointReader> reader =
+        precomputation_cache::open_entry(
+            "zopdbs", task_proxy, opts.get_unparsed_config());
+    if (reader) {
+        int num_pdbs = reader->read_value<int>();
+        PDBCollection pdbs;
+        pdbs.reserve(num_pdbs);
+        for (int i = 0; i < num_pdbs; ++i) {
+            pdbs.push_back(make_shared<PatternDatabase>(*reader));
+        }
+        return ZeroOnePDBs(pdbs);
+    }
+
     shared_ptr<PatternCollectionGenerator> pattern_generator =
         opts.get<shared_ptr<PatternCollectionGenerator>>("patterns");
     PatternCollectionInformation pattern_collection_info =
         pattern_generator->generate(task);
     shared_ptr<PatternCollection> patterns =
         pattern_collection_info.get_patterns();
-    TaskProxy task_proxy(*task);
-    return ZeroOnePDBs(task_proxy, *patterns);
+    PDBCollection pdbs = compute_zero_one_pdbs(task_proxy, *patterns);
+
+    unique_ptr<search_checkpoint::CheckpointWriter> writer =
+        precomputation_cache::create_entry(
+            "zopdbs", task_proxy, opts.get_unparsed_config());
+    if (writer) {
+        writer->write_value(static_cast<int>(pdbs.size()));
+        for (const shared_ptr<PatternDatabase> &pdb : pdbs) {
+            pdb->save(*writer);
+        }
+        writer->commit();
+    }
+    return ZeroOnePDBs(pdbs);
 }
 
 ZeroOnePDBsHeuristic::ZeroOnePDBsHeuristic(
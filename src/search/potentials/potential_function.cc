@@ -26,4 +26,27 @@ int PotentialFunction::get_value(const State &state) const {
     const double epsilon = 0.01;
     return static_cast<int>(ceil(heuristic_value - epsilon));
 }
+
+void PotentialFunction::get_values(
+    const vector<int> &state_values, vector<int> &values) const {
+    int num_variables = fact_potentials.size();
+    assert(state_values.size() % num_variables == 0);
+    int num_states = state_values.size() / num_variables;
+    // Sum up the potentials in the same order as get_value.
+    vector<double> heuristic_values(num_states, 0.0);
+    for (int var = 0; var < num_variables; ++var) {
+        const vector<double> &potentials = fact_potentials[var];
+        const int *var_values = state_values.data() + var;
+        for (int state = 0; state < num_states; ++state) {
+            int value = var_values[state * num_variables];
+            assert(utils::in_bounds(value, potentials));
+            heuristic_values[state] += potentials[value];
+        }
+    }
+    const double epsilon = 0.01;
+    values.resize(num_states);
+    for (int state = 0; state < num_states; ++state) {
+        values[state] = static_cast<int>(ceil(heuristic_values[state] - epsilon));
+    }
+}
 }
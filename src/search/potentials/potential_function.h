@@ -21,6 +21,14 @@ public:
     ~PotentialFunction() = default;
 
     int get_value(const State &state) const;
+
+    /*
+      Compute the values of several states at once. state_values
+      contains the values of all variables of the first state, followed
+      by those of the second state, etc.
+    */
+    void get_values(const std::vector<int> &state_values,
+                    std::vector<int> &values) const;
 };
 }
 
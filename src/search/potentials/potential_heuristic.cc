@@ -20,4 +20,14 @@ int PotentialHeuristic::compute_heuristic(const GlobalState &global_state) {
     const State state = convert_global_state(global_state);
     return max(0, function->get_value(state));
 }
+
+bool PotentialHeuristic::compute_heuristic_batch(
+    const vector<GlobalState> &states, vector<int> &values) {
+    convert_global_states(states, batch_state_values);
+    function->get_values(batch_state_values, values);
+    for (int &h : values) {
+        h = max(0, h);
+    }
+    return true;
+}
 }
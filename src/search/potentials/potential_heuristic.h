@@ -4,6 +4,7 @@
 #include "../heuristic.h"
 
 #include <memory>
+#include <vector>
 
 namespace potentials {
 class PotentialFunction;
@@ -13,9 +14,14 @@ class PotentialFunction;
 */
 class PotentialHeuristic : public Heuristic {
     std::unique_ptr<PotentialFunction> function;
+    // Buffer for batch evaluation.
+    std::vector<int> batch_state_values;
 
 protected:
     virtual int compute_heuristic(const GlobalState &global_state) override;
+    virtual bool compute_heuristic_batch(
+        const std::vector<GlobalState> &states,
+        std::vector<int> &values) override;
 
 public:
     explicit PotentialHeuristic(
@@ -29,7 +29,8 @@ SearchEngine::SearchEngine(const Options &opts)
       task(g_root_task()),
       task_proxy(*task),
       state_registry(
-          *task, *g_state_packer, *g_axiom_evaluator, g_initial_state_data),
+          *task, *g_state_packer, *g_axiom_evaluator, g_initial_state_data,
+          opts.get<bool>("incremental_state_hashing")),
       search_space(state_registry,
                    static_cast<OperatorCost>(opts.get_enum("cost_type"))),
       cost_type(static_cast<OperatorCost>(opts.get_enum("cost_type"))),
@@ -134,6 +135,15 @@ void SearchEngine::add_options_to_parser(OptionParser &parser) {
         "experiments. Timed-out searches are treated as failed searches, "
         "just like incomplete search algorithms that exhaust their search space.",
         "infinity");
+    parser.add_option<bool>(
+        "incremental_state_hashing",
+        "hash states for duplicate detection with Zobrist hashing: each fact "
+        "has a random key and the hash value of a successor state is derived "
+        "from the hash value of its predecessor and the facts changed by the "
+        "operator, instead of hashing the complete successor state. This "
+        "costs 4 additional bytes per state and pays off for tasks with many "
+        "state variables.",
+        "false");
 }
 
 /* Method doesn't belong here because it's only useful for certain derived classes.
@@ -1,5 +1,7 @@
 #include "eager_search.h"
 
+#include "search_checkpoint.h"
+
 #include "../evaluation_context.h"
 #include "../globals.h"
 #include "../heuristic.h"
@@ -9,17 +11,37 @@
 
 #include "../algorithms/ordered_set.h"
 #include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/memory.h"
+#include "../utils/system.h"
 
 #include "../structural_symmetries/group.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <memory>
 #include <set>
 
 using namespace std;
 
 namespace eager_search {
+static const uint32_t CHECKPOINT_MAGIC = 0x46444350;
+static const uint32_t CHECKPOINT_VERSION = 2;
+// Number of open nodes that are evaluated together when resuming a search.
+static const int RESUME_BATCH_SIZE = 1024;
+// Written for heuristics that have not cached the h value of a state.
+static const int NO_CACHED_ESTIMATE = numeric_limits<int>::min();
+
+static void exit_with_corrupt_checkpoint(const string &checkpoint_file) {
+    cerr << "Checkpoint " << checkpoint_file << " is corrupt." << endl;
+    utils::exit_with(utils::ExitCode::INPUT_ERROR);
+}
+
 EagerSearch::EagerSearch(const Options &opts)
     : SearchEngine(opts),
       reopen_closed_nodes(opts.get<bool>("reopen_closed")),
@@ -30,7 +52,10 @@ EagerSearch::EagerSearch(const Options &opts)
       preferred_operator_heuristics(opts.get_list<Heuristic *>("preferred")),
       pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")),
       num_por_probes(opts.get<int>("num_por_probes")),
-      pruning_disabled(false) {
+      pruning_disabled(false),
+      checkpoint_file(opts.contains("checkpoint") ?
+                      opts.get<string>("checkpoint") : ""),
+      checkpoint_memory_in_mb(opts.get<int>("checkpoint_memory")) {
     if (opts.contains("symmetries")) {
         group = opts.get<shared_ptr<Group>>("symmetries");
         if (group && !group->is_initialized()) {
@@ -45,6 +70,13 @@ EagerSearch::EagerSearch(const Options &opts)
     } else {
         group = nullptr;
     }
+    if (use_dks() && !checkpoint_file.empty()) {
+        cerr << "Checkpoints are not supported with DKS." << endl;
+        utils::exit_with(utils::ExitCode::UNSUPPORTED);
+    }
+}
+
+EagerSearch::~EagerSearch() {
 }
 
 bool EagerSearch::use_oss() const {
@@ -85,6 +117,15 @@ void EagerSearch::initialize() {
     if (use_oss() || use_dks()) {
         assert(heuristics.size() == 1);
     }
+
+    if (!checkpoint_file.empty()) {
+        checkpoint_timer = utils::make_unique_ptr<utils::CountdownTimer>(max_time);
+        if (search_checkpoint::checkpoint_exists(checkpoint_file)) {
+            load_checkpoint();
+            return;
+        }
+    }
+
     // Changed to copy the state to be able to reassign it.
     GlobalState initial_state = state_registry.get_initial_state();
     if (use_oss()) {
@@ -110,7 +151,7 @@ void EagerSearch::initialize() {
         SearchNode node = search_space.get_node(initial_state);
         node.open_initial();
 
-        open_list->insert(eval_context, initial_state.get_id());
+        insert_into_open_list(eval_context);
     }
 
     print_initial_h_values(eval_context);
@@ -127,21 +168,32 @@ void EagerSearch::print_checkpoint_line(int g) const {
 void EagerSearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
+    for (Heuristic *heuristic : heuristics) {
+        heuristic->print_statistics();
+    }
     if (!pruning_disabled) {
         pruning_method->print_statistics();
     }
 }
 
 SearchStatus EagerSearch::step() {
+    if (checkpoint_timer && should_suspend()) {
+        save_checkpoint();
+        return TIMEOUT;
+    }
+
     pair<SearchNode, bool> n = fetch_next_node();
     if (!n.second) {
+        remove_checkpoint();
         return FAILED;
     }
     SearchNode node = n.first;
 
     GlobalState s = node.get_state();
-    if (check_goal_and_set_plan(s, group))
+    if (check_goal_and_set_plan(s, group)) {
+        remove_checkpoint();
         return SOLVED;
+    }
 
     vector<OperatorID> applicable_ops;
     g_successor_generator->generate_applicable_ops(s, applicable_ops);
@@ -168,27 +220,21 @@ SearchStatus EagerSearch::step() {
     ordered_set::OrderedSet<OperatorID> preferred_operators =
         collect_preferred_operators(eval_context, preferred_operator_heuristics);
 
+    /*
+      We first generate all successors and collect the ones that need to
+      be inserted into the open list. Then we let the heuristics evaluate
+      them together, and finally insert them in the order of generation.
+    */
+    pending_successors.clear();
     for (OperatorID op_id : applicable_ops) {
         OperatorProxy op = task_proxy.get_operators()[op_id];
         if ((node.get_real_g() + op.get_cost()) >= bound)
             continue;
 
-        /*
-          NOTE: In orbit search tmp_registry has to survive as long as
-                succ_state is used. This could be forever, but for heuristics
-                that do not store per state information it is ok to keep it
-                only for this operator application. In regular search it is not
-                actually needed, but I don't see a way around having it there,
-                too.
-        */
-        StateRegistry tmp_registry(*task, *g_state_packer,
-                                   *g_axiom_evaluator, g_initial_state_data);
-        StateRegistry *successor_registry = use_oss() ? &tmp_registry : &state_registry;
-        GlobalState succ_state = successor_registry->get_successor_state(s, op);
-        if (use_oss()) {
-            vector<int> canonical_state = group->get_canonical_representative(succ_state);
-            succ_state = state_registry.register_state_buffer(canonical_state);
-        }
+        // In orbit search, we only register the canonical successor.
+        GlobalState succ_state = use_oss() ?
+            state_registry.get_canonical_successor_state(s, op, *group) :
+            state_registry.get_successor_state(s, op);
         statistics.inc_generated();
         bool is_preferred = preferred_operators.contains(op_id);
 
@@ -207,7 +253,7 @@ SearchStatus EagerSearch::step() {
 
         if (succ_node.is_new()) {
             // We have not seen this state before.
-            // Evaluate and create a new node.
+            // Open it now and evaluate it below.
 
             // Careful: succ_node.get_g() is not available here yet,
             // hence the stupid computation of succ_g.
@@ -220,22 +266,9 @@ SearchStatus EagerSearch::step() {
               initialized with one state and the insertion was performed with
               another state.
              */
-            EvaluationContext eval_context(
-                succ_state, succ_g, is_preferred, &statistics);
-            statistics.inc_evaluated_states();
-
-            if (open_list->is_dead_end(eval_context)) {
-                succ_node.mark_as_dead_end();
-                statistics.inc_dead_ends();
-                continue;
-            }
             succ_node.open(node, op);
-
-            open_list->insert(eval_context, succ_state.get_id());
-            if (search_progress.check_progress(eval_context)) {
-                print_checkpoint_line(succ_node.get_g());
-                reward_progress();
-            }
+            pending_successors.push_back(
+                PendingSuccessor(succ_state, succ_g, is_preferred, true));
         } else if (succ_node.get_g() > node.get_g() + get_adjusted_cost(op)) {
             // We found a new cheapest path to an open or closed state.
             if (reopen_closed_nodes) {
@@ -251,9 +284,6 @@ SearchStatus EagerSearch::step() {
                 }
                 succ_node.reopen(node, op);
 
-                EvaluationContext eval_context(
-                    succ_state, succ_node.get_g(), is_preferred, &statistics);
-
                 /*
                   Note: our old code used to retrieve the h value from
                   the search node here. Our new code recomputes it as
@@ -271,7 +301,8 @@ SearchStatus EagerSearch::step() {
                   rather than a recomputation of the heuristic value
                   from scratch.
                 */
-                open_list->insert(eval_context, succ_state.get_id());
+                pending_successors.push_back(
+                    PendingSuccessor(succ_state, succ_node.get_g(), is_preferred, false));
             } else {
                 // If we do not reopen closed nodes, we just update the parent pointers.
                 // Note that this could cause an incompatibility between
@@ -281,6 +312,37 @@ SearchStatus EagerSearch::step() {
         }
     }
 
+    succ_eval_contexts.clear();
+    for (const PendingSuccessor &succ : pending_successors) {
+        succ_eval_contexts.emplace_back(
+            succ.state, succ.g, succ.is_preferred, &statistics);
+    }
+    if (!succ_eval_contexts.empty()) {
+        for (Heuristic *heuristic : heuristics) {
+            heuristic->compute_results(succ_eval_contexts);
+        }
+    }
+
+    for (size_t i = 0; i < pending_successors.size(); ++i) {
+        const PendingSuccessor &succ = pending_successors[i];
+        EvaluationContext &succ_eval_context = succ_eval_contexts[i];
+        if (succ.is_new) {
+            statistics.inc_evaluated_states();
+            if (open_list->is_dead_end(succ_eval_context)) {
+                search_space.get_node(succ.state).mark_as_dead_end();
+                statistics.inc_dead_ends();
+                continue;
+            }
+            insert_into_open_list(succ_eval_context);
+            if (search_progress.check_progress(succ_eval_context)) {
+                print_checkpoint_line(succ.g);
+                reward_progress();
+            }
+        } else {
+            insert_into_open_list(succ_eval_context);
+        }
+    }
+
     return IN_PROGRESS;
 }
 
@@ -331,7 +393,7 @@ pair<SearchNode, bool> EagerSearch::fetch_next_node() {
                 }
                 if (pushed_h < eval_context.get_result(heuristics[0]).get_h_value()) {
                     assert(node.is_open());
-                    open_list->insert(eval_context, node.get_state_id());
+                    insert_into_open_list(eval_context);
                     continue;
                 }
             }
@@ -345,12 +407,286 @@ pair<SearchNode, bool> EagerSearch::fetch_next_node() {
     }
 }
 
+void EagerSearch::insert_into_open_list(EvaluationContext &eval_context) {
+    const GlobalState &state = eval_context.get_state();
+    if (!checkpoint_file.empty()) {
+        reached_by_preferred_operator[state] = eval_context.is_preferred();
+    }
+    open_list->insert(eval_context, state.get_id());
+}
+
 void EagerSearch::reward_progress() {
     // Boost the "preferred operator" open lists somewhat whenever
     // one of the heuristics finds a state with a new best h value.
     open_list->boost_preferred();
 }
 
+/*
+  Our timer starts before the one of SearchEngine::search, so we suspend
+  the search before it times out.
+*/
+bool EagerSearch::should_suspend() const {
+    if (checkpoint_timer->is_expired())
+        return true;
+    if (checkpoint_memory_in_mb == numeric_limits<int>::max())
+        return false;
+    // Reading the memory usage is expensive, so we only do it occasionally.
+    const int EXPANSIONS_PER_MEMORY_CHECK = 1000;
+    return statistics.get_expanded() % EXPANSIONS_PER_MEMORY_CHECK == 0 &&
+           utils::get_resident_memory_in_kb() / 1024 >= checkpoint_memory_in_mb;
+}
+
+void EagerSearch::save_checkpoint() {
+    cout << "Suspending search: writing checkpoint to " << checkpoint_file
+         << endl;
+    search_checkpoint::CheckpointWriter writer(checkpoint_file);
+    writer.write_value(CHECKPOINT_MAGIC);
+    writer.write_value(CHECKPOINT_VERSION);
+    writer.write_value(task_properties::compute_task_hash(task_proxy));
+    writer.write_value(state_registry.get_state_size_in_bytes());
+    writer.write_value(static_cast<int>(sizeof(SearchNodeInfo)));
+
+    writer.write_value(statistics.get_expanded());
+    writer.write_value(statistics.get_evaluated_states());
+    writer.write_value(statistics.get_evaluations());
+    writer.write_value(statistics.get_generated());
+    writer.write_value(statistics.get_reopened());
+    writer.write_value(statistics.get_generated_ops());
+    writer.write_value(statistics.get_dead_ends());
+    writer.write_value(static_cast<int>(pruning_disabled));
+
+    int num_states = state_registry.size();
+    writer.write_value(num_states);
+    int state_size = state_registry.get_state_size_in_bytes();
+    for (StateID id : state_registry) {
+        writer.write(state_registry.get_packed_state(id), state_size);
+    }
+    for (StateID id : state_registry) {
+        GlobalState state = state_registry.lookup_state(id);
+        writer.write_value(search_space.get_node(state).get_info());
+    }
+
+    /*
+      Remove the entries from the open list in the order in which the
+      search would expand them, so that the resumed search can insert
+      them in the same order. Entries of closed nodes and repeated
+      entries of a node are skipped. The search stops after writing the
+      checkpoint, so it does not need the open list any more.
+    */
+    vector<StateID> open_states;
+    PerStateInformation<int> open_positions(-1);
+    while (!open_list->empty()) {
+        GlobalState state = state_registry.lookup_state(open_list->remove_min());
+        if (search_space.get_node(state).is_open() && open_positions[state] == -1) {
+            open_positions[state] = open_states.size();
+            open_states.push_back(state.get_id());
+        }
+    }
+    writer.write_value(static_cast<int>(open_states.size()));
+    for (StateID id : state_registry) {
+        writer.write_value(open_positions[state_registry.lookup_state(id)]);
+    }
+    vector<uint8_t> preferred_flags;
+    preferred_flags.reserve(open_states.size());
+    for (StateID id : open_states) {
+        preferred_flags.push_back(
+            reached_by_preferred_operator[state_registry.lookup_state(id)]);
+    }
+    writer.write_vector(preferred_flags);
+
+    // The heuristics are identified by their descriptions.
+    writer.write_value(static_cast<int>(heuristics.size()));
+    for (Heuristic *heuristic : heuristics) {
+        const string &description = heuristic->get_description();
+        writer.write_vector(vector<char>(description.begin(), description.end()));
+        vector<int> h_values;
+        h_values.reserve(open_states.size());
+        for (StateID id : open_states) {
+            GlobalState state = state_registry.lookup_state(id);
+            if (heuristic->is_estimate_cached(state)) {
+                h_values.push_back(heuristic->get_cached_estimate(state));
+            } else {
+                h_values.push_back(NO_CACHED_ESTIMATE);
+            }
+        }
+        writer.write_vector(h_values);
+    }
+    writer.commit();
+    cout << "Wrote checkpoint with " << num_states << " states ("
+         << writer.get_bytes_written() << " bytes)." << endl;
+}
+
+void EagerSearch::load_checkpoint() {
+    cout << "Resuming search from checkpoint " << checkpoint_file << endl;
+    search_checkpoint::CheckpointReader reader(checkpoint_file);
+    if (reader.read_value<uint32_t>() != CHECKPOINT_MAGIC ||
+        reader.read_value<uint32_t>() != CHECKPOINT_VERSION ||
+        reader.read_value<uint64_t>() !=
+        task_properties::compute_task_hash(task_proxy) ||
+        reader.read_value<int>() != state_registry.get_state_size_in_bytes() ||
+        reader.read_value<int>() != static_cast<int>(sizeof(SearchNodeInfo))) {
+        cerr << "Checkpoint " << checkpoint_file << " belongs to a different "
+             << "task or planner version." << endl;
+        utils::exit_with(utils::ExitCode::INPUT_ERROR);
+    }
+
+    statistics.inc_expanded(reader.read_value<int>());
+    statistics.inc_evaluated_states(reader.read_value<int>());
+    statistics.inc_evaluations(reader.read_value<int>());
+    statistics.inc_generated(reader.read_value<int>());
+    statistics.inc_reopened(reader.read_value<int>());
+    statistics.inc_generated_ops(reader.read_value<int>());
+    statistics.inc_dead_ends(reader.read_value<int>());
+    pruning_disabled = reader.read_value<int>();
+    if (pruning_disabled) {
+        pruning_method.reset();
+    } else {
+        pruning_method->initialize(task);
+    }
+
+    /*
+      States are registered with consecutive IDs, so registering them in
+      the same order restores their IDs.
+    */
+    int num_states = reader.read_value<int>();
+    int state_size = state_registry.get_state_size_in_bytes();
+    const char *states = static_cast<const char *>(
+        reader.read(static_cast<size_t>(num_states) * state_size));
+    for (int i = 0; i < num_states; ++i) {
+        state_registry.register_packed_state(
+            reinterpret_cast<const PackedStateBin *>(states + i * state_size));
+        if (state_registry.size() != static_cast<size_t>(i + 1)) {
+            cerr << "Checkpoint " << checkpoint_file
+                 << " contains duplicate states." << endl;
+            utils::exit_with(utils::ExitCode::INPUT_ERROR);
+        }
+    }
+
+    const char *node_infos = static_cast<const char *>(
+        reader.read(static_cast<size_t>(num_states) * sizeof(SearchNodeInfo)));
+    for (StateID id : state_registry) {
+        // SearchNodeInfo only consists of integers (StateID only has an empty destructor).
+        SearchNodeInfo info;
+        memcpy(static_cast<void *>(&info), node_infos, sizeof(SearchNodeInfo));
+        node_infos += sizeof(SearchNodeInfo);
+        search_space.get_node(state_registry.lookup_state(id)).set_info(info);
+    }
+
+    int num_open_nodes = reader.read_value<int>();
+    if (num_open_nodes < 0 || num_open_nodes > num_states) {
+        exit_with_corrupt_checkpoint(checkpoint_file);
+    }
+    vector<StateID> open_states(num_open_nodes, StateID::no_state);
+    int num_open_positions = 0;
+    for (StateID id : state_registry) {
+        int position = reader.read_value<int>();
+        if (position == -1)
+            continue;
+        if (position < 0 || position >= num_open_nodes ||
+            open_states[position] != StateID::no_state ||
+            !search_space.get_node(state_registry.lookup_state(id)).is_open()) {
+            exit_with_corrupt_checkpoint(checkpoint_file);
+        }
+        open_states[position] = id;
+        ++num_open_positions;
+    }
+    vector<uint8_t> preferred_flags = reader.read_vector<uint8_t>();
+    if (num_open_positions != num_open_nodes ||
+        preferred_flags.size() != open_states.size()) {
+        exit_with_corrupt_checkpoint(checkpoint_file);
+    }
+
+    /*
+      Restore the cached h values, so that inserting the open nodes does
+      not evaluate them again. Heuristics that did not cache the values
+      or that are not part of the checkpoint evaluate the nodes below.
+    */
+    int num_saved_heuristics = reader.read_value<int>();
+    for (int i = 0; i < num_saved_heuristics; ++i) {
+        vector<char> description = reader.read_vector<char>();
+        vector<int> h_values = reader.read_vector<int>();
+        if (h_values.size() != open_states.size()) {
+            exit_with_corrupt_checkpoint(checkpoint_file);
+        }
+        auto it = find_if(
+            heuristics.begin(), heuristics.end(),
+            [&description](const Heuristic *heuristic) {
+                return heuristic->get_description() ==
+                       string(description.begin(), description.end());
+            });
+        if (it == heuristics.end())
+            continue;
+        for (size_t j = 0; j < open_states.size(); ++j) {
+            if (h_values[j] != NO_CACHED_ESTIMATE) {
+                (*it)->set_cached_estimate(
+                    state_registry.lookup_state(open_states[j]), h_values[j]);
+            }
+        }
+    }
+
+    vector<EvaluationContext> eval_contexts;
+    auto insert_open_nodes = [&]() {
+            for (Heuristic *heuristic : heuristics) {
+                heuristic->compute_results(eval_contexts);
+            }
+            for (EvaluationContext &eval_context : eval_contexts) {
+                insert_into_open_list(eval_context);
+            }
+            eval_contexts.clear();
+        };
+    for (size_t i = 0; i < open_states.size(); ++i) {
+        GlobalState state = state_registry.lookup_state(open_states[i]);
+        eval_contexts.emplace_back(
+            state, search_space.get_node(state).get_g(), preferred_flags[i],
+            &statistics);
+        if (eval_contexts.size() == RESUME_BATCH_SIZE) {
+            insert_open_nodes();
+        }
+    }
+    insert_open_nodes();
+
+    GlobalState initial_state = state_registry.get_initial_state();
+    if (use_oss()) {
+        vector<int> canonical_state = group->get_canonical_representative(initial_state);
+        initial_state = state_registry.register_state_buffer(canonical_state);
+    }
+    for (Heuristic *heuristic : heuristics) {
+        heuristic->notify_initial_state(initial_state);
+    }
+    cout << "Resumed search with " << num_states << " states, "
+         << num_open_nodes << " of them open." << endl;
+}
+
+/*
+  A finished search must not leave its checkpoint behind, because later
+  runs with the same checkpoint file would resume from it.
+*/
+void EagerSearch::remove_checkpoint() const {
+    if (!checkpoint_file.empty() &&
+        search_checkpoint::checkpoint_exists(checkpoint_file)) {
+        cout << "Removing checkpoint " << checkpoint_file << endl;
+        search_checkpoint::remove_checkpoint(checkpoint_file);
+    }
+}
+
+void EagerSearch::add_checkpoint_options_to_parser(OptionParser &parser) {
+    parser.add_option<string>(
+        "checkpoint",
+        "file for suspending and resuming the search. If the file exists "
+        "when the search starts, the search resumes from it. If max_time or "
+        "checkpoint_memory is exceeded, the search writes its state to the "
+        "file and stops. The search must be resumed with the same task and "
+        "configuration. The file is removed when the search finds a plan or "
+        "fails. Not supported with DKS and path-dependent heuristics.",
+        OptionParser::NONE);
+    parser.add_option<int>(
+        "checkpoint_memory",
+        "resident memory in MB above which the search is suspended "
+        "(only used with checkpoint)",
+        "infinity",
+        Bounds("1", "infinity"));
+}
+
 void EagerSearch::dump_search_space() const {
     search_space.dump(task_proxy);
 }
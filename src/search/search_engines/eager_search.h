@@ -1,10 +1,14 @@
 #ifndef SEARCH_ENGINES_EAGER_SEARCH_H
 #define SEARCH_ENGINES_EAGER_SEARCH_H
 
+#include "../evaluation_context.h"
+#include "../global_state.h"
 #include "../open_list.h"
+#include "../per_state_information.h"
 #include "../search_engine.h"
 
 #include <memory>
+#include <string>
 #include <vector>
 
 class Evaluator;
@@ -13,11 +17,29 @@ class Heuristic;
 class PruningMethod;
 
 namespace options {
+class OptionParser;
 class Options;
 }
 
+namespace utils {
+class CountdownTimer;
+}
+
 namespace eager_search {
 class EagerSearch : public SearchEngine {
+    // Successor that needs to be evaluated and inserted into the open list.
+    struct PendingSuccessor {
+        GlobalState state;
+        int g;
+        bool is_preferred;
+        // Otherwise, the successor is reopened.
+        bool is_new;
+
+        PendingSuccessor(const GlobalState &state, int g, bool is_preferred, bool is_new)
+            : state(state), g(g), is_preferred(is_preferred), is_new(is_new) {
+        }
+    };
+
     const bool reopen_closed_nodes;
     const bool use_multi_path_dependence;
     std::shared_ptr<Group> group;
@@ -38,11 +60,40 @@ class EagerSearch : public SearchEngine {
     const int num_por_probes;
     bool pruning_disabled;
 
+    // Buffers for the successors of the expanded state.
+    std::vector<PendingSuccessor> pending_successors;
+    std::vector<EvaluationContext> succ_eval_contexts;
+
+    /*
+      If a checkpoint file is given, the search writes its state to the
+      file instead of timing out or exceeding the memory limit of the
+      checkpoint, and resumes from the file if it exists when the search
+      starts. The checkpoint contains the state registry, the search node
+      infos, the statistics and the task hash. It also contains the open
+      list entries in the order in which they would be removed, together
+      with their preferred flags and the cached h values of the
+      heuristics. The resumed search reinserts them in this order
+      without evaluating them again. Open lists that alternate between
+      several lists or choose entries randomly may order entries with
+      equal keys differently after resuming.
+    */
+    const std::string checkpoint_file;
+    const int checkpoint_memory_in_mb;
+    std::unique_ptr<utils::CountdownTimer> checkpoint_timer;
+    // Only used with checkpoints.
+    PerStateInformation<bool> reached_by_preferred_operator;
+
     std::pair<SearchNode, bool> fetch_next_node();
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(const SearchNode &node);
     void reward_progress();
     void print_checkpoint_line(int g) const;
+    void insert_into_open_list(EvaluationContext &eval_context);
+
+    bool should_suspend() const;
+    void save_checkpoint();
+    void load_checkpoint();
+    void remove_checkpoint() const;
 
 protected:
     virtual void initialize() override;
@@ -50,11 +101,13 @@ protected:
 
 public:
     explicit EagerSearch(const options::Options &opts);
-    virtual ~EagerSearch() = default;
+    virtual ~EagerSearch() override;
 
     virtual void print_statistics() const override;
 
     void dump_search_space() const;
+
+    static void add_checkpoint_options_to_parser(options::OptionParser &parser);
 };
 }
 
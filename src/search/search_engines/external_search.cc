@@ -0,0 +1,652 @@
+#include "external_search.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../globals.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../algorithms/segmented_vector.h"
+#include "../structural_symmetries/group.h"
+#include "../task_utils/successor_generator.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/memory.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <queue>
+
+using namespace std;
+
+namespace external_search {
+/*
+  A temporary file of records that is written and read sequentially in
+  blocks. The file is only open while a block is written or read, so the
+  number of files that are read at the same time (e.g., when merging the
+  sorted runs of a large bucket) is not limited by the number of open
+  file handles. The file is removed when the object is destroyed.
+*/
+class RecordFile {
+    // Size of the blocks in which records are read and written.
+    static const size_t BLOCK_BYTES = 1 << 16;
+
+    const string path;
+    const int record_bins;
+    const size_t records_per_block;
+    IOStatistics &io_statistics;
+    size_t file_size;
+
+    vector<PackedStateBin> write_buffer;
+
+    bool is_reading;
+    // Position of the next block in the file, in bytes.
+    size_t read_offset;
+    vector<PackedStateBin> read_buffer;
+    size_t read_pos;
+
+    size_t get_record_bytes() const {
+        return record_bins * sizeof(PackedStateBin);
+    }
+
+    void flush() {
+        if (write_buffer.empty())
+            return;
+        FILE *stream = fopen(path.c_str(), "ab");
+        size_t num_bytes = write_buffer.size() * sizeof(PackedStateBin);
+        if (!stream ||
+            fwrite(write_buffer.data(), 1, num_bytes, stream) != num_bytes ||
+            fclose(stream) != 0) {
+            cerr << "Could not write to " << path << endl;
+            utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+        }
+        file_size += num_bytes;
+        io_statistics.bytes_written += num_bytes;
+        io_statistics.bytes_on_disk += num_bytes;
+        io_statistics.peak_bytes_on_disk = max(
+            io_statistics.peak_bytes_on_disk, io_statistics.bytes_on_disk);
+        vector<PackedStateBin>().swap(write_buffer);
+    }
+
+public:
+    RecordFile(const string &path, int record_bins, IOStatistics &io_statistics)
+        : path(path),
+          record_bins(record_bins),
+          records_per_block(max(BLOCK_BYTES / get_record_bytes(), size_t(1))),
+          io_statistics(io_statistics),
+          file_size(0),
+          is_reading(false),
+          read_offset(0),
+          read_pos(0) {
+    }
+
+    ~RecordFile() {
+        finish_reading();
+        if (file_size > 0) {
+            remove(path.c_str());
+            io_statistics.bytes_on_disk -= file_size;
+        }
+    }
+
+    void write(const PackedStateBin *record) {
+        assert(!is_reading);
+        write_buffer.insert(write_buffer.end(), record, record + record_bins);
+        if (write_buffer.size() >= records_per_block * record_bins)
+            flush();
+    }
+
+    void start_reading() {
+        flush();
+        finish_reading();
+        is_reading = true;
+    }
+
+    /*
+      Return the next record or nullptr at the end of the file. The record
+      is valid until the next call.
+    */
+    const PackedStateBin *read() {
+        if (read_pos == read_buffer.size()) {
+            if (!is_reading || read_offset == file_size) {
+                finish_reading();
+                return nullptr;
+            }
+            size_t num_records = min(
+                records_per_block, (file_size - read_offset) / get_record_bytes());
+            size_t num_bytes = num_records * get_record_bytes();
+            read_buffer.resize(num_records * record_bins);
+            FILE *stream = fopen(path.c_str(), "rb");
+            if (!stream || fseek(stream, read_offset, SEEK_SET) != 0 ||
+                fread(read_buffer.data(), 1, num_bytes, stream) != num_bytes ||
+                fclose(stream) != 0) {
+                cerr << "Could not read " << path << endl;
+                utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+            }
+            read_offset += num_bytes;
+            io_statistics.bytes_read += num_bytes;
+            read_pos = 0;
+        }
+        const PackedStateBin *record = &read_buffer[read_pos];
+        read_pos += record_bins;
+        return record;
+    }
+
+    void finish_reading() {
+        is_reading = false;
+        read_offset = 0;
+        vector<PackedStateBin>().swap(read_buffer);
+        read_pos = 0;
+    }
+};
+
+
+ExternalSearch::ExternalSearch(const Options &opts)
+    : SearchEngine(opts),
+      evaluator(opts.get<Evaluator *>("eval")),
+      directory(opts.get<string>("directory")),
+      buffer_size(opts.get<int>("buffer_size")),
+      oss_group(nullptr),
+      dks_group(nullptr),
+      num_bins(g_state_packer->get_num_bins()),
+      max_operator_cost(0),
+      locality(opts.get<int>("locality")),
+      next_file_id(0),
+      goal_layer(-1) {
+    if (opts.contains("symmetries")) {
+        group = opts.get<shared_ptr<Group>>("symmetries");
+        if (group && !group->is_initialized()) {
+            cout << "Initializing symmetries (external search)" << endl;
+            group->compute_symmetries(TaskProxy(*g_root_task()));
+        }
+        if (group->has_symmetries()) {
+            if (group->get_search_symmetries() == SearchSymmetries::OSS) {
+                oss_group = group.get();
+            } else {
+                dks_group = group.get();
+            }
+        }
+    }
+    record_bins = dks_group ? 2 * num_bins : num_bins;
+    for (OperatorProxy op : TaskProxy(*g_root_task()).get_operators()) {
+        max_operator_cost = max(
+            max_operator_cost, get_adjusted_action_cost(op, cost_type));
+    }
+    if (locality == -1) {
+        locality = max_operator_cost > numeric_limits<int>::max() / 2 ?
+                   numeric_limits<int>::max() : 2 * max_operator_cost;
+    }
+}
+
+ExternalSearch::~ExternalSearch() {
+}
+
+unique_ptr<RecordFile> ExternalSearch::create_file() {
+    string path = directory + "/external-search-" +
+        to_string(utils::get_process_id()) + "-" + to_string(next_file_id++) +
+        ".tmp";
+    return utils::make_unique_ptr<RecordFile>(path, record_bins, io_statistics);
+}
+
+void ExternalSearch::reset_scratch_registry_if_full() {
+    if (!scratch_registry ||
+        scratch_registry->size() >= static_cast<size_t>(buffer_size)) {
+        // Free the memory of the old registry first.
+        scratch_registry = nullptr;
+        scratch_registry = utils::make_unique_ptr<StateRegistry>(
+            *g_root_task(), *g_state_packer, *g_axiom_evaluator,
+            g_initial_state_data);
+    }
+}
+
+/*
+  Return the record of the given packed state, which is valid until the
+  next call. Records are sorted and compared by their first num_bins bins.
+*/
+const PackedStateBin *ExternalSearch::get_record(const PackedStateBin *buffer) {
+    if (!dks_group)
+        return buffer;
+    int num_variables = g_variable_domain.size();
+    vector<int> &canonical_state = unpacked_state_buffer;
+    canonical_state.resize(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        canonical_state[var] = g_state_packer->get(buffer, var);
+    }
+    dks_group->compute_canonical_representative(canonical_state);
+    record_buffer.assign(record_bins, 0);
+    for (int var = 0; var < num_variables; ++var) {
+        g_state_packer->set(record_buffer.data(), var, canonical_state[var]);
+    }
+    copy(buffer, buffer + num_bins, record_buffer.begin() + num_bins);
+    return record_buffer.data();
+}
+
+const PackedStateBin *ExternalSearch::get_state_of_record(
+    const PackedStateBin *record) const {
+    return record + (record_bins - num_bins);
+}
+
+void ExternalSearch::insert(const PackedStateBin *record, int g, int h) {
+    Bucket &bucket = buckets[make_pair(g + h, g)];
+    if (!bucket.file) {
+        bucket.file = create_file();
+    }
+    bucket.file->write(record);
+    ++bucket.num_states;
+}
+
+/*
+  Split the given file into sorted runs without duplicates, each of which
+  fits into the buffer.
+*/
+vector<unique_ptr<RecordFile>> ExternalSearch::create_sorted_runs(
+    RecordFile &file) {
+    size_t key_bytes = num_bins * sizeof(PackedStateBin);
+    vector<unique_ptr<RecordFile>> runs;
+    vector<int> order;
+    file.start_reading();
+    const PackedStateBin *record = file.read();
+    while (record) {
+        segmented_vector::SegmentedArrayVector<PackedStateBin> buffer(record_bins);
+        while (record && buffer.size() < static_cast<size_t>(buffer_size)) {
+            buffer.push_back(record);
+            record = file.read();
+        }
+        order.resize(buffer.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        sort(order.begin(), order.end(),
+             [&](int i, int j) {
+                 return memcmp(buffer[i], buffer[j], key_bytes) < 0;
+             });
+        runs.push_back(create_file());
+        const PackedStateBin *last = nullptr;
+        for (int i : order) {
+            if (!last || memcmp(last, buffer[i], key_bytes) != 0) {
+                runs.back()->write(buffer[i]);
+                last = buffer[i];
+            }
+        }
+    }
+    return runs;
+}
+
+/*
+  Merge the sorted runs of the bucket with the given g and h values and
+  remove all states that occur in a closed layer with the same h value
+  within the locality. Return the file of the remaining states, which is
+  sorted.
+*/
+unique_ptr<RecordFile> ExternalSearch::remove_duplicates(
+    vector<unique_ptr<RecordFile>> &runs, int g, int h, size_t &num_states) {
+    size_t key_bytes = num_bins * sizeof(PackedStateBin);
+
+    // Current record of each run, ordered by the records.
+    typedef pair<const PackedStateBin *, int> Entry;
+    auto greater_record = [&](const Entry &lhs, const Entry &rhs) {
+                              return memcmp(lhs.first, rhs.first, key_bytes) > 0;
+                          };
+    priority_queue<Entry, vector<Entry>, decltype(greater_record)> queue(
+        greater_record);
+    for (size_t i = 0; i < runs.size(); ++i) {
+        runs[i]->start_reading();
+        const PackedStateBin *record = runs[i]->read();
+        if (record)
+            queue.emplace(record, i);
+    }
+
+    // Current record of each closed layer, which are also sorted.
+    vector<RecordFile *> closed_files;
+    vector<const PackedStateBin *> closed_records;
+    for (int layer_id : closed_layers_by_h[h]) {
+        if (g - closed_layers[layer_id].g > locality)
+            continue;
+        RecordFile *closed_file = closed_layers[layer_id].file.get();
+        closed_file->start_reading();
+        closed_files.push_back(closed_file);
+        closed_records.push_back(closed_file->read());
+    }
+
+    unique_ptr<RecordFile> result = create_file();
+    num_states = 0;
+    vector<PackedStateBin> record;
+    vector<PackedStateBin> last_record;
+    while (!queue.empty()) {
+        Entry entry = queue.top();
+        queue.pop();
+        // The next read of the run overwrites the record.
+        record.assign(entry.first, entry.first + record_bins);
+        const PackedStateBin *next = runs[entry.second]->read();
+        if (next)
+            queue.emplace(next, entry.second);
+        if (!last_record.empty() &&
+            memcmp(record.data(), last_record.data(), key_bytes) == 0)
+            continue;
+        last_record = record;
+
+        bool is_duplicate = false;
+        for (size_t i = 0; i < closed_files.size(); ++i) {
+            const PackedStateBin *&closed_record = closed_records[i];
+            while (closed_record &&
+                   memcmp(closed_record, record.data(), key_bytes) < 0) {
+                closed_record = closed_files[i]->read();
+            }
+            if (closed_record &&
+                memcmp(closed_record, record.data(), key_bytes) == 0) {
+                is_duplicate = true;
+            }
+        }
+        if (!is_duplicate) {
+            result->write(record.data());
+            ++num_states;
+        }
+    }
+    for (RecordFile *closed_file : closed_files) {
+        closed_file->finish_reading();
+    }
+    return result;
+}
+
+/*
+  Expand all states of the given closed layer and write their successors
+  to the files of their buckets. Return true if a goal state is found.
+*/
+bool ExternalSearch::expand_layer(int layer_id) {
+    ClosedLayer &layer = closed_layers[layer_id];
+    OperatorsProxy operators = TaskProxy(*g_root_task()).get_operators();
+    layer.file->start_reading();
+    while (const PackedStateBin *record = layer.file->read()) {
+        const PackedStateBin *buffer = get_state_of_record(record);
+        reset_scratch_registry_if_full();
+        GlobalState state = scratch_registry->register_packed_state(buffer);
+        statistics.inc_expanded();
+
+        if (test_goal(state)) {
+            goal_buffer.assign(buffer, buffer + num_bins);
+            goal_layer = layer_id;
+            layer.file->finish_reading();
+            return true;
+        }
+
+        applicable_ops.clear();
+        g_successor_generator->generate_applicable_ops(state, applicable_ops);
+        for (OperatorID op_id : applicable_ops) {
+            OperatorProxy op = operators[op_id];
+            int succ_g = layer.g + get_adjusted_action_cost(op, cost_type);
+            if (succ_g >= bound)
+                continue;
+            scratch_registry->compute_successor_buffer(
+                state, op, oss_group, successor_buffer);
+            statistics.inc_generated();
+
+            GlobalState succ_state =
+                scratch_registry->register_packed_state(successor_buffer.data());
+            EvaluationContext eval_context(succ_state, succ_g, false, &statistics);
+            statistics.inc_evaluated_states();
+            if (eval_context.is_heuristic_infinite(evaluator)) {
+                statistics.inc_dead_ends();
+                continue;
+            }
+            insert(get_record(successor_buffer.data()), succ_g,
+                   eval_context.get_heuristic_value(evaluator));
+        }
+    }
+    return false;
+}
+
+/*
+  Find a state in a closed layer before the given one that has the given
+  state as a successor with cost g. On success, set layer_id to the layer
+  of the predecessor.
+*/
+bool ExternalSearch::find_predecessor(
+    const vector<PackedStateBin> &state_buffer, int g, int &layer_id,
+    vector<PackedStateBin> &predecessor_buffer, OperatorID &op_id) {
+    OperatorsProxy operators = TaskProxy(*g_root_task()).get_operators();
+    for (int id = layer_id - 1; id >= 0; --id) {
+        const ClosedLayer &layer = closed_layers[id];
+        if (layer.g > g || g - layer.g > max_operator_cost)
+            continue;
+        RecordFile &file = *layer.file;
+        file.start_reading();
+        while (const PackedStateBin *record = file.read()) {
+            const PackedStateBin *buffer = get_state_of_record(record);
+            reset_scratch_registry_if_full();
+            GlobalState state = scratch_registry->register_packed_state(buffer);
+            applicable_ops.clear();
+            g_successor_generator->generate_applicable_ops(state, applicable_ops);
+            for (OperatorID candidate_op_id : applicable_ops) {
+                OperatorProxy op = operators[candidate_op_id];
+                if (layer.g + get_adjusted_action_cost(op, cost_type) != g)
+                    continue;
+                scratch_registry->compute_successor_buffer(
+                    state, op, oss_group, successor_buffer);
+                if (successor_buffer == state_buffer) {
+                    predecessor_buffer.assign(buffer, buffer + num_bins);
+                    op_id = candidate_op_id;
+                    layer_id = id;
+                    file.finish_reading();
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void ExternalSearch::register_path_to_goal() {
+    struct PathEntry {
+        vector<PackedStateBin> buffer;
+        int g;
+        OperatorID creating_operator;
+    };
+    vector<PathEntry> path;
+    vector<PackedStateBin> state_buffer = goal_buffer;
+    int layer_id = goal_layer;
+    // The first closed layer only contains the initial state.
+    while (layer_id != 0) {
+        int g = closed_layers[layer_id].g;
+        vector<PackedStateBin> predecessor_buffer;
+        OperatorID op_id = OperatorID::no_operator;
+        if (!find_predecessor(state_buffer, g, layer_id, predecessor_buffer, op_id)) {
+            cerr << "Could not reconstruct the plan." << endl;
+            utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+        }
+        path.push_back({state_buffer, g, op_id});
+        state_buffer.swap(predecessor_buffer);
+    }
+    path.push_back({state_buffer, 0, OperatorID::no_operator});
+
+    OperatorsProxy operators = TaskProxy(*g_root_task()).get_operators();
+    StateID parent_id = StateID::no_state;
+    int real_g = 0;
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        if (it->creating_operator != OperatorID::no_operator) {
+            real_g += operators[it->creating_operator].get_cost();
+        }
+        GlobalState state = state_registry.register_packed_state(it->buffer.data());
+        SearchNode node = search_space.get_node(state);
+        node.open(it->g, real_g, parent_id, it->creating_operator);
+        parent_id = state.get_id();
+    }
+    GlobalState goal_state = state_registry.lookup_state(parent_id);
+    // With DKS, the path consists of the states that were expanded.
+    check_goal_and_set_plan(goal_state, oss_group ? group : nullptr);
+}
+
+/*
+  The planner exits without destroying the search engine, so we remove
+  the files when the search ends.
+*/
+void ExternalSearch::remove_files() {
+    buckets.clear();
+    for (ClosedLayer &layer : closed_layers) {
+        layer.file = nullptr;
+    }
+    scratch_registry = nullptr;
+}
+
+void ExternalSearch::initialize() {
+    timer = utils::make_unique_ptr<utils::CountdownTimer>(max_time);
+    cout << "Conducting external-memory A* search, (real) bound = " << bound
+         << endl;
+    cout << "Writing search files to " << directory << endl;
+    GlobalState initial_state = state_registry.get_initial_state();
+    if (oss_group) {
+        vector<int> canonical_state =
+            group->get_canonical_representative(initial_state);
+        initial_state = state_registry.register_state_buffer(canonical_state);
+    }
+    EvaluationContext eval_context(initial_state, 0, true, &statistics);
+    statistics.inc_evaluated_states();
+    if (eval_context.is_heuristic_infinite(evaluator)) {
+        cout << "Initial state is a dead end." << endl;
+    } else {
+        const PackedStateBin *buffer =
+            state_registry.get_packed_state(initial_state.get_id());
+        insert(get_record(buffer), 0,
+               eval_context.get_heuristic_value(evaluator));
+    }
+    print_initial_h_values(eval_context);
+}
+
+SearchStatus ExternalSearch::step() {
+    if (buckets.empty()) {
+        cout << "Completely explored state space -- no solution!" << endl;
+        remove_files();
+        return FAILED;
+    }
+
+    auto it = buckets.begin();
+    int f = it->first.first;
+    int g = it->first.second;
+    int h = f - g;
+    unique_ptr<RecordFile> file = move(it->second.file);
+    buckets.erase(it);
+    statistics.report_f_value_progress(f);
+
+    vector<unique_ptr<RecordFile>> runs = create_sorted_runs(*file);
+    file = nullptr;
+    size_t num_states;
+    unique_ptr<RecordFile> new_states = remove_duplicates(runs, g, h, num_states);
+    runs.clear();
+    if (num_states == 0)
+        return check_timeout();
+
+    /*
+      Add the layer before the expansion, so that successors in the same
+      bucket (reached by zero-cost operators) are detected as duplicates.
+    */
+    int layer_id = closed_layers.size();
+    closed_layers.push_back({move(new_states), g, h, num_states});
+    closed_layers_by_h[h].push_back(layer_id);
+    if (expand_layer(layer_id)) {
+        register_path_to_goal();
+        remove_files();
+        return SOLVED;
+    }
+    return check_timeout();
+}
+
+/*
+  Our timer starts before the one of SearchEngine::search, so it expires
+  first and we can remove the files before the search is aborted.
+*/
+SearchStatus ExternalSearch::check_timeout() {
+    if (timer->is_expired()) {
+        remove_files();
+        return TIMEOUT;
+    }
+    return IN_PROGRESS;
+}
+
+void ExternalSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    size_t num_closed_states = 0;
+    for (const ClosedLayer &layer : closed_layers) {
+        num_closed_states += layer.num_states;
+    }
+    cout << "Closed layers: " << closed_layers.size() << endl;
+    cout << "States in closed layers: " << num_closed_states << endl;
+    cout << "Bytes written: " << io_statistics.bytes_written << endl;
+    cout << "Bytes read: " << io_statistics.bytes_read << endl;
+    cout << "Peak disk usage: " << io_statistics.peak_bytes_on_disk
+         << " bytes" << endl;
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "External-memory A* search",
+        "A* search that keeps its open and closed lists in files on disk "
+        "(External A*, Edelkamp, Jabbar and Schroedl, 2004). States are "
+        "grouped into buckets by their g and h values and expanded in order "
+        "of increasing f and g. Duplicates are removed by sorting a bucket "
+        "before its expansion and merging it with the sorted files of the "
+        "expanded buckets with the same h value and a similar g value "
+        "(delayed duplicate detection, see the locality option). Only a "
+        "bounded number of states is kept in memory. The search returns "
+        "optimal plans for consistent heuristics.");
+    parser.document_note(
+        "Files",
+        "The search files are written to the given directory, which should "
+        "be on a local disk, and removed when the search ends normally. "
+        "The number of bytes read and written is printed with the search "
+        "statistics.");
+    parser.document_note(
+        "Limitations",
+        "Path-dependent heuristics (e.g., lmcount) are not supported. "
+        "The bound is compared to g values that are computed with the given "
+        "cost type. With DKS symmetries, each record on disk also contains "
+        "the canonical representative of the state, so the files are twice "
+        "as large as with orbit search (OSS), which prunes the same "
+        "symmetric states.");
+    parser.add_option<Evaluator *>("eval", "evaluator for h-value");
+    parser.add_option<string>(
+        "directory",
+        "directory for the search files",
+        ".");
+    parser.add_option<int>(
+        "buffer_size",
+        "maximum number of states kept in memory for sorting buckets and "
+        "evaluating successors",
+        "1000000",
+        Bounds("1", "infinity"));
+    parser.add_option<int>(
+        "locality",
+        "only detect duplicates in the expanded buckets whose g value is at "
+        "most this much smaller than the g value of the current bucket. "
+        "Older duplicates are expanded again, which costs time but does not "
+        "affect the plan. The default -1 uses twice the maximal operator "
+        "cost, which detects all duplicates if all operators can be undone. "
+        "Use infinity to check all expanded buckets with the same h value, "
+        "which reads all of them for every bucket in blind search.",
+        "-1",
+        Bounds("-1", "infinity"));
+    parser.add_option<shared_ptr<Group>>(
+        "symmetries",
+        "symmetries object to compute structural symmetries for pruning",
+        OptionParser::NONE);
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    if (parser.dry_run()) {
+        return nullptr;
+    } else {
+        if (opts.contains("symmetries")) {
+            shared_ptr<Group> group = opts.get<shared_ptr<Group>>("symmetries");
+            if (group->get_search_symmetries() == SearchSymmetries::NONE) {
+                cerr << "External search only supports symmetries for orbit "
+                     << "search or DKS." << endl;
+                utils::exit_with(utils::ExitCode::UNSUPPORTED);
+            }
+        }
+        return make_shared<ExternalSearch>(opts);
+    }
+}
+
+static PluginShared<SearchEngine> _plugin("external_astar", _parse);
+}
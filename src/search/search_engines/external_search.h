@@ -0,0 +1,169 @@
+#ifndef SEARCH_ENGINES_EXTERNAL_SEARCH_H
+#define SEARCH_ENGINES_EXTERNAL_SEARCH_H
+
+#include "../search_engine.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Evaluator;
+class Group;
+
+namespace utils {
+class CountdownTimer;
+}
+
+namespace options {
+class Options;
+}
+
+/*
+  External-memory A* (Edelkamp, Jabbar and Schroedl, 2004).
+
+  States are stored on disk in their packed representation (see
+  IntPacker), grouped into buckets by their g and h values. Buckets are
+  expanded in order of increasing f = g + h and, within the same f layer,
+  of increasing g. Successors are appended to the files of their buckets
+  without duplicate checking. Before a bucket is expanded, its file is
+  sorted with an external merge sort, whose runs are sorted in a bounded
+  in-memory buffer, and duplicates are removed by merging it with the
+  sorted files of the expanded buckets with the same h value (delayed
+  duplicate detection). Only buckets whose g value is at most the
+  locality smaller than the g value of the bucket are considered, so the
+  I/O per bucket does not grow with the depth of the search. Duplicates
+  of older states are expanded again, which costs time but does not
+  affect the plan. The result is the set of new states of the bucket,
+  which is read sequentially for expansion and then kept on disk as a
+  closed layer.
+
+  With orbit search, the files contain canonical representatives. With
+  DKS, each record contains the canonical representative of a state,
+  which is used for sorting and duplicate detection, followed by the
+  state itself, which is expanded. Symmetric states have the same h
+  value, so they are in buckets that are checked for duplicates.
+
+  Memory usage is bounded by the size of the buffer plus the file buffers
+  of the buckets. We do not store parent pointers. Instead, we reconstruct
+  the plan backwards from the goal by scanning the closed layers for a
+  predecessor of the current state.
+
+  The search is optimal for consistent heuristics. Zero-cost operators are
+  supported by expanding a bucket repeatedly until it contains no more new
+  states.
+*/
+namespace external_search {
+class RecordFile;
+
+struct IOStatistics {
+    size_t bytes_read;
+    size_t bytes_written;
+    // Size of all files that currently exist, and its maximum.
+    size_t bytes_on_disk;
+    size_t peak_bytes_on_disk;
+
+    IOStatistics()
+        : bytes_read(0),
+          bytes_written(0),
+          bytes_on_disk(0),
+          peak_bytes_on_disk(0) {
+    }
+};
+
+class ExternalSearch : public SearchEngine {
+    // Successors that are not sorted and checked for duplicates yet.
+    struct Bucket {
+        std::unique_ptr<RecordFile> file;
+        size_t num_states;
+
+        Bucket()
+            : num_states(0) {
+        }
+    };
+
+    // The states of a bucket that were new when it was expanded.
+    struct ClosedLayer {
+        std::unique_ptr<RecordFile> file;
+        int g;
+        int h;
+        size_t num_states;
+    };
+
+    // Declared first because the files update it when they are destroyed.
+    IOStatistics io_statistics;
+    Evaluator *evaluator;
+    const std::string directory;
+    // Maximum number of states kept in memory for sorting and expansion.
+    const int buffer_size;
+    std::shared_ptr<Group> group;
+    // Group used to canonicalize states in orbit search (nullptr otherwise).
+    const Group *oss_group;
+    // Group used to detect symmetric duplicates with DKS (nullptr otherwise).
+    const Group *dks_group;
+    const int num_bins;
+    /*
+      Number of bins of a record. With DKS, a record consists of the
+      canonical representative and the state, otherwise only of the state.
+    */
+    int record_bins;
+    int max_operator_cost;
+    // Maximal difference of g values between duplicates that we detect.
+    int locality;
+    int next_file_id;
+
+    // Buckets with unprocessed successors, ordered by (f, g).
+    std::map<std::pair<int, int>, Bucket> buckets;
+    // Closed layers in the order in which they were expanded.
+    std::vector<ClosedLayer> closed_layers;
+    // Indices of the closed layers with a given h value.
+    std::map<int, std::vector<int>> closed_layers_by_h;
+
+    /*
+      States are only registered temporarily to generate and evaluate
+      successors. The registry is replaced when it becomes full.
+    */
+    std::unique_ptr<StateRegistry> scratch_registry;
+    std::vector<PackedStateBin> successor_buffer;
+    std::vector<PackedStateBin> record_buffer;
+    std::vector<int> unpacked_state_buffer;
+    std::vector<OperatorID> applicable_ops;
+
+    // Packed data and closed layer of the goal state found by the search.
+    std::vector<PackedStateBin> goal_buffer;
+    int goal_layer;
+
+    std::unique_ptr<utils::CountdownTimer> timer;
+
+    std::unique_ptr<RecordFile> create_file();
+    void reset_scratch_registry_if_full();
+    const PackedStateBin *get_record(const PackedStateBin *buffer);
+    const PackedStateBin *get_state_of_record(const PackedStateBin *record) const;
+    void insert(const PackedStateBin *record, int g, int h);
+    std::vector<std::unique_ptr<RecordFile>> create_sorted_runs(
+        RecordFile &file);
+    std::unique_ptr<RecordFile> remove_duplicates(
+        std::vector<std::unique_ptr<RecordFile>> &runs, int g, int h,
+        size_t &num_states);
+    bool expand_layer(int layer_id);
+    bool find_predecessor(
+        const std::vector<PackedStateBin> &state_buffer, int g, int &layer_id,
+        std::vector<PackedStateBin> &predecessor_buffer, OperatorID &op_id);
+    void register_path_to_goal();
+    void remove_files();
+    SearchStatus check_timeout();
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit ExternalSearch(const options::Options &opts);
+    virtual ~ExternalSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -0,0 +1,637 @@
+#include "hda_search.h"
+
+#include "search_common.h"
+
+#include "../axioms.h"
+#include "../evaluation_context.h"
+#include "../globals.h"
+#include "../open_list_factory.h"
+#include "../option_parser.h"
+#include "../option_parser_util.h"
+#include "../plugin.h"
+#include "../pruning_method.h"
+
+#include "../algorithms/mpsc_queue.h"
+#include "../structural_symmetries/group.h"
+#include "../task_utils/successor_generator.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/hash.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+namespace hda_search {
+/*
+  A successor sent to its owner. The parent is registered in the registry
+  of parent_worker.
+*/
+struct Message {
+    int g;
+    int real_g;
+    int parent_worker;
+    StateID parent_state_id;
+    OperatorID creating_operator;
+
+    Message(int g, int real_g, int parent_worker, StateID parent_state_id,
+            OperatorID creating_operator)
+        : g(g),
+          real_g(real_g),
+          parent_worker(parent_worker),
+          parent_state_id(parent_state_id),
+          creating_operator(creating_operator) {
+    }
+};
+
+// Successors sent from one worker to another after an expansion.
+struct MessageBatch {
+    // Packed data of all successors, one after the other.
+    vector<PackedStateBin> buffers;
+    vector<Message> messages;
+};
+
+struct SharedSearchState {
+    vector<Worker *> workers;
+    // Cost (adjusted g value) of the best plan found so far.
+    atomic<int> incumbent_cost;
+    mutex goal_mutex;
+    int goal_worker;
+    StateID goal_state_id;
+    /*
+      Number of workers that are not idle plus the number of message
+      batches that have been sent but not processed yet. Workers only
+      become busy again by receiving a batch, so the search is over once
+      this counter reaches zero.
+    */
+    atomic<int> num_active;
+    atomic<bool> timed_out;
+    unique_ptr<utils::CountdownTimer> timer;
+
+    explicit SharedSearchState(int num_workers)
+        : incumbent_cost(numeric_limits<int>::max()),
+          goal_worker(-1),
+          goal_state_id(StateID::no_state),
+          num_active(num_workers),
+          timed_out(false) {
+    }
+
+    void report_goal(int worker, StateID state_id, int cost) {
+        lock_guard<mutex> lock(goal_mutex);
+        if (cost < incumbent_cost.load()) {
+            incumbent_cost.store(cost);
+            goal_worker = worker;
+            goal_state_id = state_id;
+        }
+    }
+
+    bool has_found_goal() const {
+        return goal_worker != -1;
+    }
+};
+
+// Use a different hash function than the state registries.
+static const uint32_t OWNER_HASH_SEED = 0x9e3779b9;
+
+static int get_owner(const PackedStateBin *buffer, int num_workers) {
+    utils::HashState hash_state;
+    hash_state.feed(OWNER_HASH_SEED);
+    for (int i = 0; i < g_state_packer->get_num_bins(); ++i) {
+        hash_state.feed(buffer[i]);
+    }
+    return hash_state.get_hash64() % num_workers;
+}
+
+class Worker {
+    const int id;
+    SharedSearchState &shared_state;
+    const int bound;
+    const OperatorCost cost_type;
+    // Group used to canonicalize successors in orbit search (nullptr otherwise).
+    const Group *oss_group;
+    // Group used for duplicate detection with symmetries (nullptr otherwise).
+    const Group *dks_group;
+
+    AxiomEvaluator axiom_evaluator;
+    StateRegistry state_registry;
+    SearchSpace search_space;
+    // Worker that owns the parent of each state.
+    PerStateInformation<int> parent_workers;
+    unique_ptr<StateOpenList> open_list;
+
+    shared_ptr<PruningMethod> pruning_method;
+    const int num_por_probes;
+    bool pruning_disabled;
+
+    SearchStatistics statistics;
+
+    mpsc_queue::MPSCQueue<unique_ptr<MessageBatch>> inbox;
+    // Successors generated in the current expansion, by owner.
+    vector<unique_ptr<MessageBatch>> outboxes;
+    vector<PackedStateBin> successor_buffer;
+    vector<OperatorID> applicable_ops;
+    vector<int> owner_values;
+    vector<PackedStateBin> owner_buffer;
+
+    void process_message(const PackedStateBin *buffer, const Message &message);
+    void process_batch(const MessageBatch &batch);
+    void receive_messages();
+    bool wait_for_messages();
+    void send_messages();
+    void expand_next_state();
+
+public:
+    Worker(int id, SharedSearchState &shared_state, Evaluator *eval,
+           const shared_ptr<PruningMethod> &pruning_method,
+           const shared_ptr<Group> &group, int bound, OperatorCost cost_type,
+           bool use_incremental_state_hashing, int num_por_probes);
+
+    int compute_owner(const PackedStateBin *buffer);
+    void insert_initial_state(const PackedStateBin *buffer);
+    void run();
+
+    GlobalState lookup_state(StateID id) const {
+        return state_registry.lookup_state(id);
+    }
+
+    SearchNode get_node(const GlobalState &state) {
+        return search_space.get_node(state);
+    }
+
+    int get_parent_worker(const GlobalState &state) {
+        return parent_workers[state];
+    }
+
+    const SearchStatistics &get_statistics() const {
+        return statistics;
+    }
+
+    size_t get_num_registered_states() const {
+        return state_registry.size();
+    }
+};
+
+Worker::Worker(
+    int id, SharedSearchState &shared_state, Evaluator *eval,
+    const shared_ptr<PruningMethod> &pruning_method,
+    const shared_ptr<Group> &group, int bound, OperatorCost cost_type,
+    bool use_incremental_state_hashing, int num_por_probes)
+    : id(id),
+      shared_state(shared_state),
+      bound(bound),
+      cost_type(cost_type),
+      oss_group(group && group->get_search_symmetries() == SearchSymmetries::OSS ?
+                group.get() : nullptr),
+      dks_group(group && group->get_search_symmetries() == SearchSymmetries::DKS ?
+                group.get() : nullptr),
+      axiom_evaluator(TaskProxy(*g_root_task())),
+      state_registry(
+          *g_root_task(), *g_state_packer, axiom_evaluator, g_initial_state_data,
+          use_incremental_state_hashing),
+      search_space(state_registry, cost_type),
+      parent_workers(-1),
+      pruning_method(pruning_method),
+      num_por_probes(num_por_probes),
+      pruning_disabled(false) {
+    if (group && group->get_search_symmetries() == SearchSymmetries::DKS) {
+        state_registry.set_group(group);
+    }
+    Options opts;
+    opts.set<Evaluator *>("eval", eval);
+    auto open_list_factory_and_f_eval =
+        search_common::create_astar_open_list_factory_and_f_eval(opts);
+    open_list = open_list_factory_and_f_eval.first->create_state_open_list();
+    this->pruning_method->initialize(g_root_task());
+}
+
+int Worker::compute_owner(const PackedStateBin *buffer) {
+    int num_workers = shared_state.workers.size();
+    if (!dks_group) {
+        return get_owner(buffer, num_workers);
+    }
+    /*
+      Symmetric states need the same owner to be detected as duplicates,
+      so we hash the canonical representative.
+    */
+    int num_variables = g_root_task()->get_num_variables();
+    owner_values.resize(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        owner_values[var] = g_state_packer->get(buffer, var);
+    }
+    dks_group->compute_canonical_representative(owner_values);
+    owner_buffer.assign(g_state_packer->get_num_bins(), 0);
+    for (int var = 0; var < num_variables; ++var) {
+        g_state_packer->set(owner_buffer.data(), var, owner_values[var]);
+    }
+    return get_owner(owner_buffer.data(), num_workers);
+}
+
+void Worker::insert_initial_state(const PackedStateBin *buffer) {
+    GlobalState initial_state = state_registry.register_packed_state(buffer);
+    EvaluationContext eval_context(initial_state, 0, true, &statistics);
+    statistics.inc_evaluated_states();
+    if (open_list->is_dead_end(eval_context)) {
+        cout << "Initial state is a dead end." << endl;
+    } else {
+        SearchNode node = search_space.get_node(initial_state);
+        node.open_initial();
+        open_list->insert(eval_context, initial_state.get_id());
+    }
+    print_initial_h_values(eval_context);
+}
+
+void Worker::process_message(const PackedStateBin *buffer, const Message &message) {
+    GlobalState state = state_registry.register_packed_state(buffer);
+    SearchNode node = search_space.get_node(state);
+
+    // Previously encountered dead end. Don't re-evaluate.
+    if (node.is_dead_end())
+        return;
+
+    if (node.is_new()) {
+        EvaluationContext eval_context(state, message.g, false, &statistics);
+        statistics.inc_evaluated_states();
+        if (open_list->is_dead_end(eval_context)) {
+            node.mark_as_dead_end();
+            statistics.inc_dead_ends();
+            return;
+        }
+        node.open(message.g, message.real_g, message.parent_state_id,
+                  message.creating_operator);
+        parent_workers[state] = message.parent_worker;
+        open_list->insert(eval_context, state.get_id());
+    } else if (node.get_g() > message.g) {
+        /*
+          We found a cheaper path to an open or closed state. Since workers
+          do not expand states in global f order, this also happens with
+          consistent heuristics.
+        */
+        if (node.is_closed()) {
+            statistics.inc_reopened();
+        }
+        node.reopen(message.g, message.real_g, message.parent_state_id,
+                    message.creating_operator);
+        parent_workers[state] = message.parent_worker;
+        EvaluationContext eval_context(state, message.g, false, &statistics);
+        open_list->insert(eval_context, state.get_id());
+    }
+}
+
+void Worker::process_batch(const MessageBatch &batch) {
+    int num_bins = g_state_packer->get_num_bins();
+    for (size_t i = 0; i < batch.messages.size(); ++i) {
+        process_message(&batch.buffers[i * num_bins], batch.messages[i]);
+    }
+}
+
+void Worker::receive_messages() {
+    unique_ptr<MessageBatch> batch;
+    while (inbox.pop(batch)) {
+        process_batch(*batch);
+        --shared_state.num_active;
+    }
+}
+
+/*
+  Mark this worker as idle and wait until a message arrives (return true)
+  or the search is over (return false).
+*/
+bool Worker::wait_for_messages() {
+    --shared_state.num_active;
+    unique_ptr<MessageBatch> batch;
+    while (!inbox.pop(batch)) {
+        if (shared_state.num_active == 0 || shared_state.timed_out) {
+            return false;
+        }
+        this_thread::yield();
+    }
+    // Become busy before we mark the batch as processed.
+    ++shared_state.num_active;
+    process_batch(*batch);
+    --shared_state.num_active;
+    return true;
+}
+
+void Worker::send_messages() {
+    for (size_t owner = 0; owner < outboxes.size(); ++owner) {
+        unique_ptr<MessageBatch> &batch = outboxes[owner];
+        if (batch && !batch->messages.empty()) {
+            ++shared_state.num_active;
+            shared_state.workers[owner]->inbox.push(move(batch));
+            batch = nullptr;
+        }
+    }
+}
+
+void Worker::expand_next_state() {
+    vector<int> key;
+    StateID state_id = open_list->remove_min(&key);
+    GlobalState state = state_registry.lookup_state(state_id);
+    SearchNode node = search_space.get_node(state);
+    if (node.is_closed())
+        return;
+    // States with f >= incumbent cost cannot lead to a cheaper plan.
+    assert(key.size() == 2);
+    if (key[0] >= shared_state.incumbent_cost)
+        return;
+    node.close();
+    statistics.inc_expanded();
+
+    if (test_goal(state)) {
+        shared_state.report_goal(id, state_id, node.get_g());
+        return;
+    }
+
+    applicable_ops.clear();
+    g_successor_generator->generate_applicable_ops(state, applicable_ops);
+
+    if (!pruning_disabled && num_por_probes < statistics.get_expanded()
+        && pruning_method->pruning_below_minimum_ratio()) {
+        pruning_disabled = true;
+        pruning_method.reset();
+    }
+    if (!pruning_disabled) {
+        pruning_method->prune_operators(state, applicable_ops);
+    }
+
+    OperatorsProxy operators = TaskProxy(*g_root_task()).get_operators();
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = operators[op_id];
+        if (node.get_real_g() + op.get_cost() >= bound)
+            continue;
+        int succ_g = node.get_g() + get_adjusted_action_cost(op, cost_type);
+        if (succ_g >= shared_state.incumbent_cost)
+            continue;
+
+        state_registry.compute_successor_buffer(
+            state, op, oss_group, successor_buffer);
+        statistics.inc_generated();
+        Message message(succ_g, node.get_real_g() + op.get_cost(),
+                        id, state_id, op_id);
+        int owner = compute_owner(successor_buffer.data());
+        if (owner == id) {
+            process_message(successor_buffer.data(), message);
+        } else {
+            unique_ptr<MessageBatch> &batch = outboxes[owner];
+            if (!batch) {
+                batch = utils::make_unique_ptr<MessageBatch>();
+            }
+            batch->buffers.insert(batch->buffers.end(),
+                                  successor_buffer.begin(), successor_buffer.end());
+            batch->messages.push_back(message);
+        }
+    }
+}
+
+void Worker::run() {
+    outboxes.resize(shared_state.workers.size());
+    // Check the timer only every few expansions since this is a system call.
+    const int EXPANSIONS_PER_TIMER_CHECK = 256;
+    int num_expansions = 0;
+    while (true) {
+        receive_messages();
+        if (open_list->empty()) {
+            if (!wait_for_messages()) {
+                return;
+            }
+            continue;
+        }
+        expand_next_state();
+        send_messages();
+        if (++num_expansions % EXPANSIONS_PER_TIMER_CHECK == 0 &&
+            shared_state.timer->is_expired()) {
+            shared_state.timed_out = true;
+        }
+        if (shared_state.timed_out) {
+            return;
+        }
+    }
+}
+
+
+HDAStarSearch::HDAStarSearch(const Options &opts)
+    : SearchEngine(opts) {
+    int num_threads = opts.get<int>("num_threads");
+    if (num_threads == 0) {
+        num_threads = max(1u, thread::hardware_concurrency());
+    }
+
+    if (opts.contains("symmetries")) {
+        group = opts.get<shared_ptr<Group>>("symmetries");
+        if (group && !group->is_initialized()) {
+            cout << "Initializing symmetries (hda search)" << endl;
+            group->compute_symmetries(TaskProxy(*g_root_task()));
+        }
+        if (use_dks()) {
+            state_registry.set_group(group);
+        }
+    }
+    // Only pass the group on to the workers if it is used for pruning.
+    shared_ptr<Group> worker_group = (use_oss() || use_dks()) ? group : nullptr;
+
+    /*
+      Heuristics and pruning methods are not thread-safe, so every worker
+      parses its own copies. Predefined objects would be shared.
+    */
+    shared_state = utils::make_unique_ptr<SharedSearchState>(num_threads);
+    vector<Evaluator *> evals;
+    vector<PruningMethod *> pruning_methods;
+    for (int i = 0; i < num_threads; ++i) {
+        OptionParser eval_parser(opts.get<ParseTree>("eval"), false);
+        Evaluator *eval = eval_parser.start_parsing<Evaluator *>();
+        OptionParser pruning_parser(opts.get<ParseTree>("pruning"), false);
+        shared_ptr<PruningMethod> pruning_method =
+            pruning_parser.start_parsing<shared_ptr<PruningMethod>>();
+        if (find(evals.begin(), evals.end(), eval) != evals.end() ||
+            find(pruning_methods.begin(), pruning_methods.end(),
+                 pruning_method.get()) != pruning_methods.end()) {
+            cerr << "hda_astar needs a separate evaluator and pruning method "
+                 << "for each thread. Define them inline instead of using "
+                 << "predefined ones." << endl;
+            utils::exit_with(utils::ExitCode::INPUT_ERROR);
+        }
+        evals.push_back(eval);
+        pruning_methods.push_back(pruning_method.get());
+        workers.push_back(utils::make_unique_ptr<Worker>(
+                              i, *shared_state, eval, pruning_method, worker_group,
+                              bound, cost_type,
+                              opts.get<bool>("incremental_state_hashing"),
+                              opts.get<int>("num_por_probes")));
+        shared_state->workers.push_back(workers.back().get());
+    }
+}
+
+HDAStarSearch::~HDAStarSearch() {
+}
+
+bool HDAStarSearch::use_oss() const {
+    return group && group->has_symmetries() && group->get_search_symmetries() == SearchSymmetries::OSS;
+}
+
+bool HDAStarSearch::use_dks() const {
+    return group && group->has_symmetries() && group->get_search_symmetries() == SearchSymmetries::DKS;
+}
+
+void HDAStarSearch::initialize() {
+    cout << "Conducting hash-distributed A* search with " << workers.size()
+         << " threads, (real) bound = " << bound << endl;
+    GlobalState initial_state = state_registry.get_initial_state();
+    if (use_oss()) {
+        vector<int> canonical_state = group->get_canonical_representative(initial_state);
+        initial_state = state_registry.register_state_buffer(canonical_state);
+    }
+    const PackedStateBin *buffer = state_registry.get_packed_state(initial_state.get_id());
+    workers[workers[0]->compute_owner(buffer)]->insert_initial_state(buffer);
+}
+
+void HDAStarSearch::register_path_to_goal() {
+    struct PathEntry {
+        vector<int> values;
+        int g;
+        int real_g;
+        OperatorID creating_operator;
+    };
+    vector<PathEntry> path;
+    int worker_id = shared_state->goal_worker;
+    StateID state_id = shared_state->goal_state_id;
+    while (true) {
+        Worker &worker = *workers[worker_id];
+        GlobalState state = worker.lookup_state(state_id);
+        SearchNode node = worker.get_node(state);
+        path.push_back({state.get_values(), node.get_g(), node.get_real_g(),
+                        node.get_creating_operator()});
+        if (node.get_creating_operator() == OperatorID::no_operator)
+            break;
+        worker_id = worker.get_parent_worker(state);
+        state_id = node.get_parent_state_id();
+    }
+
+    StateID parent_id = StateID::no_state;
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        GlobalState state = state_registry.register_state_buffer(it->values);
+        SearchNode node = search_space.get_node(state);
+        node.open(it->g, it->real_g, parent_id, it->creating_operator);
+        parent_id = state.get_id();
+    }
+    GlobalState goal_state = state_registry.lookup_state(parent_id);
+    check_goal_and_set_plan(goal_state, group);
+}
+
+SearchStatus HDAStarSearch::step() {
+    shared_state->timer = utils::make_unique_ptr<utils::CountdownTimer>(max_time);
+    vector<thread> threads;
+    for (const unique_ptr<Worker> &worker : workers) {
+        threads.emplace_back(&Worker::run, worker.get());
+    }
+    for (thread &thread : threads) {
+        thread.join();
+    }
+
+    for (const unique_ptr<Worker> &worker : workers) {
+        const SearchStatistics &worker_statistics = worker->get_statistics();
+        statistics.inc_expanded(worker_statistics.get_expanded());
+        statistics.inc_evaluated_states(worker_statistics.get_evaluated_states());
+        statistics.inc_evaluations(worker_statistics.get_evaluations());
+        statistics.inc_generated(worker_statistics.get_generated());
+        statistics.inc_reopened(worker_statistics.get_reopened());
+        statistics.inc_dead_ends(worker_statistics.get_dead_ends());
+    }
+
+    if (shared_state->timed_out) {
+        // SearchEngine::search() reports the timeout.
+        return FAILED;
+    }
+    if (!shared_state->has_found_goal()) {
+        cout << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+    register_path_to_goal();
+    return SOLVED;
+}
+
+void HDAStarSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    size_t num_registered_states = 0;
+    cout << "Expanded states per thread:";
+    for (const unique_ptr<Worker> &worker : workers) {
+        num_registered_states += worker->get_num_registered_states();
+        cout << " " << worker->get_statistics().get_expanded();
+    }
+    cout << endl;
+    cout << "Number of registered states: " << num_registered_states << endl;
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Hash-distributed A* search",
+        "Parallel A* search that distributes states among threads by a hash "
+        "value of their state data (HDA*, Kishimoto, Fukunaga and Botea, "
+        "2009). Each thread has its own open list, closed list and copy of "
+        "the evaluator. Like astar(), the search returns optimal plans for "
+        "admissible heuristics. Closed nodes are reopened.");
+    parser.document_note(
+        "Evaluators and pruning methods",
+        "The evaluator and pruning method are parsed once per thread, "
+        "so they must be given inline and not as predefined objects. "
+        "Preprocessing of the evaluator (e.g., computing pattern databases "
+        "or merge-and-shrink abstractions) is repeated for every thread. "
+        "Path-dependent heuristics (e.g., lmcount) are not supported.");
+    parser.document_note(
+        "Time limits",
+        "Time limits (max_time and the limits of the driver) measure the "
+        "CPU time of all threads together.");
+    parser.add_option<ParseTree>("eval", "evaluator for h-value");
+    parser.add_option<ParseTree>(
+        "pruning",
+        "Pruning methods can prune or reorder the set of applicable operators in "
+        "each state and thereby influence the number and order of successor states "
+        "that are considered.",
+        "null()");
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads. 0 uses one thread per hardware thread.",
+        "0",
+        Bounds("0", "infinity"));
+    SearchEngine::add_options_to_parser(parser);
+    parser.add_option<shared_ptr<Group>>(
+        "symmetries",
+        "symmetries object to compute structural symmetries for pruning",
+        OptionParser::NONE);
+    parser.add_option<int>(
+        "num_por_probes",
+        "Number of state expansions until which we test if the minimum "
+        "required pruning ratio is achieved (separately in each thread).",
+        "infinity",
+        Bounds("0", "infinity"));
+    Options opts = parser.parse();
+
+    if (parser.help_mode()) {
+        return nullptr;
+    } else if (parser.dry_run()) {
+        // Check that the evaluator and pruning method can be parsed.
+        OptionParser eval_parser(opts.get<ParseTree>("eval"), true);
+        eval_parser.start_parsing<Evaluator *>();
+        OptionParser pruning_parser(opts.get<ParseTree>("pruning"), true);
+        pruning_parser.start_parsing<shared_ptr<PruningMethod>>();
+        return nullptr;
+    } else {
+        if (opts.contains("symmetries")) {
+            shared_ptr<Group> group = opts.get<shared_ptr<Group>>("symmetries");
+            if (group->get_search_symmetries() == SearchSymmetries::NONE) {
+                cerr << "Symmetries option passed to hda search, but no "
+                     << "search symmetries should be used." << endl;
+                utils::exit_with(utils::ExitCode::INPUT_ERROR);
+            }
+        }
+        return make_shared<HDAStarSearch>(opts);
+    }
+}
+
+static PluginShared<SearchEngine> _plugin("hda_astar", _parse);
+}
@@ -0,0 +1,64 @@
+#ifndef SEARCH_ENGINES_HDA_SEARCH_H
+#define SEARCH_ENGINES_HDA_SEARCH_H
+
+#include "../search_engine.h"
+
+#include <memory>
+#include <vector>
+
+class Group;
+
+namespace options {
+class Options;
+}
+
+/*
+  Hash-distributed A* (HDA*, Kishimoto, Fukunaga and Botea, 2009).
+
+  Every state is owned by one of several worker threads, determined by a
+  hash value of its packed state data. Each worker has its own
+  StateRegistry, SearchSpace, open list, evaluator and pruning method, and
+  only touches the states it owns. When a worker expands a state, it sends
+  each successor (its packed data, g value and parent) to the owner of the
+  successor through a lock-free queue. The owner detects duplicates,
+  evaluates the successor and inserts it into its open list.
+
+  Workers expand states in f order of their own open list only, so states
+  can be reached on cheaper paths after they have been expanded and are
+  then reopened. Workers discard states with f values that are not smaller
+  than the cost of the best plan found so far (the incumbent). The search
+  terminates when all workers are idle and no messages are in transit. At
+  this point, the incumbent is optimal if the heuristic is admissible.
+
+  Since parents can be owned by other workers, every state stores the
+  worker that owns its parent. After the search, we follow these pointers
+  from the goal to the initial state and register the path in the search
+  space of the engine itself, where the usual plan tracing (including
+  symmetry-aware tracing for OSS and DKS) takes over.
+*/
+namespace hda_search {
+struct SharedSearchState;
+class Worker;
+
+class HDAStarSearch : public SearchEngine {
+    std::shared_ptr<Group> group;
+    std::unique_ptr<SharedSearchState> shared_state;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    bool use_oss() const;
+    bool use_dks() const;
+    void register_path_to_goal();
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit HDAStarSearch(const options::Options &opts);
+    virtual ~HDAStarSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
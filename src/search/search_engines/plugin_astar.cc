@@ -34,6 +34,7 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
                             "use multi-path dependence (LM-A*)", "false");
 
     SearchEngine::add_pruning_option(parser);
+    eager_search::EagerSearch::add_checkpoint_options_to_parser(parser);
     SearchEngine::add_options_to_parser(parser);
     parser.add_option<shared_ptr<Group>>(
         "symmetries",
@@ -23,6 +23,7 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
         "use preferred operators of these heuristics", "[]");
 
     SearchEngine::add_pruning_option(parser);
+    eager_search::EagerSearch::add_checkpoint_options_to_parser(parser);
     SearchEngine::add_options_to_parser(parser);
     Options opts = parser.parse();
 
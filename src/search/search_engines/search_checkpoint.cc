@@ -0,0 +1,182 @@
+#include "search_checkpoint.h"
+
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace search_checkpoint {
+// Size of the buffer that collects the data before it is written.
+static const size_t BUFFER_BYTES = 16 << 20;
+
+// 64-bit FNV-1a hash, which can be computed incrementally.
+static const uint64_t CHECKSUM_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64_t CHECKSUM_PRIME = 1099511628211ULL;
+
+static uint64_t update_checksum(
+    uint64_t checksum, const char *data, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        checksum ^= static_cast<unsigned char>(data[i]);
+        checksum *= CHECKSUM_PRIME;
+    }
+    return checksum;
+}
+
+static void exit_with_write_error(const string &path) {
+    cerr << "Could not write checkpoint " << path << endl;
+    utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+}
+
+CheckpointWriter::CheckpointWriter(const string &path, bool append_checksum)
+    : path(path),
+      temporary_path(
+          path + "." + to_string(utils::get_process_id()) + ".tmp"),
+      stream(fopen(temporary_path.c_str(), "wb")),
+      bytes_written(0),
+      append_checksum(append_checksum),
+      checksum(CHECKSUM_OFFSET_BASIS) {
+    if (!stream) {
+        exit_with_write_error(temporary_path);
+    }
+    buffer.reserve(BUFFER_BYTES);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    if (stream) {
+        // The checkpoint was not committed.
+        fclose(stream);
+        remove(temporary_path.c_str());
+    }
+}
+
+void CheckpointWriter::write(const void *data, size_t bytes) {
+    const char *chars = static_cast<const char *>(data);
+    if (append_checksum)
+        checksum = update_checksum(checksum, chars, bytes);
+    while (bytes > 0) {
+        if (buffer.size() == BUFFER_BYTES) {
+            if (fwrite(buffer.data(), 1, buffer.size(), stream) != buffer.size())
+                exit_with_write_error(temporary_path);
+            buffer.clear();
+        }
+        size_t chunk = min(bytes, BUFFER_BYTES - buffer.size());
+        buffer.insert(buffer.end(), chars, chars + chunk);
+        chars += chunk;
+        bytes -= chunk;
+        bytes_written += chunk;
+    }
+}
+
+void CheckpointWriter::commit() {
+    if (append_checksum) {
+        // The checksum does not cover itself.
+        append_checksum = false;
+        write_value(checksum);
+    }
+    if (fwrite(buffer.data(), 1, buffer.size(), stream) != buffer.size() ||
+        fclose(stream) != 0) {
+        stream = nullptr;
+        exit_with_write_error(temporary_path);
+    }
+    stream = nullptr;
+    vector<char>().swap(buffer);
+    if (rename(temporary_path.c_str(), path.c_str()) != 0) {
+        exit_with_write_error(path);
+    }
+}
+
+
+static void exit_with_read_error(const string &path) {
+    cerr << "Could not read checkpoint " << path << endl;
+    utils::exit_with(utils::ExitCode::INPUT_ERROR);
+}
+
+CheckpointReader::CheckpointReader(const string &path)
+    : path(path),
+      data(nullptr),
+      size(0),
+      pos(0) {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    int file_descriptor = open(path.c_str(), O_RDONLY);
+    struct stat file_status;
+    if (file_descriptor == -1 || fstat(file_descriptor, &file_status) == -1) {
+        exit_with_read_error(path);
+    }
+    size = file_status.st_size;
+    if (size > 0) {
+        void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE,
+                             file_descriptor, 0);
+        if (mapping == MAP_FAILED) {
+            exit_with_read_error(path);
+        }
+        data = static_cast<const char *>(mapping);
+    }
+    // The mapping stays valid after closing the file.
+    close(file_descriptor);
+#else
+    ifstream file(path, ios::binary);
+    if (!file) {
+        exit_with_read_error(path);
+    }
+    file_contents.assign(istreambuf_iterator<char>(file),
+                         istreambuf_iterator<char>());
+    data = file_contents.data();
+    size = file_contents.size();
+#endif
+}
+
+CheckpointReader::~CheckpointReader() {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    if (data) {
+        munmap(const_cast<char *>(data), size);
+    }
+#endif
+}
+
+const void *CheckpointReader::read(size_t bytes) {
+    if (bytes > size - pos) {
+        cerr << "Checkpoint " << path << " is truncated." << endl;
+        utils::exit_with(utils::ExitCode::INPUT_ERROR);
+    }
+    const char *result = data + pos;
+    pos += bytes;
+    return result;
+}
+
+bool CheckpointReader::verify_checksum() {
+    uint64_t expected_checksum;
+    if (size - pos < sizeof(expected_checksum))
+        return false;
+    size_t data_size = size - sizeof(expected_checksum);
+    memcpy(&expected_checksum, data + data_size, sizeof(expected_checksum));
+    if (update_checksum(CHECKSUM_OFFSET_BASIS, data, data_size) !=
+        expected_checksum)
+        return false;
+    size = data_size;
+    return true;
+}
+
+bool checkpoint_exists(const string &path) {
+    return ifstream(path).good();
+}
+
+void remove_checkpoint(const string &path) {
+    if (remove(path.c_str()) != 0 && errno != ENOENT) {
+        cerr << "Could not remove checkpoint " << path << ": "
+             << strerror(errno) << endl;
+        utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+    }
+}
+}
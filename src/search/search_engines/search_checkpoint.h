@@ -0,0 +1,119 @@
+#ifndef SEARCH_ENGINES_SEARCH_CHECKPOINT_H
+#define SEARCH_ENGINES_SEARCH_CHECKPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+  Files for suspending a search and resuming it later (see eager_search.h).
+  They are also used for the entries of the precomputation cache (see
+  task_utils/precomputation_cache.h).
+
+  A checkpoint is a sequence of values and arrays of trivially copyable
+  types. The writer collects them in a large buffer, so the file is
+  written with a few large sequential writes. It first writes to a
+  temporary file and renames it when it is complete, so a search that is
+  killed while writing never leaves a broken checkpoint behind. The name
+  of the temporary file contains the process ID, so several planners can
+  write the same file at the same time. The reader maps the file into
+  memory, so arrays can be read without copying them.
+*/
+namespace search_checkpoint {
+class CheckpointWriter {
+    const std::string path;
+    const std::string temporary_path;
+    FILE *stream;
+    std::vector<char> buffer;
+    size_t bytes_written;
+    bool append_checksum;
+    uint64_t checksum;
+
+public:
+    /*
+      If append_checksum is true, commit() appends a checksum of the
+      written data, which the reader can check with verify_checksum().
+    */
+    explicit CheckpointWriter(
+        const std::string &path, bool append_checksum = false);
+    ~CheckpointWriter();
+
+    void write(const void *data, size_t bytes);
+
+    template<class T>
+    void write_value(const T &value) {
+        write(&value, sizeof(T));
+    }
+
+    // Write the size of the vector followed by its elements.
+    template<class T>
+    void write_vector(const std::vector<T> &values) {
+        write_value(static_cast<uint64_t>(values.size()));
+        write(values.data(), values.size() * sizeof(T));
+    }
+
+    // Complete the file and move it to its final path.
+    void commit();
+
+    size_t get_bytes_written() const {
+        return bytes_written;
+    }
+};
+
+class CheckpointReader {
+    const std::string path;
+    const char *data;
+    size_t size;
+    size_t pos;
+    // Used if memory mapping is not available.
+    std::vector<char> file_contents;
+
+public:
+    explicit CheckpointReader(const std::string &path);
+    ~CheckpointReader();
+
+    /*
+      Return a pointer to the next bytes of the file. The memory is valid
+      as long as the reader exists, but may not be aligned.
+    */
+    const void *read(size_t bytes);
+
+    /*
+      Return true iff the file ends with a valid checksum of the data
+      before it, as written by a writer with append_checksum. The
+      checksum itself is excluded from the data that can be read.
+    */
+    bool verify_checksum();
+
+    template<class T>
+    T read_value() {
+        T value;
+        memcpy(&value, read(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    // Read a vector written by CheckpointWriter::write_vector.
+    template<class T>
+    std::vector<T> read_vector() {
+        size_t size = read_value<uint64_t>();
+        std::vector<T> values(size);
+        const void *data = read(size * sizeof(T));
+        if (size > 0)
+            memcpy(values.data(), data, size * sizeof(T));
+        return values;
+    }
+
+    size_t get_size() const {
+        return size;
+    }
+};
+
+extern bool checkpoint_exists(const std::string &path);
+// Remove the checkpoint if it exists.
+extern void remove_checkpoint(const std::string &path);
+}
+
+#endif
@@ -1,5 +1,7 @@
 #include "search_common.h"
 
+#include "../globals.h"
+#include "../heuristic.h"
 #include "../open_list_factory.h"
 #include "../option_parser_util.h"
 
@@ -8,9 +10,12 @@
 #include "../evaluators/weighted_evaluator.h"
 
 #include "../open_lists/alternation_open_list.h"
+#include "../open_lists/bucket_open_list.h"
 #include "../open_lists/standard_scalar_open_list.h"
 #include "../open_lists/tiebreaking_open_list.h"
 
+#include "../task_utils/task_properties.h"
+
 #include <memory>
 
 using namespace std;
@@ -20,6 +25,14 @@ using GEval = g_evaluator::GEvaluator;
 using SumEval = sum_evaluator::SumEvaluator;
 using WeightedEval = weighted_evaluator::WeightedEvaluator;
 
+/*
+  Bucket open lists store a bucket for every value between the smallest
+  and the largest key in the open list. For A*, the range of the f and h
+  values in the open list grows with the action costs, so we only use
+  them automatically if all action costs are at most this bound.
+*/
+static const int MAX_OPERATOR_COST_FOR_BUCKETS = 100;
+
 shared_ptr<OpenListFactory> create_standard_scalar_open_list_factory(
     Evaluator *eval, bool pref_only) {
     Options options;
@@ -120,8 +133,20 @@ create_astar_open_list_factory_and_f_eval(const Options &opts) {
     options.set("evals", evals);
     options.set("pref_only", false);
     options.set("unsafe_pruning", false);
-    shared_ptr<OpenListFactory> open =
-        make_shared<tiebreaking_open_list::TieBreakingOpenListFactory>(options);
+    shared_ptr<OpenListFactory> open;
+    /*
+      Heuristics have finite non-negative values for all states that are
+      not dead ends, and so do their f values since operator costs are
+      non-negative. For other evaluators, we cannot be sure.
+    */
+    if (dynamic_cast<Heuristic *>(h) &&
+        task_properties::get_max_operator_cost(TaskProxy(*g_root_task())) <=
+        MAX_OPERATOR_COST_FOR_BUCKETS) {
+        options.set("lifo", false);
+        open = make_shared<bucket_open_list::BucketOpenListFactory>(options);
+    } else {
+        open = make_shared<tiebreaking_open_list::TieBreakingOpenListFactory>(options);
+    }
     return make_pair(open, f);
 }
 }
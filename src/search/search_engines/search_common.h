@@ -73,7 +73,9 @@ extern std::shared_ptr<OpenListFactory> create_wastar_open_list_factory(
 
   The resulting open list factory produces a tie-breaking open list
   ordered primarily on g + h and secondarily on h. Uses "eval" from
-  the passed-in Options object as the h evaluator.
+  the passed-in Options object as the h evaluator. If it is a heuristic,
+  the open list is a bucket open list, which orders entries in the same
+  way but is faster.
 */
 extern std::pair<std::shared_ptr<OpenListFactory>, Evaluator *>
 create_astar_open_list_factory_and_f_eval(const options::Options &opts);
@@ -4,9 +4,11 @@
 #include "globals.h"
 #include "task_proxy.h"
 
+#include "algorithms/segment_allocator.h"
 #include "structural_symmetries/group.h"
 #include "structural_symmetries/permutation.h"
 #include "task_utils/successor_generator.h"
+#include "utils/system.h"
 
 #include <cassert>
 #include "search_node_info.h"
@@ -99,6 +101,27 @@ void SearchNode::update_parent(const SearchNode &parent_node,
     info.creating_operator = OperatorID(parent_op.get_id());
 }
 
+void SearchNode::open(int g, int real_g, StateID parent_state_id,
+                      OperatorID creating_operator) {
+    assert(info.status == SearchNodeInfo::NEW);
+    info.status = SearchNodeInfo::OPEN;
+    info.g = g;
+    info.real_g = real_g;
+    info.parent_state_id = parent_state_id;
+    info.creating_operator = creating_operator;
+}
+
+void SearchNode::reopen(int g, int real_g, StateID parent_state_id,
+                        OperatorID creating_operator) {
+    assert(info.status == SearchNodeInfo::OPEN ||
+           info.status == SearchNodeInfo::CLOSED);
+    info.status = SearchNodeInfo::OPEN;
+    info.g = g;
+    info.real_g = real_g;
+    info.parent_state_id = parent_state_id;
+    info.creating_operator = creating_operator;
+}
+
 void SearchNode::close() {
     assert(info.status == SearchNodeInfo::OPEN);
     info.status = SearchNodeInfo::CLOSED;
@@ -108,6 +131,14 @@ void SearchNode::mark_as_dead_end() {
     info.status = SearchNodeInfo::DEAD_END;
 }
 
+StateID SearchNode::get_parent_state_id() const {
+    return info.parent_state_id;
+}
+
+OperatorID SearchNode::get_creating_operator() const {
+    return info.creating_operator;
+}
+
 void SearchNode::dump(const TaskProxy &task_proxy) const {
     cout << state_id << ": ";
     get_state().dump_fdr();
@@ -269,4 +300,9 @@ void SearchSpace::dump(const TaskProxy &task_proxy) const {
 void SearchSpace::print_statistics() const {
     cout << "Number of registered states: "
          << state_registry.size() << endl;
+    segmented_vector::print_segment_statistics();
+    cout << "Resident memory: " << utils::get_resident_memory_in_kb()
+         << " KB" << endl;
+    cout << "Page faults: " << utils::get_minor_page_faults() << " minor, "
+         << utils::get_major_page_faults() << " major" << endl;
 }
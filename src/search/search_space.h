@@ -45,9 +45,29 @@ public:
                 const OperatorProxy &parent_op);
     void update_parent(const SearchNode &parent_node,
                        const OperatorProxy &parent_op);
+    /*
+      Variants of open() and reopen() for parents that are only known by
+      their ID and g values, e.g., because they are stored in a different
+      search space (see hda_search.h).
+    */
+    void open(int g, int real_g, StateID parent_state_id,
+              OperatorID creating_operator);
+    void reopen(int g, int real_g, StateID parent_state_id,
+                OperatorID creating_operator);
     void close();
     void mark_as_dead_end();
 
+    StateID get_parent_state_id() const;
+    OperatorID get_creating_operator() const;
+
+    // Used to save and restore search spaces (see eager_search.h).
+    const SearchNodeInfo &get_info() const {
+        return info;
+    }
+    void set_info(const SearchNodeInfo &new_info) {
+        info = new_info;
+    }
+
     void dump(const TaskProxy &task_proxy) const;
 };
 
@@ -6,29 +6,38 @@
 #include "structural_symmetries/group.h"
 #include "structural_symmetries/permutation.h"
 
+#include <algorithm>
+#include <random>
+
 using namespace std;
 
 StateRegistry::StateRegistry(
     const AbstractTask &task, const int_packer::IntPacker &state_packer,
-    AxiomEvaluator &axiom_evaluator, const vector<int> &initial_state_data)
+    AxiomEvaluator &axiom_evaluator, const vector<int> &initial_state_data,
+    bool use_incremental_hashing)
     : task(task),
       state_packer(state_packer),
       axiom_evaluator(axiom_evaluator),
       initial_state_data(initial_state_data),
       num_variables(initial_state_data.size()),
       state_data_pool(get_bins_per_state()),
+      use_incremental_hashing(use_incremental_hashing),
       canonical_state_data_pool(get_bins_per_state()),
       registered_states(
-          0,
-          StateIDSemanticHash(state_data_pool, get_bins_per_state()),
+          StateIDSemanticHash(
+              state_data_pool, get_bins_per_state(),
+              use_incremental_hashing ? &state_hashes : nullptr),
           StateIDSemanticEqual(state_data_pool, get_bins_per_state())),
       canonical_registered_states(
-          0,
           StateIDSemanticHash(canonical_state_data_pool, get_bins_per_state()),
           StateIDSemanticEqual(canonical_state_data_pool, get_bins_per_state())),
       group(0),
       has_symmetries_and_uses_dks(false),
       cached_initial_state(0) {
+    if (use_incremental_hashing) {
+        initialize_zobrist_keys();
+    }
+    compile_packed_effects();
 }
 
 
@@ -40,6 +49,79 @@ StateRegistry::~StateRegistry() {
     delete cached_initial_state;
 }
 
+void StateRegistry::initialize_zobrist_keys() {
+    TaskProxy task_proxy(task);
+    // Use a fixed seed to make searches reproducible.
+    mt19937 rng(2018);
+    for (VariableProxy var : task_proxy.get_variables()) {
+        fact_offsets.push_back(zobrist_keys.size());
+        for (int value = 0; value < var.get_domain_size(); ++value) {
+            zobrist_keys.push_back(rng());
+        }
+        if (var.is_derived()) {
+            derived_variables.push_back(var.get_id());
+        }
+    }
+}
+
+StateRegistry::ZobristHash StateRegistry::compute_zobrist_hash(
+    const PackedStateBin *buffer) const {
+    ZobristHash hash = 0;
+    for (int var = 0; var < num_variables; ++var) {
+        hash ^= get_zobrist_key(var, state_packer.get(buffer, var));
+    }
+    return hash;
+}
+
+void StateRegistry::compile_packed_effects() {
+    OperatorsProxy operators = TaskProxy(task).get_operators();
+    packed_effects_begin.reserve(operators.size() + 1);
+    operator_has_conditional_effects.reserve(operators.size());
+    for (OperatorProxy op : operators) {
+        int begin = packed_effects.size();
+        packed_effects_begin.push_back(begin);
+        bool has_conditional_effects = false;
+        for (EffectProxy effect : op.get_effects()) {
+            if (!effect.get_conditions().empty()) {
+                has_conditional_effects = true;
+                break;
+            }
+        }
+        operator_has_conditional_effects.push_back(has_conditional_effects);
+        if (has_conditional_effects) {
+            continue;
+        }
+        for (EffectProxy effect : op.get_effects()) {
+            FactPair fact = effect.get_fact().get_pair();
+            int bin = state_packer.get_bin_index(fact.var);
+            PackedStateBin clear_mask = state_packer.get_clear_mask(fact.var);
+            PackedStateBin value_bits = state_packer.get_value_bits(fact.var, fact.value);
+            auto it = find_if(
+                packed_effects.begin() + begin, packed_effects.end(),
+                [bin](const PackedEffect &packed_effect) {
+                    return packed_effect.bin == bin;
+                });
+            if (it == packed_effects.end()) {
+                packed_effects.push_back({bin, clear_mask, value_bits});
+            } else {
+                it->clear_mask &= clear_mask;
+                it->value_bits = (it->value_bits & clear_mask) | value_bits;
+            }
+        }
+    }
+    packed_effects_begin.push_back(packed_effects.size());
+}
+
+void StateRegistry::apply_packed_effects(int op_id, PackedStateBin *buffer) const {
+    assert(!operator_has_conditional_effects[op_id]);
+    const PackedEffect *end = packed_effects.data() + packed_effects_begin[op_id + 1];
+    for (const PackedEffect *effect = packed_effects.data() + packed_effects_begin[op_id];
+         effect != end; ++effect) {
+        PackedStateBin &bin = buffer[effect->bin];
+        bin = (bin & effect->clear_mask) | effect->value_bits;
+    }
+}
+
 void StateRegistry::set_group(const shared_ptr<Group> &group_) {
     // Group is only set from eager_search if it has symmetries and uses DKS.
     group = group_;
@@ -47,6 +129,11 @@ void StateRegistry::set_group(const shared_ptr<Group> &group_) {
 }
 
 StateID StateRegistry::insert_id_or_pop_state() {
+    if (use_incremental_hashing && state_hashes.size() < state_data_pool.size()) {
+        // The caller did not compute the hash value incrementally.
+        state_hashes.push_back(
+            compute_zobrist_hash(state_data_pool[state_data_pool.size() - 1]));
+    }
     if (has_symmetries_and_uses_dks) {
         return insert_id_or_pop_state_dks();
     }
@@ -56,14 +143,17 @@ StateID StateRegistry::insert_id_or_pop_state() {
       is present), we have to remove the duplicate entry from the
       state data pool.
     */
-    StateID id(state_data_pool.size() - 1);
-    pair<StateIDSet::iterator, bool> result = registered_states.insert(id);
+    int id = state_data_pool.size() - 1;
+    pair<int, bool> result = registered_states.insert(id);
     bool is_new_entry = result.second;
     if (!is_new_entry) {
         state_data_pool.pop_back();
+        if (use_incremental_hashing) {
+            state_hashes.pop_back();
+        }
     }
     assert(registered_states.size() == state_data_pool.size());
-    return *result.first;
+    return StateID(result.first);
 }
 
 StateID StateRegistry::insert_id_or_pop_state_dks() {
@@ -86,14 +176,17 @@ StateID StateRegistry::insert_id_or_pop_state_dks() {
     canonical_state_data_pool.push_back(canonical_buffer);
     delete[] canonical_buffer;
 
-    pair<StateIDSet::iterator, bool> result = canonical_registered_states.insert(id);
+    pair<int, bool> result = canonical_registered_states.insert(id.value);
     bool is_new_entry = result.second;
     if (!is_new_entry) {
         state_data_pool.pop_back();
         canonical_state_data_pool.pop_back();
+        if (use_incremental_hashing) {
+            state_hashes.pop_back();
+        }
     }
     assert(canonical_registered_states.size() == state_data_pool.size());
-    return *result.first;
+    return StateID(result.first);
 }
 
 GlobalState StateRegistry::lookup_state(StateID id) const {
@@ -125,29 +218,102 @@ GlobalState StateRegistry::get_successor_state(const GlobalState &predecessor, c
     assert(!op.is_axiom());
     state_data_pool.push_back(predecessor.get_packed_buffer());
     PackedStateBin *buffer = state_data_pool[state_data_pool.size() - 1];
-    for (EffectProxy effect : op.get_effects()) {
-        if (does_fire(effect, predecessor)) {
-            FactPair effect_pair = effect.get_fact().get_pair();
-            state_packer.set(buffer, effect_pair.var, effect_pair.value);
+    /*
+      We can only update the hash value of the predecessor if it is
+      registered here. Otherwise, insert_id_or_pop_state() hashes the
+      complete successor.
+    */
+    bool update_hash = use_incremental_hashing &&
+        &predecessor.get_registry() == this;
+    ZobristHash hash = update_hash ? state_hashes[predecessor.get_id().value] : 0;
+    if (operator_has_conditional_effects[op.get_id()]) {
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, predecessor)) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                if (update_hash) {
+                    hash ^= get_zobrist_key(
+                        effect_pair.var, state_packer.get(buffer, effect_pair.var));
+                    hash ^= get_zobrist_key(effect_pair.var, effect_pair.value);
+                }
+                state_packer.set(buffer, effect_pair.var, effect_pair.value);
+            }
+        }
+    } else {
+        if (update_hash) {
+            for (EffectProxy effect : op.get_effects()) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                hash ^= get_zobrist_key(effect_pair.var, predecessor[effect_pair.var]);
+                hash ^= get_zobrist_key(effect_pair.var, effect_pair.value);
+            }
         }
+        apply_packed_effects(op.get_id(), buffer);
     }
     axiom_evaluator.evaluate(buffer, state_packer);
+    if (update_hash) {
+        for (int var : derived_variables) {
+            hash ^= get_zobrist_key(var, predecessor[var]);
+            hash ^= get_zobrist_key(var, state_packer.get(buffer, var));
+        }
+        state_hashes.push_back(hash);
+        assert(hash == compute_zobrist_hash(buffer));
+    }
     StateID id = insert_id_or_pop_state();
     return lookup_state(id);
 }
 
 GlobalState StateRegistry::register_state_buffer(const vector<int> &state) {
-    PackedStateBin *buffer = new PackedStateBin[g_state_packer->get_num_bins()];
-    fill_n(buffer, g_state_packer->get_num_bins(), 0);
-    for (size_t i = 0; i < g_variable_domain.size(); ++i) {
-        g_state_packer->set(buffer, i, state[i]);
+    // Avoid garbage values in half-full bins.
+    packed_state_buffer.assign(get_bins_per_state(), 0);
+    for (int var = 0; var < num_variables; ++var) {
+        state_packer.set(packed_state_buffer.data(), var, state[var]);
     }
+    return register_packed_state(packed_state_buffer.data());
+}
+
+GlobalState StateRegistry::register_packed_state(const PackedStateBin *buffer) {
     state_data_pool.push_back(buffer);
-    delete[] buffer;
     StateID id = insert_id_or_pop_state();
     return lookup_state(id);
 }
 
+void StateRegistry::compute_successor_buffer(
+    const GlobalState &predecessor, const OperatorProxy &op,
+    const Group *group, vector<PackedStateBin> &buffer) {
+    assert(!op.is_axiom());
+    const PackedStateBin *predecessor_buffer = predecessor.get_packed_buffer();
+    buffer.assign(predecessor_buffer, predecessor_buffer + get_bins_per_state());
+    if (operator_has_conditional_effects[op.get_id()]) {
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, predecessor)) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                state_packer.set(buffer.data(), effect_pair.var, effect_pair.value);
+            }
+        }
+    } else {
+        apply_packed_effects(op.get_id(), buffer.data());
+    }
+    axiom_evaluator.evaluate(buffer.data(), state_packer);
+    if (group) {
+        vector<int> &values = unpacked_state_buffer;
+        values.resize(num_variables);
+        for (int var = 0; var < num_variables; ++var) {
+            values[var] = state_packer.get(buffer.data(), var);
+        }
+        group->compute_canonical_representative(values);
+        // Avoid garbage values in half-full bins.
+        fill(buffer.begin(), buffer.end(), 0);
+        for (int var = 0; var < num_variables; ++var) {
+            state_packer.set(buffer.data(), var, values[var]);
+        }
+    }
+}
+
+GlobalState StateRegistry::get_canonical_successor_state(
+    const GlobalState &predecessor, const OperatorProxy &op, const Group &group) {
+    compute_successor_buffer(predecessor, op, &group, packed_state_buffer);
+    return register_packed_state(packed_state_buffer.data());
+}
+
 GlobalState StateRegistry::permute_state(const GlobalState &state, const Permutation &permutation) {
     PackedStateBin *buffer = new PackedStateBin[g_state_packer->get_num_bins()];
     fill_n(buffer, g_state_packer->get_num_bins(), 0);
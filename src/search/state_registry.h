@@ -6,12 +6,13 @@
 #include "global_state.h"
 #include "state_id.h"
 
+#include "algorithms/int_hash_set.h"
 #include "algorithms/int_packer.h"
 #include "algorithms/segmented_vector.h"
 #include "utils/hash.h"
 
+#include <cstdint>
 #include <set>
-#include <unordered_set>
 
 /*
   Overview of classes relevant to storing and working with registered states.
@@ -103,18 +104,27 @@ class Permutation;
 class PerStateInformationBase;
 
 class StateRegistry {
+    using ZobristHash = std::uint32_t;
+
     struct StateIDSemanticHash {
         const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
         int state_size;
+        // If given, return the stored hash values instead of hashing the state data.
+        const segmented_vector::SegmentedVector<ZobristHash> *state_hashes;
         StateIDSemanticHash(
             const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
-            int state_size)
+            int state_size,
+            const segmented_vector::SegmentedVector<ZobristHash> *state_hashes = nullptr)
             : state_data_pool(state_data_pool),
-              state_size(state_size) {
+              state_size(state_size),
+              state_hashes(state_hashes) {
         }
 
-        size_t operator()(StateID id) const {
-            const PackedStateBin *data = state_data_pool[id.value];
+        size_t operator()(int id) const {
+            if (state_hashes) {
+                return (*state_hashes)[id];
+            }
+            const PackedStateBin *data = state_data_pool[id];
             utils::HashState hash_state;
             for (int i = 0; i < state_size; ++i) {
                 hash_state.feed(data[i]);
@@ -133,9 +143,9 @@ class StateRegistry {
               state_size(state_size) {
         }
 
-        bool operator()(StateID lhs, StateID rhs) const {
-            const PackedStateBin *lhs_data = state_data_pool[lhs.value];
-            const PackedStateBin *rhs_data = state_data_pool[rhs.value];
+        bool operator()(int lhs, int rhs) const {
+            const PackedStateBin *lhs_data = state_data_pool[lhs];
+            const PackedStateBin *rhs_data = state_data_pool[rhs];
             return std::equal(lhs_data, lhs_data + state_size, rhs_data);
         }
     };
@@ -145,7 +155,7 @@ class StateRegistry {
       this registry and find their IDs. States are compared/hashed semantically,
       i.e. the actual state data is compared, not the memory location.
     */
-    using StateIDSet = std::unordered_set<StateID, StateIDSemanticHash, StateIDSemanticEqual>;
+    using StateIDSet = int_hash_set::IntHashSet<StateIDSemanticHash, StateIDSemanticEqual>;
 
     /* TODO: The state registry still doesn't use the task interface completely.
              Fixing this is part of issue509. */
@@ -161,6 +171,37 @@ class StateRegistry {
     const int num_variables;
 
     segmented_vector::SegmentedArrayVector<PackedStateBin> state_data_pool;
+    /*
+      With incremental hashing, the hash value of a state is the XOR of
+      random keys of its facts (Zobrist hashing). Then the hash value of a
+      successor follows from the hash value of its predecessor and the facts
+      that change, so we store the hash values of all registered states
+      (indexed like state_data_pool).
+    */
+    const bool use_incremental_hashing;
+    segmented_vector::SegmentedVector<ZobristHash> state_hashes;
+    // The key of fact (var, value) is zobrist_keys[fact_offsets[var] + value].
+    std::vector<ZobristHash> zobrist_keys;
+    std::vector<int> fact_offsets;
+    // Derived variables can change after applying an operator without effects on them.
+    std::vector<int> derived_variables;
+
+    /*
+      Effects of operators without conditional effects, precompiled for the
+      packed state representation: applying an operator sets
+      buffer[bin] = (buffer[bin] & clear_mask) | value_bits for each of its
+      packed effects. Effects on variables in the same bin are merged, so
+      this touches every bin at most once.
+    */
+    struct PackedEffect {
+        int bin;
+        PackedStateBin clear_mask;
+        PackedStateBin value_bits;
+    };
+    // The packed effects of operator i are in [packed_effects_begin[i], packed_effects_begin[i + 1]).
+    std::vector<PackedEffect> packed_effects;
+    std::vector<int> packed_effects_begin;
+    std::vector<bool> operator_has_conditional_effects;
     // Used for DKS
     segmented_vector::SegmentedArrayVector<PackedStateBin> canonical_state_data_pool;
     StateIDSet registered_states;
@@ -174,14 +215,31 @@ class StateRegistry {
     GlobalState *cached_initial_state;
     mutable std::set<PerStateInformationBase *> subscribers;
 
+    // Reused for registering unpacked states to avoid allocations.
+    std::vector<int> unpacked_state_buffer;
+    std::vector<PackedStateBin> packed_state_buffer;
+
     StateID insert_id_or_pop_state();
     // Used for DKS
     StateID insert_id_or_pop_state_dks();
     int get_bins_per_state() const;
+    void initialize_zobrist_keys();
+    ZobristHash get_zobrist_key(int var, int value) const {
+        return zobrist_keys[fact_offsets[var] + value];
+    }
+    ZobristHash compute_zobrist_hash(const PackedStateBin *buffer) const;
+    void compile_packed_effects();
+    void apply_packed_effects(int op_id, PackedStateBin *buffer) const;
 public:
+    /*
+      If use_incremental_hashing is true, duplicate detection for successor
+      states only hashes the facts changed by the operator instead of the
+      whole state (see state_hashes).
+    */
     StateRegistry(
         const AbstractTask &task, const int_packer::IntPacker &state_packer,
-        AxiomEvaluator &axiom_evaluator, const std::vector<int> &initial_state_data);
+        AxiomEvaluator &axiom_evaluator, const std::vector<int> &initial_state_data,
+        bool use_incremental_hashing = false);
     ~StateRegistry();
 
     // Used for DKS
@@ -227,6 +285,38 @@ public:
     */
     GlobalState register_state_buffer(const std::vector<int> &state);
 
+    /*
+      Computes the packed data of the state that results from applying op
+      to predecessor without registering it. If group is given, the result
+      is replaced by its canonical representative (OSS). The predecessor
+      may be registered in a different registry.
+      Used by searches that register successors in other registries (HDA*).
+    */
+    void compute_successor_buffer(
+        const GlobalState &predecessor, const OperatorProxy &op,
+        const Group *group, std::vector<PackedStateBin> &buffer);
+
+    /*
+      Registers and returns the state with the given packed data. This is
+      an expensive operation as it includes duplicate checking.
+    */
+    GlobalState register_packed_state(const PackedStateBin *buffer);
+
+    // Returns the packed data of the state registered at the given ID.
+    const PackedStateBin *get_packed_state(StateID id) const {
+        return state_data_pool[id.value];
+    }
+
+    /*
+      Applies op to predecessor, replaces the result by its canonical
+      representative under the given group and registers only the canonical
+      state. The successor is computed in buffers owned by the registry,
+      so this does not allocate memory apart from storing new states.
+      Used for OSS.
+    */
+    GlobalState get_canonical_successor_state(
+        const GlobalState &predecessor, const OperatorProxy &op, const Group &group);
+
     /*
       Creates the permutation of the given state (which can be registered
       somewhere else). Registers and returns the permuted state if this was not
@@ -1,5 +1,6 @@
 #include "graph_creator.h"
 
+#include "graph_image.h"
 #include "group.h"
 #include "permutation.h"
 
@@ -11,6 +12,8 @@
 
 #include "../bliss/graph.h"
 
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <map>
 
@@ -40,11 +43,82 @@ void add_permutation_to_group(void *group, unsigned int, const unsigned int *per
     ((Group*) group)->add_raw_generator(permutation);
 }
 
+/*
+  Write the graph to symmetry-graph.bin in the following binary format,
+  using native byte order:
+
+    char     magic[8]                  "SYMGRAPH"
+    uint32   version                   1
+    uint32   padding
+    uint64   num_vertices
+    uint64   num_edges
+    uint64   offsets[num_vertices + 1]
+    uint32   colors[num_vertices]
+    uint32   targets[num_edges]
+
+  The successors of vertex v are targets[offsets[v]], ...,
+  targets[offsets[v + 1] - 1], in the order in which the edges have been
+  added. All arrays are aligned to their element size, so that readers
+  can memory-map the file. It is assembled in memory and written at once.
+*/
+static void write_csr_graph(const bliss::Digraph &bliss_graph) {
+    const uint32_t version = 1;
+    uint64_t num_vertices = bliss_graph.get_nof_vertices();
+    vector<uint64_t> offsets;
+    offsets.reserve(num_vertices + 1);
+    offsets.push_back(0);
+    for (uint64_t vertex = 0; vertex < num_vertices; ++vertex) {
+        offsets.push_back(offsets.back() + bliss_graph.get_edges_out(vertex).size());
+    }
+    uint64_t num_edges = offsets.back();
+
+    size_t header_size = 8 + 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+    size_t offsets_size = offsets.size() * sizeof(uint64_t);
+    size_t colors_size = num_vertices * sizeof(uint32_t);
+    size_t targets_size = num_edges * sizeof(uint32_t);
+    vector<char> buffer(header_size + offsets_size + colors_size + targets_size, 0);
+
+    char *pos = buffer.data();
+    memcpy(pos, "SYMGRAPH", 8);
+    memcpy(pos + 8, &version, sizeof(version));
+    memcpy(pos + 16, &num_vertices, sizeof(num_vertices));
+    memcpy(pos + 24, &num_edges, sizeof(num_edges));
+    pos += header_size;
+    memcpy(pos, offsets.data(), offsets_size);
+    pos += offsets_size;
+    for (uint64_t vertex = 0; vertex < num_vertices; ++vertex) {
+        uint32_t color = bliss_graph.get_color(vertex);
+        memcpy(pos, &color, sizeof(color));
+        pos += sizeof(color);
+    }
+    for (uint64_t vertex = 0; vertex < num_vertices; ++vertex) {
+        const vector<unsigned int> &targets = bliss_graph.get_edges_out(vertex);
+        size_t size = targets.size() * sizeof(uint32_t);
+        static_assert(sizeof(unsigned int) == sizeof(uint32_t),
+                      "bliss vertices must be 32-bit");
+        if (size) {
+            memcpy(pos, targets.data(), size);
+        }
+        pos += size;
+    }
+    assert(pos == buffer.data() + buffer.size());
+
+    ofstream file("symmetry-graph.bin", ios::binary);
+    file.write(buffer.data(), buffer.size());
+    file.close();
+    if (!file) {
+        cerr << "Could not write symmetry-graph.bin" << endl;
+        utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+    }
+}
+
 bool GraphCreator::compute_symmetries(
     const TaskProxy &task_proxy,
     const bool stabilize_initial_state,
     const int time_bound,
     const bool dump_symmetry_graph,
+    const SymmetryGraphFormat symmetry_graph_format,
+    const bool write_symmetry_graph_image,
     const bool stop_after_symmetry_graph_creation,
     Group *group) {
     bool success = false;
@@ -54,7 +128,18 @@ bool GraphCreator::compute_symmetries(
         cout << "Initializing symmetries" << endl;
         bliss::Digraph bliss_graph = bliss::Digraph();
         create_bliss_directed_graph(
-            task_proxy, stabilize_initial_state, dump_symmetry_graph, group, bliss_graph);
+            task_proxy, stabilize_initial_state,
+            dump_symmetry_graph && symmetry_graph_format == SymmetryGraphFormat::TEXT,
+            group, bliss_graph);
+        if (dump_symmetry_graph && symmetry_graph_format == SymmetryGraphFormat::CSR) {
+            write_csr_graph(bliss_graph);
+        }
+        if (write_symmetry_graph_image) {
+            // Same file name as written by create-image-from-graph.py.
+            GraphImage image(bliss_graph);
+            image.write_png("graph-gs-L-bolded-cs.png");
+            cout << "Done writing symmetry graph image: " << timer << endl;
+        }
         if (stop_after_symmetry_graph_creation) {
             utils::exit_with(utils::ExitCode::PLAN_FOUND);
         }
@@ -138,7 +223,7 @@ struct DotGraph {
                 file << neighbor << ",";
             }
             if (node_index != neighbors.size() - 1) {
-                file << endl;
+                file << '\n';
             }
         }
         file.close();
@@ -1,6 +1,8 @@
 #ifndef STRUCTURAL_SYMMETRIES_GRAPH_CREATOR_H
 #define STRUCTURAL_SYMMETRIES_GRAPH_CREATOR_H
 
+#include "group.h"
+
 #include <vector>
 
 namespace bliss {
@@ -8,7 +10,6 @@ namespace bliss {
 }
 class DotGraph;
 class EffectsProxy;
-class Group;
 class OperatorProxy;
 class TaskProxy;
 
@@ -42,6 +43,8 @@ public:
         const bool stabilize_initial_state,
         const int time_bound,
         const bool dump_symmetry_graph,
+        const SymmetryGraphFormat symmetry_graph_format,
+        const bool write_symmetry_graph_image,
         const bool stop_after_symmetry_graph_creation,
         Group *group);
 };
@@ -0,0 +1,333 @@
+#include "graph_image.h"
+
+#include "../bliss/graph.h"
+
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+/*
+  PIL uses fixed-point arithmetic with this many fractional bits when
+  resampling 8-bit images. We replicate it to obtain identical images.
+*/
+static const int PRECISION_BITS = 32 - 8 - 2;
+static const int LANCZOS_SUPPORT = 3;
+static const double PI = 3.14159265358979323846;
+
+static double sinc(double x) {
+    if (x == 0.0)
+        return 1.0;
+    x = x * PI;
+    return sin(x) / x;
+}
+
+static double lanczos(double x) {
+    if (-LANCZOS_SUPPORT <= x && x < LANCZOS_SUPPORT)
+        return sinc(x) * sinc(x / LANCZOS_SUPPORT);
+    return 0.0;
+}
+
+static uint8_t clip8(int64_t value) {
+    if (value <= 0)
+        return 0;
+    value >>= PRECISION_BITS;
+    if (value > 255)
+        return 255;
+    return static_cast<uint8_t>(value);
+}
+
+/*
+  Filter weights for resampling one dimension of size in_size to size
+  out_size. Output index i reads the input indices [first[i], last[i]).
+  Both first and last are non-decreasing in i.
+*/
+struct ResampleCoefficients {
+    vector<int> first;
+    vector<int> last;
+    vector<vector<int64_t>> weights;
+    vector<int64_t> weight_sums;
+
+    ResampleCoefficients(int in_size, int out_size) {
+        double scale = static_cast<double>(in_size) / out_size;
+        double filter_scale = max(scale, 1.0);
+        double support = LANCZOS_SUPPORT * filter_scale;
+        for (int i = 0; i < out_size; ++i) {
+            double center = (i + 0.5) * scale;
+            int in_first = max(static_cast<int>(center - support + 0.5), 0);
+            int in_last = min(static_cast<int>(center + support + 0.5), in_size);
+            vector<double> float_weights;
+            double total = 0.0;
+            for (int x = in_first; x < in_last; ++x) {
+                double weight = lanczos((x - center + 0.5) / filter_scale);
+                float_weights.push_back(weight);
+                total += weight;
+            }
+            vector<int64_t> int_weights;
+            int64_t weight_sum = 0;
+            for (double weight : float_weights) {
+                if (total != 0.0)
+                    weight /= total;
+                weight *= (1 << PRECISION_BITS);
+                int64_t int_weight = static_cast<int64_t>(
+                    weight < 0 ? weight - 0.5 : weight + 0.5);
+                int_weights.push_back(int_weight);
+                weight_sum += int_weight;
+            }
+            first.push_back(in_first);
+            last.push_back(in_last);
+            weights.push_back(move(int_weights));
+            weight_sums.push_back(weight_sum);
+        }
+    }
+
+    // Output indices [first_out, last_out) read input index x.
+    void get_outputs_reading(int x, int &first_out, int &last_out) const {
+        first_out = upper_bound(last.begin(), last.end(), x) - last.begin();
+        last_out = upper_bound(first.begin(), first.end(), x) - first.begin();
+    }
+
+    int64_t get_weight(int out, int x) const {
+        return weights[out][x - first[out]];
+    }
+};
+
+GraphImage::GraphImage(
+    const bliss::Digraph &graph, int shrink_ratio, int target_size, bool bolded)
+    : shrink_ratio(shrink_ratio),
+      target_size(target_size),
+      bolded(bolded) {
+    /*
+      Larger shrink ratios produce 32-bit images in
+      create-image-from-graph.py, which the selection model does not use.
+    */
+    if (shrink_ratio < 2 || shrink_ratio > 3) {
+        cerr << "Graph images only support shrink ratios 2 and 3" << endl;
+        utils::exit_with(utils::ExitCode::UNSUPPORTED);
+    }
+    int num_vertices = graph.get_nof_vertices();
+    // Like create-image-from-graph.py, pad even if the size is divisible.
+    int padded_size = num_vertices + shrink_ratio - num_vertices % shrink_ratio;
+    shrunk_size = padded_size / shrink_ratio;
+    cout << "Rasterizing graph with " << num_vertices << " vertices into "
+         << shrunk_size << "x" << shrunk_size << " image, resized to "
+         << target_size << "x" << target_size << endl;
+
+    vector<uint64_t> shrunk_pixels = collect_shrunk_pixels(graph);
+    resample(shrunk_pixels);
+}
+
+/*
+  Every non-zero matrix entry (from, to) sets one bit of the shrunk pixel
+  in row to / shrink_ratio and column from / shrink_ratio. The entry is
+  encoded as (row << 33) | (column << 3) | bit, such that sorting groups
+  the bits of a pixel and orders pixels row by row.
+*/
+vector<uint64_t> GraphImage::collect_shrunk_pixels(const bliss::Digraph &graph) const {
+    int num_vertices = graph.get_nof_vertices();
+    int padded_size = shrunk_size * shrink_ratio;
+    assert(padded_size < (1 << 30));
+
+    size_t num_edges = 0;
+    for (int vertex = 0; vertex < num_vertices; ++vertex) {
+        num_edges += graph.get_edges_out(vertex).size();
+    }
+    vector<uint64_t> entries;
+    entries.reserve(bolded ? 5 * num_edges : num_edges);
+
+    auto add_entry = [&](int from, int to) {
+        if (from < 0 || from >= padded_size || to < 0 || to >= padded_size)
+            return;
+        int row_offset = from % shrink_ratio;
+        int col_offset = to % shrink_ratio;
+        // Diagonals of the blocks are not represented in the image.
+        if (row_offset == col_offset)
+            return;
+        int bit = col_offset * (shrink_ratio - 1) +
+            (row_offset < col_offset ? row_offset : row_offset - 1);
+        entries.push_back((static_cast<uint64_t>(to / shrink_ratio) << 33) |
+                          (static_cast<uint64_t>(from / shrink_ratio) << 3) |
+                          static_cast<uint64_t>(bit));
+    };
+
+    for (int from = 0; from < num_vertices; ++from) {
+        for (unsigned int to : graph.get_edges_out(from)) {
+            add_entry(from, to);
+            if (bolded) {
+                add_entry(from + 1, to);
+                add_entry(from - 1, to);
+                add_entry(from, to + 1);
+                add_entry(from, to - 1);
+            }
+        }
+    }
+    sort(entries.begin(), entries.end());
+    return entries;
+}
+
+/*
+  Resize the shrunk image with PIL's separable Lanczos filter, first along
+  rows, then along columns. White rows and columns are mapped to the same
+  values everywhere, so we only process rows containing non-white pixels
+  and express their contribution as difference to a white row.
+*/
+void GraphImage::resample(const vector<uint64_t> &shrunk_pixels) {
+    // create-image-from-graph.py sharpens 8-bit images by this factor.
+    const int sharpen_factor = 4;
+    const int64_t half = int64_t(1) << (PRECISION_BITS - 1);
+    ResampleCoefficients coefficients(shrunk_size, target_size);
+
+    vector<int> white_row(target_size);
+    for (int x = 0; x < target_size; ++x) {
+        white_row[x] = clip8(half + 255 * coefficients.weight_sums[x]);
+    }
+
+    vector<int64_t> result(target_size * target_size);
+    for (int y = 0; y < target_size; ++y) {
+        for (int x = 0; x < target_size; ++x) {
+            result[y * target_size + x] =
+                half + coefficients.weight_sums[y] * white_row[x];
+        }
+    }
+
+    vector<int64_t> row_sums(target_size);
+    size_t index = 0;
+    while (index < shrunk_pixels.size()) {
+        int row = shrunk_pixels[index] >> 33;
+
+        // Horizontal pass over one row containing non-white pixels.
+        for (int x = 0; x < target_size; ++x) {
+            row_sums[x] = half + 255 * coefficients.weight_sums[x];
+        }
+        while (index < shrunk_pixels.size() &&
+               static_cast<int>(shrunk_pixels[index] >> 33) == row) {
+            uint64_t pixel = shrunk_pixels[index] >> 3;
+            int col = pixel & ((uint64_t(1) << 30) - 1);
+            int bits = 0;
+            while (index < shrunk_pixels.size() &&
+                   (shrunk_pixels[index] >> 3) == pixel) {
+                bits |= 1 << (shrunk_pixels[index] & 7);
+                ++index;
+            }
+            int64_t darkness = sharpen_factor * bits;
+            int first_out, last_out;
+            coefficients.get_outputs_reading(col, first_out, last_out);
+            for (int x = first_out; x < last_out; ++x) {
+                row_sums[x] -= darkness * coefficients.get_weight(x, col);
+            }
+        }
+
+        // Vertical pass: add the difference to a white row.
+        int first_out, last_out;
+        coefficients.get_outputs_reading(row, first_out, last_out);
+        for (int y = first_out; y < last_out; ++y) {
+            int64_t weight = coefficients.get_weight(y, row);
+            for (int x = 0; x < target_size; ++x) {
+                result[y * target_size + x] +=
+                    weight * (clip8(row_sums[x]) - white_row[x]);
+            }
+        }
+    }
+
+    pixels.resize(target_size * target_size);
+    for (size_t i = 0; i < result.size(); ++i) {
+        pixels[i] = clip8(result[i]);
+    }
+}
+
+static uint32_t crc32(const vector<uint8_t> &data) {
+    static vector<uint32_t> table;
+    if (table.empty()) {
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            table.push_back(c);
+        }
+    }
+    uint32_t crc = 0xffffffffu;
+    for (uint8_t byte : data) {
+        crc = table[(crc ^ byte) & 0xff] ^ (crc >> 8);
+    }
+    return crc ^ 0xffffffffu;
+}
+
+static void append_uint32(vector<uint8_t> &data, uint32_t value) {
+    data.push_back(value >> 24);
+    data.push_back(value >> 16);
+    data.push_back(value >> 8);
+    data.push_back(value);
+}
+
+static void write_png_chunk(
+    ofstream &file, const string &type, const vector<uint8_t> &content) {
+    vector<uint8_t> chunk(type.begin(), type.end());
+    chunk.insert(chunk.end(), content.begin(), content.end());
+    vector<uint8_t> length;
+    append_uint32(length, content.size());
+    vector<uint8_t> crc;
+    append_uint32(crc, crc32(chunk));
+    file.write(reinterpret_cast<const char *>(length.data()), length.size());
+    file.write(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+    file.write(reinterpret_cast<const char *>(crc.data()), crc.size());
+}
+
+/*
+  Write an 8-bit grayscale PNG. The image is tiny, so we store the zlib
+  stream uncompressed instead of depending on zlib.
+*/
+void GraphImage::write_png(const string &filename) const {
+    vector<uint8_t> raw;
+    for (int y = 0; y < target_size; ++y) {
+        // Filter type "None".
+        raw.push_back(0);
+        raw.insert(raw.end(), pixels.begin() + y * target_size,
+                   pixels.begin() + (y + 1) * target_size);
+    }
+
+    vector<uint8_t> zlib_stream = {0x78, 0x01};
+    const size_t max_block_size = 65535;
+    for (size_t pos = 0; pos < raw.size(); pos += max_block_size) {
+        size_t block_size = min(max_block_size, raw.size() - pos);
+        bool final_block = pos + block_size == raw.size();
+        zlib_stream.push_back(final_block ? 1 : 0);
+        zlib_stream.push_back(block_size & 0xff);
+        zlib_stream.push_back(block_size >> 8);
+        zlib_stream.push_back(~block_size & 0xff);
+        zlib_stream.push_back((~block_size >> 8) & 0xff);
+        zlib_stream.insert(zlib_stream.end(), raw.begin() + pos,
+                           raw.begin() + pos + block_size);
+    }
+    uint32_t adler_a = 1;
+    uint32_t adler_b = 0;
+    for (uint8_t byte : raw) {
+        adler_a = (adler_a + byte) % 65521;
+        adler_b = (adler_b + adler_a) % 65521;
+    }
+    append_uint32(zlib_stream, (adler_b << 16) | adler_a);
+
+    vector<uint8_t> header;
+    append_uint32(header, target_size);
+    append_uint32(header, target_size);
+    // Bit depth 8, color type grayscale, default compression, filter, interlace.
+    header.insert(header.end(), {8, 0, 0, 0, 0});
+
+    ofstream file(filename, ios::binary);
+    const char signature[] = {'\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n'};
+    file.write(signature, sizeof(signature));
+    write_png_chunk(file, "IHDR", header);
+    write_png_chunk(file, "IDAT", zlib_stream);
+    write_png_chunk(file, "IEND", vector<uint8_t>());
+    file.close();
+    if (!file) {
+        cerr << "Could not write graph image " << filename << endl;
+        utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+    }
+    cout << "Wrote graph image " << filename << endl;
+}
@@ -0,0 +1,52 @@
+#ifndef STRUCTURAL_SYMMETRIES_GRAPH_IMAGE_H
+#define STRUCTURAL_SYMMETRIES_GRAPH_IMAGE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bliss {
+    class Digraph;
+}
+
+/*
+  Rasterize the adjacency matrix of a bliss graph into the constant size
+  grayscale image used by the planner selection model (dl_model/selector.py).
+
+  The result is identical to running create-image-from-graph.py with
+  --write-abstract-structure-image-reg, --bolding-abstract-structure-image
+  and --abstract-structure-image-target-size on the adjacency matrix
+  written by dump_symmetry_graph: the (bolded) 0/1 matrix is shrunk by
+  packing the off-diagonal entries of shrink_ratio x shrink_ratio blocks
+  into the bits of one pixel, and the shrunk image is resized with the
+  fixed-point Lanczos filter of PIL.
+
+  Neither the matrix nor the shrunk image are ever stored densely: we only
+  keep the non-white pixels of the shrunk image (at most five per edge)
+  and exploit that the Lanczos filter maps white rows and columns to
+  constant values. Memory is thus linear in the number of edges plus
+  target_size^2.
+*/
+class GraphImage {
+    const int shrink_ratio;
+    const int target_size;
+    const bool bolded;
+
+    // Number of rows (and columns) of the shrunk image.
+    int shrunk_size;
+    // Pixels of the final target_size x target_size image, row by row.
+    std::vector<uint8_t> pixels;
+
+    std::vector<uint64_t> collect_shrunk_pixels(const bliss::Digraph &graph) const;
+    void resample(const std::vector<uint64_t> &shrunk_pixels);
+public:
+    GraphImage(const bliss::Digraph &graph,
+               int shrink_ratio = 3,
+               int target_size = 128,
+               bool bolded = true);
+    ~GraphImage() = default;
+
+    void write_png(const std::string &filename) const;
+};
+
+#endif
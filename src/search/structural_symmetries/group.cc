@@ -9,10 +9,14 @@
 #include "../plugin.h"
 #include "../state_registry.h"
 #include "../task_proxy.h"
+#include "../task_utils/task_properties.h"
 #include "../utils/memory.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <fstream>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <queue>
 
@@ -20,13 +24,44 @@
 using namespace std;
 using namespace utils;
 
+static const char GENERATORS_FILE_MAGIC[8] = {'S', 'Y', 'M', 'G', 'E', 'N', 'S', '\0'};
+static const uint32_t GENERATORS_FILE_VERSION = 1;
+
+static string get_optional_string(const Options &opts, const string &key) {
+    return opts.contains(key) ? opts.get<string>(key) : string();
+}
+
+template<typename T>
+static void write_value(ofstream &file, const T &value) {
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+static void read_value(ifstream &file, T &value) {
+    file.read(reinterpret_cast<char *>(&value), sizeof(T));
+}
+
+static void write_ints(ofstream &file, const vector<int> &values) {
+    file.write(reinterpret_cast<const char *>(values.data()),
+               values.size() * sizeof(int));
+}
+
+static void read_ints(ifstream &file, vector<int> &values, int size) {
+    values.resize(size);
+    file.read(reinterpret_cast<char *>(values.data()), size * sizeof(int));
+}
+
 Group::Group(const options::Options &opts)
     : stabilize_initial_state(opts.get<bool>("stabilize_initial_state")),
       time_bound(opts.get<int>("time_bound")),
       dump_symmetry_graph(opts.get<bool>("dump_symmetry_graph")),
+      symmetry_graph_format(SymmetryGraphFormat(opts.get_enum("symmetry_graph_format"))),
+      write_symmetry_graph_image(opts.get<bool>("write_symmetry_graph_image")),
       stop_after_symmetry_graph_creation(opts.get<bool>("stop_after_symmetry_graph_creation")),
       search_symmetries(SearchSymmetries(opts.get_enum("search_symmetries"))),
       dump_permutations(opts.get<bool>("dump_permutations")),
+      save_generators_file(get_optional_string(opts, "save_generators")),
+      load_generators_file(get_optional_string(opts, "load_generators")),
       num_vars(0),
       permutation_length(0),
       num_identity_generators(0),
@@ -50,12 +85,27 @@ void Group::compute_symmetries(const TaskProxy &task_proxy) {
         cerr << "Already computed symmetries" << endl;
         exit_with(ExitCode::CRITICAL_ERROR);
     }
+    if (!load_generators_file.empty() && load_generators(task_proxy)) {
+        initialized = true;
+        return;
+    }
+    /*
+      If the generators should be saved, we still have to run Bliss after
+      creating the symmetry graph, and stop after saving them.
+    */
+    bool save = !save_generators_file.empty();
     GraphCreator graph_creator;
     bool success = graph_creator.compute_symmetries(
         task_proxy, stabilize_initial_state, time_bound,
-        stop_after_symmetry_graph_creation, dump_symmetry_graph, this);
+        dump_symmetry_graph, symmetry_graph_format, write_symmetry_graph_image,
+        stop_after_symmetry_graph_creation && !save, this);
     if (!success) {
         generators.clear();
+    } else if (save) {
+        save_generators(task_proxy);
+    }
+    if (stop_after_symmetry_graph_creation) {
+        exit_with(ExitCode::PLAN_FOUND);
     }
     // Set initialized to true regardless of whether symmetries have been
     // found or not to avoid future attempts at computing symmetries if
@@ -72,6 +122,177 @@ void Group::add_raw_generator(const unsigned int *generator) {
     }
 }
 
+/*
+  Generators files store the generators in the following binary format,
+  using native byte order:
+
+    char     magic[8]                  "SYMGENS"
+    uint32   version
+    uint64   hash of the task (see task_properties::compute_task_hash)
+    int32    stabilize_initial_state
+    int32    num_vars
+    int32    permutation_length
+    int32    num_identity_generators
+    int32    num_generators
+    int32    dom_sum_by_var[num_vars]
+    int32    var_by_val[permutation_length - num_vars]
+    int32    generators[num_generators][permutation_length]
+*/
+void Group::save_generators(const TaskProxy &task_proxy) const {
+    ofstream file(save_generators_file, ios::binary);
+    file.write(GENERATORS_FILE_MAGIC, sizeof(GENERATORS_FILE_MAGIC));
+    write_value(file, GENERATORS_FILE_VERSION);
+    write_value(file, task_properties::compute_task_hash(task_proxy));
+    write_value(file, static_cast<int32_t>(stabilize_initial_state));
+    write_value(file, static_cast<int32_t>(num_vars));
+    write_value(file, static_cast<int32_t>(permutation_length));
+    write_value(file, static_cast<int32_t>(num_identity_generators));
+    write_value(file, static_cast<int32_t>(get_num_generators()));
+    write_ints(file, dom_sum_by_var);
+    write_ints(file, var_by_val);
+    vector<int> values;
+    values.reserve(get_num_generators() * permutation_length);
+    for (const Permutation &generator : generators) {
+        for (int i = 0; i < permutation_length; ++i) {
+            values.push_back(generator.get_value(i));
+        }
+    }
+    write_ints(file, values);
+    file.close();
+    if (!file) {
+        cerr << "Could not write generators to " << save_generators_file << endl;
+        exit_with(ExitCode::CRITICAL_ERROR);
+    }
+    cout << "Saved " << get_num_generators() << " generators to "
+         << save_generators_file << endl;
+}
+
+void Group::exit_with_corrupt_generators_file(const string &reason) const {
+    cerr << "Corrupt generators file " << load_generators_file << ": "
+         << reason << endl;
+    exit_with(ExitCode::INPUT_ERROR);
+}
+
+/*
+  Return false if the file does not exist or does not belong to the
+  task, in which case we compute the symmetries from scratch. Exit with
+  an input error if the file belongs to the task but is inconsistent
+  with it.
+*/
+bool Group::load_generators(const TaskProxy &task_proxy) {
+    ifstream file(load_generators_file, ios::binary);
+    if (!file) {
+        cout << "Generators file " << load_generators_file
+             << " not found, computing symmetries" << endl;
+        return false;
+    }
+    char magic[sizeof(GENERATORS_FILE_MAGIC)];
+    file.read(magic, sizeof(magic));
+    uint32_t version = 0;
+    read_value(file, version);
+    uint64_t task_hash = 0;
+    read_value(file, task_hash);
+    int32_t stabilizes_initial_state = 0;
+    read_value(file, stabilizes_initial_state);
+    if (!file || !equal(magic, magic + sizeof(magic), GENERATORS_FILE_MAGIC) ||
+        version != GENERATORS_FILE_VERSION) {
+        cout << "Invalid generators file " << load_generators_file
+             << ", computing symmetries" << endl;
+        return false;
+    }
+    if (task_hash != task_properties::compute_task_hash(task_proxy) ||
+        static_cast<bool>(stabilizes_initial_state) != stabilize_initial_state) {
+        cout << "Generators file " << load_generators_file
+             << " belongs to a different task or configuration, "
+             << "computing symmetries" << endl;
+        return false;
+    }
+
+    /*
+      The file claims to belong to this task, so from here on any
+      inconsistency with the task means that the file is corrupt.
+    */
+    VariablesProxy vars = task_proxy.get_variables();
+    vector<int> task_dom_sum_by_var;
+    vector<int> task_var_by_val;
+    int task_permutation_length = vars.size();
+    for (VariableProxy var : vars) {
+        task_dom_sum_by_var.push_back(task_permutation_length);
+        task_permutation_length += var.get_domain_size();
+        task_var_by_val.insert(
+            task_var_by_val.end(), var.get_domain_size(), var.get_id());
+    }
+
+    int32_t file_num_vars = 0;
+    int32_t file_permutation_length = 0;
+    int32_t file_num_identity_generators = 0;
+    int32_t num_generators = 0;
+    read_value(file, file_num_vars);
+    read_value(file, file_permutation_length);
+    read_value(file, file_num_identity_generators);
+    read_value(file, num_generators);
+    if (file && (file_num_vars != static_cast<int>(vars.size()) ||
+                 file_permutation_length != task_permutation_length ||
+                 file_num_identity_generators < 0 || num_generators < 0 ||
+                 static_cast<int64_t>(num_generators) * file_permutation_length >
+                 numeric_limits<int>::max())) {
+        exit_with_corrupt_generators_file("header does not match the task");
+    }
+    if (file) {
+        // Check the size before allocating memory for the contents.
+        streampos contents_begin = file.tellg();
+        file.seekg(0, ios::end);
+        int64_t contents_size = file.tellg() - contents_begin;
+        file.seekg(contents_begin);
+        int64_t num_ints = file_permutation_length +
+            static_cast<int64_t>(num_generators) * file_permutation_length;
+        if (contents_size < num_ints * static_cast<int64_t>(sizeof(int)))
+            exit_with_corrupt_generators_file("file is truncated");
+    }
+    vector<int> file_dom_sum_by_var;
+    vector<int> file_var_by_val;
+    vector<int> values;
+    if (file) {
+        read_ints(file, file_dom_sum_by_var, file_num_vars);
+        read_ints(file, file_var_by_val, file_permutation_length - file_num_vars);
+        read_ints(file, values, num_generators * file_permutation_length);
+    }
+    if (!file) {
+        exit_with_corrupt_generators_file("file is truncated");
+    }
+    if (file_dom_sum_by_var != task_dom_sum_by_var ||
+        file_var_by_val != task_var_by_val) {
+        exit_with_corrupt_generators_file("variable indices do not match the task");
+    }
+    for (int i = 0; i < num_generators; ++i) {
+        vector<bool> is_image(file_permutation_length, false);
+        for (int j = 0; j < file_permutation_length; ++j) {
+            int value = values[i * file_permutation_length + j];
+            if (value < 0 || value >= file_permutation_length || is_image[value]) {
+                exit_with_corrupt_generators_file(
+                    "generator " + to_string(i) + " is not a permutation");
+            }
+            is_image[value] = true;
+        }
+    }
+
+    num_vars = file_num_vars;
+    permutation_length = file_permutation_length;
+    num_identity_generators = file_num_identity_generators;
+    dom_sum_by_var = move(file_dom_sum_by_var);
+    var_by_val = move(file_var_by_val);
+    generators.reserve(num_generators);
+    for (int i = 0; i < num_generators; ++i) {
+        auto begin = values.begin() + i * permutation_length;
+        generators.emplace_back(
+            *this, vector<int>(begin, begin + permutation_length));
+    }
+    cout << "Loaded " << num_generators << " generators from "
+         << load_generators_file << endl;
+    statistics();
+    return true;
+}
+
 int Group::get_num_generators() const {
     return generators.size();
 }
@@ -168,17 +389,21 @@ vector<int> Group::get_canonical_representative(const GlobalState &state) const
     for (size_t i = 0; i < g_variable_domain.size(); ++i) {
         canonical_state[i] = state[i];
     }
+    compute_canonical_representative(canonical_state);
+    return canonical_state;
+}
 
+void Group::compute_canonical_representative(vector<int> &state) const {
+    assert(has_symmetries());
     bool changed = true;
     while (changed) {
         changed = false;
         for (int i=0; i < get_num_generators(); i++) {
-            if (generators[i].replace_if_less(canonical_state)) {
+            if (generators[i].replace_if_less(state)) {
                 changed =  true;
             }
         }
     }
-    return canonical_state;
 }
 
 vector<int> Group::compute_permutation_trace_to_canonical_representative(const GlobalState &state) const {
@@ -284,9 +509,27 @@ static shared_ptr<Group> _parse(OptionParser &parser) {
     parser.add_option<bool>("dump_symmetry_graph",
                            "Dump symmetry graph in dot format",
                            "false");
+    vector<string> symmetry_graph_formats;
+    symmetry_graph_formats.push_back("TEXT");
+    symmetry_graph_formats.push_back("CSR");
+    parser.add_enum_option("symmetry_graph_format",
+                           symmetry_graph_formats,
+                           "Format used by dump_symmetry_graph: TEXT writes "
+                           "one line of comma-separated successors per vertex "
+                           "to symmetry-graph.txt, CSR writes vertex colors and "
+                           "the adjacency lists in compressed sparse row form "
+                           "to the binary file symmetry-graph.bin",
+                           "TEXT");
+    parser.add_option<bool>("write_symmetry_graph_image",
+                            "Write the bolded 128x128 grayscale image of the "
+                            "symmetry graph used for planner selection to "
+                            "graph-gs-L-bolded-cs.png",
+                            "false");
     parser.add_option<bool>("stop_after_symmetry_graph_creation",
                             "Stop after computing the symmetry graph. Useful "
-                            "if only that graph should be written.",
+                            "if only that graph should be written. If "
+                            "save_generators is set, Bliss still runs and the "
+                            "generators are saved before stopping.",
                             "false");
 
     // Type of search symmetries to be used
@@ -305,6 +548,16 @@ static shared_ptr<Group> _parse(OptionParser &parser) {
     parser.add_option<bool>("dump_permutations",
                            "Dump the generators",
                            "false");
+    parser.add_option<string>("save_generators",
+                              "Write the generators found by Bliss, together "
+                              "with the task hash, to the given file.",
+                              OptionParser::NONE);
+    parser.add_option<string>("load_generators",
+                              "Read the generators from the given file written "
+                              "by save_generators instead of computing them. "
+                              "If the file does not exist or belongs to a "
+                              "different task, compute them as usual.",
+                              OptionParser::NONE);
 
     Options opts = parser.parse();
 
@@ -2,6 +2,7 @@
 #define STRUCTURAL_SYMMETRIES_GROUP_H
 
 #include <memory>
+#include <string>
 #include <vector>
 
 class GlobalState;
@@ -19,6 +20,11 @@ enum class SearchSymmetries {
     DKS
 };
 
+enum class SymmetryGraphFormat {
+    TEXT,
+    CSR
+};
+
 // Permutation of bliss graph vertices.
 using RawPermutation = std::vector<int>;
 
@@ -27,9 +33,14 @@ class Group {
     const bool stabilize_initial_state;
     const int time_bound;
     const bool dump_symmetry_graph;
+    const SymmetryGraphFormat symmetry_graph_format;
+    const bool write_symmetry_graph_image;
     const bool stop_after_symmetry_graph_creation;
     const SearchSymmetries search_symmetries;
     const bool dump_permutations;
+    // Files for storing and reusing generators across planner runs
+    const std::string save_generators_file;
+    const std::string load_generators_file;
 
     // Group properties
     int num_vars;
@@ -42,6 +53,9 @@ class Group {
     bool initialized;
     std::vector<Permutation> generators;
     const Permutation &get_permutation(int index) const;
+    void exit_with_corrupt_generators_file(const std::string &reason) const;
+    bool load_generators(const TaskProxy &task_proxy);
+    void save_generators(const TaskProxy &task_proxy) const;
 
     // Path tracing
     std::vector<int> compute_permutation_trace_to_canonical_representative(const GlobalState& state) const;
@@ -97,6 +111,8 @@ public:
 
     // Used for OSS
     std::vector<int> get_canonical_representative(const GlobalState &state) const;
+    // Replace the given state values by their canonical representative.
+    void compute_canonical_representative(std::vector<int> &state) const;
     // Following methods: used for path tracing (OSS and DKS)
     RawPermutation new_identity_raw_permutation() const;
     RawPermutation compose_permutations(
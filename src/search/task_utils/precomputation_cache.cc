@@ -0,0 +1,96 @@
+#include "precomputation_cache.h"
+
+#include "task_properties.h"
+
+#include "../utils/hash.h"
+#include "../utils/memory.h"
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using search_checkpoint::CheckpointReader;
+using search_checkpoint::CheckpointWriter;
+
+namespace precomputation_cache {
+static const uint32_t CACHE_MAGIC = 0x46445043;
+static const uint32_t CACHE_VERSION = 2;
+
+static string cache_directory;
+
+void use_directory(const string &directory) {
+    cache_directory = directory;
+}
+
+bool is_enabled() {
+    return !cache_directory.empty();
+}
+
+static string get_entry_path(
+    const string &kind, uint64_t task_hash, const string &config) {
+    utils::HashState hash_state;
+    utils::feed(hash_state, task_hash);
+    for (char c : config) {
+        utils::feed(hash_state, static_cast<int>(c));
+    }
+    ostringstream path;
+    path << cache_directory << "/" << kind << "-" << hex << setw(16)
+         << setfill('0') << hash_state.get_hash64() << ".cache";
+    return path.str();
+}
+
+unique_ptr<CheckpointReader> open_entry(
+    const string &kind, const TaskProxy &task_proxy, const string &config) {
+    if (!is_enabled())
+        return nullptr;
+    uint64_t task_hash = task_properties::compute_task_hash(task_proxy);
+    string path = get_entry_path(kind, task_hash, config);
+    if (!search_checkpoint::checkpoint_exists(path))
+        return nullptr;
+
+    unique_ptr<CheckpointReader> reader =
+        utils::make_unique_ptr<CheckpointReader>(path);
+    /*
+      Entries are written atomically, but the file may still be damaged
+      later. Such entries are computed again and overwritten.
+    */
+    if (!reader->verify_checksum()) {
+        cout << "Warning: ignoring truncated or corrupt cache entry "
+             << path << "." << endl;
+        return nullptr;
+    }
+    if (reader->read_value<uint32_t>() != CACHE_MAGIC ||
+        reader->read_value<uint32_t>() != CACHE_VERSION ||
+        reader->read_value<uint64_t>() != task_hash) {
+        cout << "Ignoring cache entry " << path << " of a different task or "
+             << "planner version." << endl;
+        return nullptr;
+    }
+    vector<char> entry_config = reader->read_vector<char>();
+    if (string(entry_config.begin(), entry_config.end()) != config) {
+        cout << "Ignoring cache entry " << path << " of a different "
+             << "configuration." << endl;
+        return nullptr;
+    }
+    cout << "Reading cache entry " << path << endl;
+    return reader;
+}
+
+unique_ptr<CheckpointWriter> create_entry(
+    const string &kind, const TaskProxy &task_proxy, const string &config) {
+    if (!is_enabled())
+        return nullptr;
+    uint64_t task_hash = task_properties::compute_task_hash(task_proxy);
+    string path = get_entry_path(kind, task_hash, config);
+    cout << "Writing cache entry " << path << endl;
+    unique_ptr<CheckpointWriter> writer =
+        utils::make_unique_ptr<CheckpointWriter>(path, true);
+    writer->write_value(CACHE_MAGIC);
+    writer->write_value(CACHE_VERSION);
+    writer->write_value(task_hash);
+    writer->write_vector(vector<char>(config.begin(), config.end()));
+    return writer;
+}
+}
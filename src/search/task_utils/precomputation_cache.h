@@ -0,0 +1,51 @@
+#ifndef TASK_UTILS_PRECOMPUTATION_CACHE_H
+#define TASK_UTILS_PRECOMPUTATION_CACHE_H
+
+#include "../search_engines/search_checkpoint.h"
+
+#include <memory>
+#include <string>
+
+class TaskProxy;
+
+/*
+  Directory of precomputed heuristic data (PDBs, merge-and-shrink and
+  Cartesian abstractions) that can be reused by later planner runs on
+  the same task, e.g. by the other configurations of a portfolio. The
+  cache is disabled unless --precomputation-cache DIRECTORY is given.
+
+  An entry is identified by the kind of data (e.g. "pdb"), the task (see
+  task_properties::compute_task_hash) and the configuration string of the
+  heuristic. Entries are written and read with the checkpoint classes, so
+  they are written atomically and mapped into memory when read. Each entry
+  starts with a header that repeats the task hash and the configuration,
+  followed by the data of the heuristic and a checksum. Truncated or
+  corrupt entries are ignored.
+
+  Caching assumes that the configuration determines the result, which
+  is not the case for configurations that depend on a time limit or on
+  a random seed of -1.
+*/
+namespace precomputation_cache {
+extern void use_directory(const std::string &directory);
+extern bool is_enabled();
+
+/*
+  Return a reader positioned after the header of the given entry, or
+  nullptr if the cache is disabled or does not contain the entry.
+*/
+extern std::unique_ptr<search_checkpoint::CheckpointReader> open_entry(
+    const std::string &kind, const TaskProxy &task_proxy,
+    const std::string &config);
+
+/*
+  Return a writer for the given entry whose header has already been
+  written, or nullptr if the cache is disabled. The entry only becomes
+  visible when the caller commits the writer.
+*/
+extern std::unique_ptr<search_checkpoint::CheckpointWriter> create_entry(
+    const std::string &kind, const TaskProxy &task_proxy,
+    const std::string &config);
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "task_properties.h"
 
+#include "../utils/hash.h"
 #include "../utils/system.h"
 
 #include <algorithm>
@@ -82,4 +83,43 @@ int get_min_operator_cost(TaskProxy task_proxy) {
     }
     return min_cost;
 }
+
+int get_max_operator_cost(TaskProxy task_proxy) {
+    int max_cost = 0;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        max_cost = max(max_cost, op.get_cost());
+    }
+    return max_cost;
+}
+
+template<class OperatorProxyCollection>
+static void feed_operators(
+    utils::HashState &hash_state, const OperatorProxyCollection &ops) {
+    utils::feed(hash_state, static_cast<int>(ops.size()));
+    for (OperatorProxy op : ops) {
+        utils::feed(hash_state, op.get_cost());
+        utils::feed(hash_state, get_fact_pairs(op.get_preconditions()));
+        EffectsProxy effects = op.get_effects();
+        utils::feed(hash_state, static_cast<int>(effects.size()));
+        for (EffectProxy effect : effects) {
+            utils::feed(hash_state, get_fact_pairs(effect.get_conditions()));
+            utils::feed(hash_state, effect.get_fact().get_pair());
+        }
+    }
+}
+
+uint64_t compute_task_hash(const TaskProxy &task_proxy) {
+    utils::HashState hash_state;
+    VariablesProxy variables = task_proxy.get_variables();
+    utils::feed(hash_state, static_cast<int>(variables.size()));
+    for (VariableProxy var : variables) {
+        utils::feed(hash_state, var.get_domain_size());
+        utils::feed(hash_state, var.is_derived() ? var.get_axiom_layer() : -1);
+    }
+    feed_operators(hash_state, task_proxy.get_operators());
+    feed_operators(hash_state, task_proxy.get_axioms());
+    utils::feed(hash_state, task_proxy.get_initial_state().get_values());
+    utils::feed(hash_state, get_fact_pairs(task_proxy.get_goals()));
+    return hash_state.get_hash64();
+}
 }
@@ -3,6 +3,8 @@
 
 #include "../task_proxy.h"
 
+#include <cstdint>
+
 namespace task_properties {
 inline bool is_applicable(OperatorProxy op, const State &state) {
     for (FactProxy precondition : op.get_preconditions()) {
@@ -49,6 +51,16 @@ extern void verify_no_conditional_effects(TaskProxy task);
 extern std::vector<int> get_operator_costs(const TaskProxy &task_proxy);
 extern double get_average_operator_cost(TaskProxy task_proxy);
 extern int get_min_operator_cost(TaskProxy task_proxy);
+extern int get_max_operator_cost(TaskProxy task_proxy);
+
+/*
+  Return a hash value of the variable domains, operators, axioms, initial
+  state and goal of the task. Used to check that data written to disk
+  belongs to the task at hand.
+
+  Runtime: O(n), where n is the size of the task.
+*/
+extern std::uint64_t compute_task_hash(const TaskProxy &task_proxy);
 
 template<class FactProxyCollection>
 std::vector<FactPair> get_fact_pairs(const FactProxyCollection &facts) {
@@ -0,0 +1,45 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace utils {
+int get_num_threads(int num_threads) {
+    if (num_threads == 0) {
+        return static_cast<int>(max(1u, thread::hardware_concurrency()));
+    }
+    return num_threads;
+}
+
+void run_in_parallel(
+    int num_threads, int num_tasks, const function<void(int)> &task) {
+    num_threads = min(get_num_threads(num_threads), num_tasks);
+    if (num_threads <= 1) {
+        for (int i = 0; i < num_tasks; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    atomic<int> next_task(0);
+    auto work = [&]() {
+        for (int i = next_task++; i < num_tasks; i = next_task++) {
+            task(i);
+        }
+    };
+    vector<thread> threads;
+    threads.reserve(num_threads - 1);
+    for (int i = 0; i < num_threads - 1; ++i) {
+        threads.emplace_back(work);
+    }
+    // The calling thread is one of the workers.
+    work();
+    for (thread &thread : threads) {
+        thread.join();
+    }
+}
+}
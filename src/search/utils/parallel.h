@@ -0,0 +1,31 @@
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include <functional>
+
+namespace utils {
+/*
+  Return the number of worker threads to use for the given "num_threads"
+  option value: 0 means one thread per hardware thread.
+*/
+extern int get_num_threads(int num_threads);
+
+/*
+  Call task(i) for all i in [0, num_tasks) using a pool of num_threads
+  threads (see get_num_threads for the meaning of 0). Tasks are handed
+  out in increasing order, but may finish in any order. The call returns
+  after all tasks have finished.
+
+  The tasks must not throw exceptions and must only write to data that no
+  other task accesses. Results should be stored in per-task slots and
+  combined by the caller afterwards, which keeps the outcome independent
+  of the number of threads and of the scheduling.
+
+  With a single thread or at most one task, all tasks run in the calling
+  thread.
+*/
+extern void run_in_parallel(
+    int num_threads, int num_tasks, const std::function<void(int)> &task);
+}
+
+#endif
@@ -45,6 +45,13 @@ enum class ExitCode {
 NO_RETURN extern void exit_with(ExitCode returncode);
 
 int get_peak_memory_in_kb();
+int get_resident_memory_in_kb();
+/*
+  Number of page faults of the process that did not (minor) or did (major)
+  require reading from disk. Returns -1 if this is not supported.
+*/
+long get_minor_page_faults();
+long get_major_page_faults();
 const char *get_exit_code_message_reentrant(ExitCode exitcode);
 bool is_exit_code_error_reentrant(ExitCode exitcode);
 void register_event_handlers();